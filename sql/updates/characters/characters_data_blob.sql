@@ -0,0 +1,6 @@
+-- `data` of characters and item_instance is written as binary blob
+-- (header + little-endian uint32 per update field). Existing text rows are
+-- kept as they are, the server still reads them and rewrites each row in the
+-- new format on its next save.
+ALTER TABLE `characters` MODIFY `data` longblob;
+ALTER TABLE `item_instance` MODIFY `data` longblob;
@@ -52,6 +52,8 @@ class Grid
     template<class A, class T, class O> friend class GridLoader;
     public:
 
+        Grid() : i_version(0) {}
+
         /** destructor to clean up its resources. This includes unloading the
         grid if it has not been unload.
         */
@@ -63,6 +65,7 @@ class Grid
         {
             if(!i_objects.template insert<SPECIFIC_OBJECT>(obj))
                 ASSERT(false);
+            ++i_version;
         }
 
         /** an object of interested exits the grid
@@ -71,6 +74,7 @@ class Grid
         {
             if(!i_objects.template remove<SPECIFIC_OBJECT>(obj))
                 ASSERT(false);
+            ++i_version;
         }
 
         /** Refreshes/update the grid. This required for remote grids.
@@ -103,12 +107,17 @@ class Grid
          */
         unsigned int ActiveObjectsInGrid(void) const { return /*m_activeGridObjects.size()+*/i_objects.template Count<ACTIVE_OBJECT>(); }
 
+        /** Changes every time an object enters or exits the grid.
+         */
+        uint32 GetVersion(void) const { return i_version; }
+
         /** Inserts a container type object into the grid.
          */
         template<class SPECIFIC_OBJECT> void AddGridObject(SPECIFIC_OBJECT *obj)
         {
             if(!i_container.template insert<SPECIFIC_OBJECT>(obj))
                 ASSERT(false);
+            ++i_version;
         }
 
         /** Removes a container type object from the grid
@@ -117,12 +126,14 @@ class Grid
         {
             if(!i_container.template remove<SPECIFIC_OBJECT>(obj))
                 ASSERT(false);
+            ++i_version;
         }
 
     private:
 
         TypeMapContainer<GRID_OBJECT_TYPES> i_container;
         TypeMapContainer<WORLD_OBJECT_TYPES> i_objects;
+        uint32 i_version;
         //typedef std::set<void*> ActiveGridObjects;
         //ActiveGridObjects m_activeGridObjects;
 };
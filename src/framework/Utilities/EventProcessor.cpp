@@ -20,15 +20,135 @@
 
 #include "EventProcessor.h"
 
-EventProcessor::EventProcessor()
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define EVENT_WHEEL_MASK        (EVENT_WHEEL_SLOTS - 1)
+#define EVENT_WHEEL_MAX_DELTA   ((uint64(1) << (EVENT_WHEEL_LEVELS * EVENT_WHEEL_SLOT_BITS)) - 1)
+#define EVENT_NOT_IN_WHEEL      EVENT_WHEEL_LEVELS          // m_wheelLevel of events in m_firing and local lists
+
+static uint32 CountTrailingZeros(uint32 bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(bits);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return index;
+#else
+    uint32 index = 0;
+    while (!(bits & 1))
+    {
+        bits >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+EventProcessor::EventProcessor() : m_slots(NULL), m_firing(NULL), m_tick(1), m_count(0)
 {
     m_time = 0;
     m_aborting = false;
+
+    for (uint32 level = 0; level < EVENT_WHEEL_LEVELS; ++level)
+        m_occupied[level] = 0;
 }
 
 EventProcessor::~EventProcessor()
 {
     KillAllEvents(true);
+    delete [] m_slots;
+}
+
+void EventProcessor::Link(BasicEvent*& head, BasicEvent* Event, uint8 level, uint8 slot)
+{
+    Event->m_nextEvent = head;
+    if (head)
+        head->m_prevNext = &Event->m_nextEvent;
+
+    head = Event;
+    Event->m_prevNext = &head;
+    Event->m_wheelLevel = level;
+    Event->m_wheelSlot = slot;
+}
+
+void EventProcessor::Unlink(BasicEvent* Event)
+{
+    *Event->m_prevNext = Event->m_nextEvent;
+    if (Event->m_nextEvent)
+        Event->m_nextEvent->m_prevNext = Event->m_prevNext;
+
+    if (Event->m_wheelLevel < EVENT_WHEEL_LEVELS && !m_slots[Event->m_wheelLevel][Event->m_wheelSlot])
+        m_occupied[Event->m_wheelLevel] &= ~(1u << Event->m_wheelSlot);
+
+    Event->m_nextEvent = NULL;
+    Event->m_prevNext = NULL;
+}
+
+void EventProcessor::Insert(BasicEvent* Event)
+{
+    // already passed, goes with the next processed millisecond
+    uint64 expires = Event->m_execTime < m_tick ? m_tick : Event->m_execTime;
+    uint64 delta = expires - m_tick;
+    if (delta > EVENT_WHEEL_MAX_DELTA)
+    {
+        // comes out early and is inserted again
+        delta = EVENT_WHEEL_MAX_DELTA;
+        expires = m_tick + delta;
+    }
+
+    uint32 level = 0;
+    while (level + 1 < EVENT_WHEEL_LEVELS && delta >= (uint64(1) << ((level + 1) * EVENT_WHEEL_SLOT_BITS)))
+        ++level;
+
+    uint32 slot = uint32(expires >> (level * EVENT_WHEEL_SLOT_BITS)) & EVENT_WHEEL_MASK;
+    Link(m_slots[level][slot], Event, level, slot);
+    m_occupied[level] |= 1u << slot;
+}
+
+uint32 EventProcessor::Cascade(uint32 level)
+{
+    uint32 slot = uint32(m_tick >> (level * EVENT_WHEEL_SLOT_BITS)) & EVENT_WHEEL_MASK;
+
+    // reverse to oldest first, so lower slots stay newest first after inserting
+    BasicEvent* pending = NULL;
+    while (BasicEvent* Event = m_slots[level][slot])
+    {
+        Unlink(Event);
+        Link(pending, Event, EVENT_NOT_IN_WHEEL, 0);
+    }
+
+    while (BasicEvent* Event = pending)
+    {
+        Unlink(Event);
+        Insert(Event);
+    }
+
+    return slot;
+}
+
+void EventProcessor::DetachAll(BasicEvent*& list)
+{
+    while (BasicEvent* Event = m_firing)
+    {
+        Unlink(Event);
+        Link(list, Event, EVENT_NOT_IN_WHEEL, 0);
+    }
+
+    for (uint32 level = 0; level < EVENT_WHEEL_LEVELS; ++level)
+    {
+        while (m_occupied[level])
+        {
+            uint32 slot = CountTrailingZeros(m_occupied[level]);
+            while (BasicEvent* Event = m_slots[level][slot])
+            {
+                Unlink(Event);
+                Link(list, Event, EVENT_NOT_IN_WHEEL, 0);
+            }
+        }
+    }
 }
 
 uint32 EventProcessor::Update(uint32 p_time)
@@ -37,28 +157,68 @@ uint32 EventProcessor::Update(uint32 p_time)
     // update time
     m_time += p_time;
 
+    // nothing can cascade or fire
+    if (!m_count)
+    {
+        m_tick = m_time + 1;
+        return 0;
+    }
+
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (m_tick <= m_time)
     {
-        count++;
-        // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        uint32 index = uint32(m_tick) & EVENT_WHEEL_MASK;
+        if (!index)
+        {
+            for (uint32 level = 1; level < EVENT_WHEEL_LEVELS; ++level)
+                if (Cascade(level))
+                    break;
+        }
 
-        if (!Event->to_Abort)
+        // events added for now during execution land in the same slot again
+        while (m_slots[0][index])
         {
-            if (Event->Execute(m_time, p_time))
+            while (BasicEvent* Event = m_slots[0][index])
             {
-                // completely destroy event if it is not re-added
-                delete Event;
+                Unlink(Event);
+                Link(m_firing, Event, EVENT_NOT_IN_WHEEL, 0);
+            }
+
+            while (BasicEvent* Event = m_firing)
+            {
+                // get and remove event from queue
+                Unlink(Event);
+
+                // waited in last slot of the wheel
+                if (Event->m_execTime > m_tick)
+                {
+                    Insert(Event);
+                    continue;
+                }
+
+                count++;
+                --m_count;
+
+                if (!Event->to_Abort)
+                {
+                    if (Event->Execute(m_time, p_time))
+                    {
+                        // completely destroy event if it is not re-added
+                        delete Event;
+                    }
+                }
+                else
+                {
+                    Event->Abort(m_time);
+                    delete Event;
+                }
             }
         }
-        else
-        {
-            Event->Abort(m_time);
-            delete Event;
-        }
+
+        // skip to next occupied slot, or to the wrap of level 0 where upper level cascades
+        uint32 above = m_occupied[0] & ~((2u << index) - 1);
+        uint64 next = m_tick - index + (above ? CountTrailingZeros(above) : EVENT_WHEEL_SLOTS);
+        m_tick = next <= m_time ? next : m_time + 1;
     }
     return count;
 }
@@ -68,36 +228,79 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
-    // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    do
     {
-        EventList::iterator i_old = i;
-        ++i;
+        // Abort() may add new events, take the current ones out first
+        BasicEvent* pending = NULL;
+        DetachAll(pending);
 
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if(force || i_old->second->IsDeletable())
+        while (BasicEvent* Event = pending)
         {
-            delete i_old->second;
+            Unlink(Event);
 
-            if(!force)                                      // need per-element cleanup
-                m_events.erase (i_old);
+            Event->to_Abort = true;
+            Event->Abort(m_time);
+            if (force || Event->IsDeletable())
+            {
+                --m_count;
+                delete Event;
+            }
+            else
+                Insert(Event);                              // gets Abort again and deleted when due
         }
     }
-
-    // fast clear event list (in force case)
-    if(force)
-        m_events.clear();
+    while (force && m_count);
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
 {
+    if (!m_slots)
+    {
+        m_slots = new BasicEvent*[EVENT_WHEEL_LEVELS][EVENT_WHEEL_SLOTS];
+        for (uint32 level = 0; level < EVENT_WHEEL_LEVELS; ++level)
+            for (uint32 slot = 0; slot < EVENT_WHEEL_SLOTS; ++slot)
+                m_slots[level][slot] = NULL;
+    }
+
     if (set_addtime)
     {
         e_time += m_time;
     }
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    Insert(Event);
+    ++m_count;
+}
+
+void EventProcessor::CancelEvent(BasicEvent* Event)
+{
+    Event->to_Abort = true;
+
+    // currently executing, deleted by Update()
+    if (!Event->m_prevNext)
+        return;
+
+    Unlink(Event);
+    --m_count;
+
+    Event->Abort(m_time);
+    delete Event;
 }
 
+bool EventProcessor::HasEventOfType(BasicEvent* type)
+{
+    for (BasicEvent* Event = m_firing; Event; Event = Event->m_nextEvent)
+        if (typeid(*Event) == typeid(*type))
+            return true;
+
+    for (uint32 level = 0; level < EVENT_WHEEL_LEVELS; ++level)
+    {
+        for (uint32 occupied = m_occupied[level]; occupied; occupied &= occupied - 1)
+        {
+            for (BasicEvent* Event = m_slots[level][CountTrailingZeros(occupied)]; Event; Event = Event->m_nextEvent)
+                if (typeid(*Event) == typeid(*type))
+                    return true;
+        }
+    }
 
+    return false;
+}
@@ -23,15 +23,18 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <ace/TSS_T.h>
+
 #include <typeinfo>
-#include <algorithm>
+#include <new>
 // Note. All times are in milliseconds here.
 
 class BasicEvent
 {
+    friend class EventProcessor;
+
     public:
-        BasicEvent() { to_Abort = false; }
+        BasicEvent() : m_execTime(0), m_nextEvent(NULL), m_prevNext(NULL), m_wheelLevel(0), m_wheelSlot(0) { to_Abort = false; }
         virtual ~BasicEvent()                               // override destructor to perform some actions on event removal
         {
         };
@@ -50,10 +53,91 @@ class BasicEvent
 
         // these can be used for time offset control
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
+
+    private:
+        // intrusive link in EventProcessor, m_prevNext points to whatever points to us
+        BasicEvent* m_nextEvent;
+        BasicEvent** m_prevNext;
+        uint8 m_wheelLevel;
+        uint8 m_wheelSlot;
+};
+
+// blocks of one event class kept for reuse by the thread that freed them
+struct EventFreeList
+{
+    EventFreeList() : head(NULL), count(0) {}
+    ~EventFreeList()
+    {
+        while (head)
+        {
+            void* next = *(void**)head;
+            ::operator delete(head);
+            head = next;
+        }
+    }
+
+    void* head;
+    uint32 count;
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+#define EVENT_FREE_LIST_MAX 1024                            // per thread and event class
 
+// base for events created at high rate, allocation is served from per thread free list
+template<class T>
+class PooledEvent : public BasicEvent
+{
+    public:
+        static void* operator new(size_t size)
+        {
+            EventFreeList* pool = s_pool;
+            if (size == sizeof(T) && pool->head)
+            {
+                void* block = pool->head;
+                pool->head = *(void**)block;
+                --pool->count;
+                return block;
+            }
+
+            return ::operator new(size);
+        }
+
+        static void operator delete(void* ptr, size_t size)
+        {
+            EventFreeList* pool = s_pool;
+            if (size == sizeof(T) && pool->count < EVENT_FREE_LIST_MAX)
+            {
+                *(void**)ptr = pool->head;
+                pool->head = ptr;
+                ++pool->count;
+                return;
+            }
+
+            ::operator delete(ptr);
+        }
+
+    private:
+        static ACE_TSS<EventFreeList> s_pool;
+};
+
+template<class T>
+ACE_TSS<EventFreeList> PooledEvent<T>::s_pool;
+
+#define EVENT_WHEEL_SLOT_BITS   5
+#define EVENT_WHEEL_SLOTS       (1 << EVENT_WHEEL_SLOT_BITS)
+#define EVENT_WHEEL_LEVELS      4                           // 1 ms, 32 ms, 1 s, 33 s per slot
+
+/**
+ * Hierarchical timing wheel of events.
+ *
+ * Events are linked into slots by their execution time, level 0 covers the
+ * next 32 milliseconds, every next level 32 times more, about 17 minutes in
+ * total. Further events wait in last slot and are put back when they come
+ * out early. Update() jumps between occupied slots and moves a slot of the
+ * upper level down when level 0 wraps, so its cost depends on number of due
+ * events, not on all scheduled ones. Events run in order of execution time,
+ * but two due at the same millisecond may swap. The slots are allocated on
+ * first AddEvent(), an unused processor only holds the occupancy bits.
+ */
 class EventProcessor
 {
     public:
@@ -63,16 +147,32 @@ class EventProcessor
         uint32 Update(uint32 p_time);
         void KillAllEvents(bool force);
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
+        // removes scheduled event at once, it gets Abort call and is deleted
+        void CancelEvent(BasicEvent* Event);
 
-        bool HasEventOfType(BasicEvent* type)
-        {
-            return std::any_of(m_events.begin(), m_events.end(), [&type](std::pair<uint64, BasicEvent*> i) { return typeid(*i.second) == typeid(*type); });
-        };
+        bool HasEventOfType(BasicEvent* type);
 
     protected:
         uint64 m_time;
-        EventList m_events;
         bool m_aborting;
+
+    private:
+        EventProcessor(const EventProcessor&);
+        EventProcessor& operator=(const EventProcessor&);
+
+        void Insert(BasicEvent* Event);
+        void Link(BasicEvent*& head, BasicEvent* Event, uint8 level, uint8 slot);
+        void Unlink(BasicEvent* Event);
+        uint32 Cascade(uint32 level);
+        // moves all events to list, newest first
+        void DetachAll(BasicEvent*& list);
+
+        // newest first, allocated with the first event, most units never get one
+        BasicEvent* (*m_slots)[EVENT_WHEEL_SLOTS];
+        uint32 m_occupied[EVENT_WHEEL_LEVELS];              // bit per non-empty slot
+        BasicEvent* m_firing;                               // rest of the slot being executed, oldest first
+        uint64 m_tick;                                      // next millisecond to process
+        uint32 m_count;
 };
 
 #endif
@@ -33,22 +33,156 @@
 #include "Chat.h"
 #include "CreatureAIImpl.h"
 
-bool CreatureEventAIHolder::UpdateRepeatTimer(Creature* creature, uint32 repeatMin, uint32 repeatMax)
+bool CreatureEventAI::UpdateRepeatTimer(CreatureEventAIHolder& holder, uint32 repeatMin, uint32 repeatMax)
 {
     if (repeatMin == repeatMax)
-        Time = repeatMin;
+        SetEventTimer(holder, repeatMin);
     else if (repeatMax > repeatMin)
-        Time = urand(repeatMin, repeatMax);
+        SetEventTimer(holder, urand(repeatMin, repeatMax));
     else
     {
-        sLog.outLog(LOG_DB_ERR, "CreatureEventAI: Creature %u using Event %u (Type = %u) has RandomMax < RandomMin. Event repeating disabled.", creature->GetEntry(), Event.event_id, Event.event_type);
-        Enabled = false;
+        sLog.outLog(LOG_DB_ERR, "CreatureEventAI: Creature %u using Event %u (Type = %u) has RandomMax < RandomMin. Event repeating disabled.", m_creature->GetEntry(), holder.Event.event_id, holder.Event.event_type);
+        holder.Enabled = false;
         return false;
     }
 
     return true;
 }
 
+void CreatureEventAI::SetEventTimer(CreatureEventAIHolder& holder, uint32 time)
+{
+    holder.Time = time;
+    holder.Due = 0;
+
+    uint32 index = &holder - &CreatureEventAIList[0];
+    if (!time)
+    {
+        ArmEvent(index);
+        return;
+    }
+
+    if (IsPhaseBlocked(holder))
+    {
+        FreezeEventTimer(index);
+        return;
+    }
+
+    holder.Due = EventClock + time;
+    EventTimers.push(EventTimer(holder.Due, index));
+}
+
+void CreatureEventAI::UpdateEventTimers(uint32 diff)
+{
+    EventClock += diff;
+
+    // timers running out are cleared even if event can't trigger in current phase
+    for (uint32 i = 0; i < FrozenEvents.size();)
+    {
+        CreatureEventAIHolder& holder = CreatureEventAIList[FrozenEvents[i]];
+        if (!holder.Due && holder.Time > diff)
+        {
+            ++i;
+            continue;
+        }
+
+        if (!holder.Due)
+        {
+            holder.Time = 0;
+            ArmEvent(FrozenEvents[i]);
+        }
+
+        holder.Frozen = false;
+        FrozenEvents[i] = FrozenEvents.back();
+        FrozenEvents.pop_back();
+    }
+
+    while (!EventTimers.empty() && EventTimers.top().first <= EventClock)
+    {
+        EventTimer timer = EventTimers.top();
+        EventTimers.pop();
+
+        // timer was set again or frozen meanwhile
+        CreatureEventAIHolder& holder = CreatureEventAIList[timer.second];
+        if (holder.Due != timer.first)
+            continue;
+
+        holder.Due = 0;
+        holder.Time = 0;
+        ArmEvent(timer.second);
+    }
+}
+
+void CreatureEventAI::SetPhase(uint8 phase)
+{
+    Phase = phase;
+
+    for (uint32 i = 0; i < CreatureEventAIList.size(); ++i)
+    {
+        CreatureEventAIHolder& holder = CreatureEventAIList[i];
+        if (!holder.Time)
+            continue;
+
+        bool blocked = IsPhaseBlocked(holder);
+        if (holder.Due && blocked)
+        {
+            holder.Time = GetEventTimeLeft(holder);
+            holder.Due = 0;
+            FreezeEventTimer(i);
+        }
+        else if (!holder.Due && !blocked)
+        {
+            holder.Due = EventClock + holder.Time;
+            EventTimers.push(EventTimer(holder.Due, i));
+        }
+    }
+}
+
+void CreatureEventAI::FreezeEventTimer(uint32 index)
+{
+    CreatureEventAIHolder& holder = CreatureEventAIList[index];
+    if (holder.Frozen)
+        return;
+
+    holder.Frozen = true;
+    FrozenEvents.push_back(index);
+}
+
+bool CreatureEventAI::IsPolledEvent(uint32 type)
+{
+    switch (type)
+    {
+        case EVENT_T_TIMER_OOC:
+        case EVENT_T_TIMER:
+        case EVENT_T_MANA:
+        case EVENT_T_HP:
+        case EVENT_T_TARGET_HP:
+        case EVENT_T_TARGET_CASTING:
+        case EVENT_T_FRIENDLY_HP:
+        case EVENT_T_RANGE:
+            return true;
+    }
+
+    return false;
+}
+
+// polled event has no time left, UpdateAI checks it until it gets a timer or is disabled
+void CreatureEventAI::ArmEvent(uint32 index)
+{
+    CreatureEventAIHolder& holder = CreatureEventAIList[index];
+    if (holder.Armed || !IsPolledEvent(holder.Event.event_type))
+        return;
+
+    holder.Armed = true;
+    ArmedEvents.push_back(index);
+}
+
+void CreatureEventAI::ProcessEvents(EventAI_Type type, Unit* pActionInvoker)
+{
+    std::vector<uint32> const& events = EventsByType[type];
+    for (uint32 i = 0; i < events.size(); ++i)
+        ProcessEvent(CreatureEventAIList[events[i]], pActionInvoker);
+}
+
 int CreatureEventAI::Permissible(const Creature *creature)
 {
     if (creature->GetAIName() == "EventAI")
@@ -117,6 +251,7 @@ CreatureEventAI::CreatureEventAI(Creature *c) : CreatureAI(c)
 
     bEmptyList = CreatureEventAIList.empty();
     Phase = 0;
+    EventClock = 0;
     CombatMovementEnabled = true;
     AllowConditionalMovement = false;
     MeleeEnabled = true;
@@ -143,11 +278,21 @@ CreatureEventAI::CreatureEventAI(Creature *c) : CreatureAI(c)
 
     CreatureEventAIList.push_back(CreatureEventAIHolder(cevent));
 
+    for (uint32 i = 0; i < CreatureEventAIList.size(); ++i)
+    {
+        uint32 type = CreatureEventAIList[i].Event.event_type;
+        if (type < EVENT_T_END)
+            EventsByType[type].push_back(i);
+
+        // no timer is set yet
+        ArmEvent(i);
+    }
+
     //Handle Spawned Events
     // and check for conditional movement
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+        for (CreatureEventAIHolderList::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
         {
             if (SpawnedEventConditionsCheck((*i).Event))
                 ProcessEvent(*i);
@@ -178,14 +323,14 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.timer.repeatMin,event.timer.repeatMax);
+            UpdateRepeatTimer(pHolder, event.timer.repeatMin,event.timer.repeatMax);
             break;
         case EVENT_T_TIMER_OOC:
             if (m_creature->IsInCombat())
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.timer.repeatMin,event.timer.repeatMax);
+            UpdateRepeatTimer(pHolder, event.timer.repeatMin,event.timer.repeatMax);
             break;
         case EVENT_T_HP:
         {
@@ -198,7 +343,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.percent_range.repeatMin,event.percent_range.repeatMax);
+            UpdateRepeatTimer(pHolder, event.percent_range.repeatMin,event.percent_range.repeatMax);
             break;
         }
         case EVENT_T_MANA:
@@ -212,14 +357,14 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.percent_range.repeatMin,event.percent_range.repeatMax);
+            UpdateRepeatTimer(pHolder, event.percent_range.repeatMin,event.percent_range.repeatMax);
             break;
         }
         case EVENT_T_AGGRO:
             break;
         case EVENT_T_KILL:
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.kill.repeatMin,event.kill.repeatMax);
+            UpdateRepeatTimer(pHolder, event.kill.repeatMin,event.kill.repeatMax);
             break;
         case EVENT_T_DEATH:
         case EVENT_T_EVADE:
@@ -228,15 +373,15 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
             //Spell hit is special case, param1 and param2 handled within CreatureEventAI::SpellHit
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.spell_hit.repeatMin,event.spell_hit.repeatMax);
+            UpdateRepeatTimer(pHolder, event.spell_hit.repeatMin,event.spell_hit.repeatMax);
             break;
         case EVENT_T_RANGE:
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.range.repeatMin,event.range.repeatMax);
+            UpdateRepeatTimer(pHolder, event.range.repeatMin,event.range.repeatMax);
             break;
         case EVENT_T_OOC_LOS:
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.ooc_los.repeatMin,event.ooc_los.repeatMax);
+            UpdateRepeatTimer(pHolder, event.ooc_los.repeatMin,event.ooc_los.repeatMax);
             break;
         case EVENT_T_RESET:
         case EVENT_T_SPAWNED:
@@ -252,7 +397,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.percent_range.repeatMin,event.percent_range.repeatMax);
+            UpdateRepeatTimer(pHolder, event.percent_range.repeatMin,event.percent_range.repeatMax);
             break;
         }
         case EVENT_T_TARGET_CASTING:
@@ -260,7 +405,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.target_casting.repeatMin,event.target_casting.repeatMax);
+            UpdateRepeatTimer(pHolder, event.target_casting.repeatMin,event.target_casting.repeatMax);
             break;
         case EVENT_T_FRIENDLY_HP:
         {
@@ -274,7 +419,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
             pActionInvoker = pUnit;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.friendly_hp.repeatMin,event.friendly_hp.repeatMax);
+            UpdateRepeatTimer(pHolder, event.friendly_hp.repeatMin,event.friendly_hp.repeatMax);
             break;
         }
         case EVENT_T_FRIENDLY_IS_CC:
@@ -293,7 +438,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
             pActionInvoker = *(pList.begin());
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.friendly_is_cc.repeatMin,event.friendly_is_cc.repeatMax);
+            UpdateRepeatTimer(pHolder, event.friendly_is_cc.repeatMin,event.friendly_is_cc.repeatMax);
             break;
         }
         case EVENT_T_FRIENDLY_MISSING_BUFF:
@@ -309,7 +454,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
             pActionInvoker = *(pList.begin());
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.friendly_buff.repeatMin,event.friendly_buff.repeatMax);
+            UpdateRepeatTimer(pHolder, event.friendly_buff.repeatMin,event.friendly_buff.repeatMax);
             break;
         }
         case EVENT_T_SUMMONED_UNIT:
@@ -323,7 +468,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.summon_unit.repeatMin,event.summon_unit.repeatMax);
+            UpdateRepeatTimer(pHolder, event.summon_unit.repeatMin,event.summon_unit.repeatMax);
             break;
         }
         case EVENT_T_TARGET_MANA:
@@ -337,7 +482,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.percent_range.repeatMin,event.percent_range.repeatMax);
+            UpdateRepeatTimer(pHolder, event.percent_range.repeatMin,event.percent_range.repeatMax);
             break;
         }
         case EVENT_T_REACHED_HOME:
@@ -352,7 +497,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.buffed.repeatMin,event.buffed.repeatMax);
+            UpdateRepeatTimer(pHolder, event.buffed.repeatMin,event.buffed.repeatMax);
             break;
         }
         case EVENT_T_TARGET_BUFFED:
@@ -368,7 +513,7 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
 
             //Repeat Timers
-            pHolder.UpdateRepeatTimer(m_creature,event.buffed.repeatMin,event.buffed.repeatMax);
+            UpdateRepeatTimer(pHolder, event.buffed.repeatMin,event.buffed.repeatMax);
             break;
         }
         default:
@@ -712,7 +857,7 @@ void CreatureEventAI::ProcessAction(CreatureEventAI_Action const& action, uint32
 
             break;
         case ACTION_T_SET_PHASE:
-            Phase = action.set_phase.phase;
+            SetPhase(action.set_phase.phase);
             break;
         case ACTION_T_INC_PHASE:
         {
@@ -720,15 +865,15 @@ void CreatureEventAI::ProcessAction(CreatureEventAI_Action const& action, uint32
             if (new_phase < 0)
             {
                 sLog.outLog(LOG_DB_ERR, "CreatureEventAI: Event %d decrease Phase under 0. CreatureEntry = %d", EventId, m_creature->GetEntry());
-                Phase = 0;
+                SetPhase(0);
             }
             else if (new_phase >= MAX_PHASE)
             {
                 sLog.outLog(LOG_DB_ERR, "CreatureEventAI: Event %d incremented Phase above %u. Phase mask cannot be used with phases past %u. CreatureEntry = %d", EventId, MAX_PHASE-1, MAX_PHASE-1, m_creature->GetEntry());
-                Phase = MAX_PHASE-1;
+                SetPhase(MAX_PHASE-1);
             }
             else
-                Phase = new_phase;
+                SetPhase(new_phase);
 
             break;
         }
@@ -768,11 +913,11 @@ void CreatureEventAI::ProcessAction(CreatureEventAI_Action const& action, uint32
 
             break;
         case ACTION_T_RANDOM_PHASE:
-            Phase = GetRandActionParam(rnd, action.random_phase.phase1, action.random_phase.phase2, action.random_phase.phase3);
+            SetPhase(GetRandActionParam(rnd, action.random_phase.phase1, action.random_phase.phase2, action.random_phase.phase3));
             break;
         case ACTION_T_RANDOM_PHASE_RANGE:
             if (action.random_phase_range.phaseMax > action.random_phase_range.phaseMin)
-                Phase = action.random_phase_range.phaseMin + (rnd % (action.random_phase_range.phaseMax - action.random_phase_range.phaseMin));
+                SetPhase(action.random_phase_range.phaseMin + (rnd % (action.random_phase_range.phaseMax - action.random_phase_range.phaseMin)));
             else
                 sLog.outLog(LOG_DB_ERR, "CreatureEventAI: ACTION_T_RANDOM_PHASE_RANGE cannot have Param2 <= Param1. Divide by Zero. Event = %d. CreatureEntry = %d", EventId, m_creature->GetEntry());
             break;
@@ -945,9 +1090,10 @@ void CreatureEventAI::JustRespawned()
         return;
 
     //Handle Spawned Events
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-        if (SpawnedEventConditionsCheck((*i).Event))
-            ProcessEvent(*i);
+    std::vector<uint32> const& events = EventsByType[EVENT_T_SPAWNED];
+    for (uint32 i = 0; i < events.size(); ++i)
+        if (SpawnedEventConditionsCheck(CreatureEventAIList[events[i]].Event))
+            ProcessEvent(CreatureEventAIList[events[i]]);
 }
 
 void CreatureEventAI::Reset()
@@ -958,31 +1104,15 @@ void CreatureEventAI::Reset()
     if (bEmptyList)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_RESET)
-            ProcessEvent(*i);
-    }
+    ProcessEvents(EVENT_T_RESET);
 
-    //Reset all events to enabled
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+    //Reset all out of combat timers
+    std::vector<uint32> const& events = EventsByType[EVENT_T_TIMER_OOC];
+    for (uint32 i = 0; i < events.size(); ++i)
     {
-        CreatureEventAI_Event const& event = (*i).Event;
-        switch (event.event_type)
-        {
-            //Reset all out of combat timers
-            case EVENT_T_TIMER_OOC:
-            {
-                if ((*i).UpdateRepeatTimer(m_creature,event.timer.initialMin,event.timer.initialMax))
-                    (*i).Enabled = true;
-                break;
-            }
-            //default:
-            //TODO: enable below code line / verify this is correct to enable events previously disabled (ex. aggro yell), instead of enable this in void EnterCombat()
-            //(*i).Enabled = true;
-            //(*i).Time = 0;
-            //break;
-        }
+        CreatureEventAIHolder& holder = CreatureEventAIList[events[i]];
+        if (UpdateRepeatTimer(holder, holder.Event.timer.initialMin, holder.Event.timer.initialMax))
+            holder.Enabled = true;
     }
 }
 
@@ -991,13 +1121,8 @@ void CreatureEventAI::JustReachedHome()
     m_creature->LoadCreaturesAddon();
 
     if (!bEmptyList)
-    {
-        for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-        {
-            if ((*i).Event.event_type == EVENT_T_REACHED_HOME)
-                ProcessEvent(*i);
-        }
-    }
+        ProcessEvents(EVENT_T_REACHED_HOME);
+
     Reset();
     m_creature->GetMotionMaster()->Initialize();
 }
@@ -1010,11 +1135,7 @@ void CreatureEventAI::EnterEvadeMode()
         return;
 
     //Handle Evade events
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_EVADE)
-            ProcessEvent(*i);
-    }
+    ProcessEvents(EVENT_T_EVADE);
 }
 
 void CreatureEventAI::JustDied(Unit* killer)
@@ -1022,17 +1143,13 @@ void CreatureEventAI::JustDied(Unit* killer)
     if (bEmptyList)
         return;
 
-    //Handle Evade events
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_DEATH)
-            ProcessEvent(*i, killer);
-    }
+    //Handle Death events
+    ProcessEvents(EVENT_T_DEATH, killer);
 
     eventAISummonedList.clear();
 
     // reset phase after any death state events
-    Phase = 0;
+    SetPhase(0);
 }
 
 void CreatureEventAI::KilledUnit(Unit* victim)
@@ -1040,11 +1157,7 @@ void CreatureEventAI::KilledUnit(Unit* victim)
     if (bEmptyList || victim->GetTypeId() != TYPEID_PLAYER)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_KILL)
-            ProcessEvent(*i, victim);
-    }
+    ProcessEvents(EVENT_T_KILL, victim);
 }
 
 void CreatureEventAI::JustSummoned(Creature* pUnit)
@@ -1082,11 +1195,7 @@ void CreatureEventAI::JustSummoned(Creature* pUnit)
 
     eventAISummonedList.push_back(pUnit->GetGUID());
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_SUMMONED_UNIT)
-            ProcessEvent(*i, pUnit);
-    }
+    ProcessEvents(EVENT_T_SUMMONED_UNIT, pUnit);
 }
 
 void CreatureEventAI::EnterCombat(Unit *enemy)
@@ -1096,7 +1205,7 @@ void CreatureEventAI::EnterCombat(Unit *enemy)
     //Check for on combat start events
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+        for (CreatureEventAIHolderList::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
         {
             CreatureEventAI_Event const& event = (*i).Event;
             switch (event.event_type)
@@ -1107,13 +1216,13 @@ void CreatureEventAI::EnterCombat(Unit *enemy)
                     break;
                     //Reset all in combat timers
                 case EVENT_T_TIMER:
-                    if ((*i).UpdateRepeatTimer(m_creature,event.timer.initialMin,event.timer.initialMax))
+                    if (UpdateRepeatTimer(*i, event.timer.initialMin,event.timer.initialMax))
                         (*i).Enabled = true;
                     break;
                     //All normal events need to be re-enabled and their time set to 0
                 default:
                     (*i).Enabled = true;
-                    (*i).Time = 0;
+                    SetEventTimer(*i, 0);
                     break;
             }
         }
@@ -1143,21 +1252,21 @@ void CreatureEventAI::MoveInLineOfSight(Unit *who)
     //Check for OOC LOS Event
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator itr = CreatureEventAIList.begin(); itr != CreatureEventAIList.end(); ++itr)
+        std::vector<uint32> const& events = EventsByType[EVENT_T_OOC_LOS];
+        for (uint32 i = 0; i < events.size(); ++i)
         {
-            if ((*itr).Event.event_type == EVENT_T_OOC_LOS)
-            {
-                //can trigger if closer than fMaxAllowedRange
-                float fMaxAllowedRange = (*itr).Event.ooc_los.maxRange;
+            CreatureEventAIHolder& holder = CreatureEventAIList[events[i]];
 
-                //if range is ok and we are actually in LOS
-                if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
-                {
-                    //if friendly event&&who is not hostile OR hostile event&&who is hostile
-                    if (((*itr).Event.ooc_los.noHostile && !m_creature->IsHostileTo(who)) ||
-                        ((!(*itr).Event.ooc_los.noHostile) && (me->IsHostileTo(who) || who->IsHostileTo(me))))
-                        ProcessEvent(*itr, who);
-                }
+            //can trigger if closer than fMaxAllowedRange
+            float fMaxAllowedRange = holder.Event.ooc_los.maxRange;
+
+            //if range is ok and we are actually in LOS
+            if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
+            {
+                //if friendly event&&who is not hostile OR hostile event&&who is hostile
+                if ((holder.Event.ooc_los.noHostile && !m_creature->IsHostileTo(who)) ||
+                    ((!holder.Event.ooc_los.noHostile) && (me->IsHostileTo(who) || who->IsHostileTo(me))))
+                    ProcessEvent(holder, who);
             }
         }
     }
@@ -1171,12 +1280,15 @@ void CreatureEventAI::SpellHit(Unit* pUnit, const SpellEntry* pSpell)
     if (bEmptyList)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-        if ((*i).Event.event_type == EVENT_T_SPELLHIT)
-            //If spell id matches (or no spell id) & if spell school matches (or no spell school)
-            if (!(*i).Event.spell_hit.spellId || pSpell->Id == (*i).Event.spell_hit.spellId)
-                if (pSpell->SchoolMask & (*i).Event.spell_hit.schoolMask)
-                    ProcessEvent(*i, pUnit);
+    std::vector<uint32> const& events = EventsByType[EVENT_T_SPELLHIT];
+    for (uint32 i = 0; i < events.size(); ++i)
+    {
+        CreatureEventAIHolder& holder = CreatureEventAIList[events[i]];
+        //If spell id matches (or no spell id) & if spell school matches (or no spell school)
+        if (!holder.Event.spell_hit.spellId || pSpell->Id == holder.Event.spell_hit.spellId)
+            if (pSpell->SchoolMask & holder.Event.spell_hit.schoolMask)
+                ProcessEvent(holder, pUnit);
+    }
 }
 
 void CreatureEventAI::UpdateAI(const uint32 diff)
@@ -1191,25 +1303,12 @@ void CreatureEventAI::UpdateAI(const uint32 diff)
 
         if (EventUpdateTime.Expired(diff))
         {
+            UpdateEventTimers(EventDiff);
 
-
-            //Check for time based events
-            for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+            //Check for time based events, only those with no time remaining are listed
+            for (uint32 index = 0; index < ArmedEvents.size();)
             {
-                //Decrement Timers
-                if ((*i).Time)
-                {
-                    if ((*i).Time > EventDiff)
-                    {
-                        //Do not decrement timers if event cannot trigger in this phase
-                        if (!((*i).Event.event_inverse_phase_mask & (1 << Phase)))
-                            (*i).Time -= EventDiff;
-
-                        //Skip processing of events that have time remaining
-                        continue;
-                    }
-                    else (*i).Time = 0;
-                }
+                CreatureEventAIHolder* i = &CreatureEventAIList[ArmedEvents[index]];
 
                 //Events that are updated every EVENT_UPDATE_TIME
                 switch ((*i).Event.event_type)
@@ -1237,6 +1336,17 @@ void CreatureEventAI::UpdateAI(const uint32 diff)
                         }
                         break;
                 }
+
+                // processed event got a repeat timer or was disabled, the timer arms it again
+                if (!(*i).Time && (*i).Enabled)
+                {
+                    ++index;
+                    continue;
+                }
+
+                (*i).Armed = false;
+                ArmedEvents[index] = ArmedEvents.back();
+                ArmedEvents.pop_back();
             }
 
             EventDiff = 0;
@@ -1452,19 +1562,18 @@ void CreatureEventAI::ReceiveEmote(Player* pPlayer, uint32 text_emote)
     if (bEmptyList)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator itr = CreatureEventAIList.begin(); itr != CreatureEventAIList.end(); ++itr)
+    std::vector<uint32> const& events = EventsByType[EVENT_T_RECEIVE_EMOTE];
+    for (uint32 i = 0; i < events.size(); ++i)
     {
-        if ((*itr).Event.event_type == EVENT_T_RECEIVE_EMOTE)
-        {
-            if ((*itr).Event.receive_emote.emoteId != text_emote)
-                return;
+        CreatureEventAIHolder& holder = CreatureEventAIList[events[i]];
+        if (holder.Event.receive_emote.emoteId != text_emote)
+            return;
 
-            PlayerCondition pcon((*itr).Event.receive_emote.condition,(*itr).Event.receive_emote.conditionValue1,(*itr).Event.receive_emote.conditionValue2);
-            if (pcon.Meets(pPlayer))
-            {
-                sLog.outDebug("CreatureEventAI: ReceiveEmote CreatureEventAI: Condition ok, processing");
-                ProcessEvent(*itr, pPlayer);
-            }
+        PlayerCondition pcon(holder.Event.receive_emote.condition,holder.Event.receive_emote.conditionValue1,holder.Event.receive_emote.conditionValue2);
+        if (pcon.Meets(pPlayer))
+        {
+            sLog.outDebug("CreatureEventAI: ReceiveEmote CreatureEventAI: Condition ok, processing");
+            ProcessEvent(holder, pPlayer);
         }
     }
 }
@@ -1508,9 +1617,9 @@ void CreatureEventAI::GetDebugInfo(ChatHandler& reader)
     std::ostringstream str;
     str << "Debug info for EventAI of " << me->GetName() << "(" << me->GetEntry() << " : " << me->GetGUIDLow();
     str << ") consists of " << CreatureEventAIList.size() << " event entries\n";
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+    for (CreatureEventAIHolderList::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
     {
-        str << "Event " << i->Event.event_id << " timer " << i->Time << " flags " << i->Event.event_flags
+        str << "Event " << i->Event.event_id << " timer " << GetEventTimeLeft(*i) << " flags " << i->Event.event_flags
             << " chance " << i->Event.event_chance << (i->Enabled ? " (enabled)\n" : " (disabled)\n");
         switch (i->Event.event_type)
         {
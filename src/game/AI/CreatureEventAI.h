@@ -26,6 +26,8 @@
 #include "CreatureAI.h"
 #include "Unit.h"
 
+#include <queue>
+
 class Player;
 class WorldObject;
 
@@ -581,16 +583,18 @@ typedef UNORDERED_MAP<uint32, CreatureEventAI_Summon> CreatureEventAI_Summon_Map
 
 struct CreatureEventAIHolder
 {
-    CreatureEventAIHolder(CreatureEventAI_Event p) : Event(p), Time(0), Enabled(true){}
+    CreatureEventAIHolder(CreatureEventAI_Event p) : Event(p), Time(0), Due(0), Enabled(true), Frozen(false), Armed(false){}
 
     CreatureEventAI_Event Event;
-    uint32 Time;
+    uint32 Time;                                            // event can't trigger while non zero
+    uint64 Due;                                             // EventClock when Time runs out, 0 while not counting down
     bool Enabled;
-
-    // helper
-    bool UpdateRepeatTimer(Creature* creature, uint32 repeatMin, uint32 repeatMax);
+    bool Frozen;                                            // listed in CreatureEventAI::FrozenEvents
+    bool Armed;                                             // listed in CreatureEventAI::ArmedEvents
 };
 
+typedef std::vector<CreatureEventAIHolder> CreatureEventAIHolderList;
+
 class CreatureEventAI : public CreatureAI
 {
 
@@ -618,6 +622,7 @@ class CreatureEventAI : public CreatureAI
         void GetDebugInfo(ChatHandler& reader);
 
         bool ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pActionInvoker = NULL);
+        void ProcessEvents(EventAI_Type type, Unit* pActionInvoker = NULL);
         void ProcessAction(CreatureEventAI_Action const& action, uint32 rnd, uint32 EventId, Unit* pActionInvoker);
         inline uint32 GetRandActionParam(uint32 rnd, uint32 param1, uint32 param2, uint32 param3);
         inline int32 GetRandActionParam(uint32 rnd, int32 param1, int32 param2, int32 param3);
@@ -632,8 +637,25 @@ class CreatureEventAI : public CreatureAI
         void FindFriendlyMissingBuff(std::list<Creature*>& _list, float range, uint32 spellid);
         void FindFriendlyCC(std::list<Creature*>& _list, float range);
 
+        bool UpdateRepeatTimer(CreatureEventAIHolder& holder, uint32 repeatMin, uint32 repeatMax);
+        // Time counts down only in phases the event can trigger in
+        void SetEventTimer(CreatureEventAIHolder& holder, uint32 time);
+        void UpdateEventTimers(uint32 diff);
+        void SetPhase(uint8 phase);
+        void FreezeEventTimer(uint32 index);
+        void ArmEvent(uint32 index);
+        static bool IsPolledEvent(uint32 type);
+        bool IsPhaseBlocked(CreatureEventAIHolder const& holder) const { return holder.Event.event_inverse_phase_mask & (1 << Phase); }
+        uint32 GetEventTimeLeft(CreatureEventAIHolder const& holder) const { return holder.Due ? uint32(holder.Due - EventClock) : holder.Time; }
+
                                                             //Holder for events (stores enabled, time, and eventid)
-        std::list<CreatureEventAIHolder> CreatureEventAIList;
+        CreatureEventAIHolderList CreatureEventAIList;     // not changed after constructor, indexes below point into it
+        std::vector<uint32> EventsByType[EVENT_T_END];
+        std::vector<uint32> ArmedEvents;                    // polled events with no time left, checked every EVENT_UPDATE_TIME
+        typedef std::pair<uint64, uint32> EventTimer;       // due, index
+        std::priority_queue<EventTimer, std::vector<EventTimer>, std::greater<EventTimer> > EventTimers;
+        std::vector<uint32> FrozenEvents;                   // waiting, but not counting down in current phase
+        uint64 EventClock;                                  // sum of EventDiff of all event updates
         Timer EventUpdateTime;                             //Time between event updates
         uint32 EventDiff;                                   //Time between the last event call
         bool bEmptyList;
@@ -25,7 +25,7 @@
 #include "Chat.h"
 
 Channel::Channel(const std::string& name)
-: m_announce(false), m_moderate(false), m_name(name), m_ownerGUID(0)
+: m_announce(false), m_moderate(false), m_name(name), m_ownerGUID(0), m_sendStamp(0)
 {
     // DO NOT TRUST channel ids send from client!!
     if (name == "world")
@@ -119,6 +119,7 @@ void Channel::Join(uint64 p, const char *pass)
     PlayerInfo pinfo;
     pinfo.player = p;
     pinfo.flags = 0;
+    pinfo.slot = AddMember(p, plr);
     players[p] = pinfo;
 
     MakeYouJoined(&data);
@@ -161,6 +162,7 @@ void Channel::Leave(uint64 p, bool send)
 
         bool changeowner = players[p].IsOwner();
 
+        RemoveMember(p);
         players.erase(p);
         if (m_announce && (!plr || !plr->GetSession()->HasHigherGMLevel(SEC_GAMEMASTER) || !sWorld.getConfig(CONFIG_SILENTLY_GM_JOIN_TO_CHANNEL)))
         {
@@ -225,6 +227,7 @@ void Channel::KickOrBan(uint64 good, const char *badname, bool ban)
                 MakePlayerKicked(&data, bad->GetGUID(), good);
 
             SendToAll(&data);
+            RemoveMember(bad->GetGUID());
             players.erase(bad->GetGUID());
             bad->LeftChannel(this);
 
@@ -598,20 +601,9 @@ void Channel::Say(uint64 p, const char *what, uint32 lang)
         {
             // exclude LFG and Trade from two-side channels
             if (sWorld.getConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_CHANNEL) && (IsLFG() || m_channelId == CHANNEL_ID_TRADE) && plr)
-            {
-                uint32 fromteam = plr->GetTeam();
-                for (PlayerList::iterator i = players.begin(); i != players.end(); ++i)
-                {
-                    Player *to = sObjectMgr.GetPlayer(i->first);
-                    if (!to || to->GetTeam() != fromteam)
-                        continue;
-
-                    if (!p || !to->GetSocial()->HasIgnore(GUID_LOPART(p)))
-                        to->SendPacketToSelf(&data);
-                }
-            }
-            else 
-            SendToAll(&data, !players[p].IsModerator() ? p : false);
+                SendToAll(&data, p, plr->GetTeam());
+            else
+                SendToAll(&data, !players[p].IsModerator() ? p : 0);
         }
         else
             plr->SendPacketToSelf(&data);
@@ -717,29 +709,42 @@ void Channel::SetOwner(uint64 guid, bool exclaim)
     }
 }
 
-void Channel::SendToAll(WorldPacket *data, uint64 p)
+void Channel::SendToAll(WorldPacket *data, uint64 p, uint32 team)
 {
-    for (PlayerList::iterator i = players.begin(); i != players.end(); ++i)
+    uint32 stamp = p ? MarkIgnoring(p) : 0;
+
+    for (MemberList::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
     {
-        Player *plr = sObjectMgr.GetPlayer(i->first);
-        if (plr)
+        if (p && itr->skipStamp == stamp)
+            continue;
+
+        Player *plr = itr->player;
+        if (!plr)
         {
-            if (!p || !plr->GetSocial()->HasIgnore(GUID_LOPART(p)))
-                plr->SendPacketToSelf(data);
+            plr = sObjectMgr.GetPlayer(itr->guid);
+            if (!plr || (p && plr->GetSocial()->HasIgnore(GUID_LOPART(p))))
+                continue;
         }
+        else if (!plr->IsInWorld())
+            continue;
+
+        if (team && plr->GetTeam() != team)
+            continue;
+
+        plr->GetSession()->SendPacket(data);
     }
 }
 
 void Channel::SendToAllButOne(WorldPacket *data, uint64 who)
 {
-    for (PlayerList::iterator i = players.begin(); i != players.end(); ++i)
+    for (MemberList::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
     {
-        if (i->first != who)
-        {
-            Player *plr = sObjectMgr.GetPlayer(i->first);
-            if (plr)
-                plr->SendPacketToSelf(data);
-        }
+        if (itr->guid == who)
+            continue;
+
+        Player *plr = itr->player ? itr->player : sObjectMgr.GetPlayer(itr->guid);
+        if (plr && plr->IsInWorld())
+            plr->GetSession()->SendPacket(data);
     }
 }
 
@@ -1057,6 +1062,108 @@ std::list<uint64> Channel::GetPlayers()
     return tmpList;
 }
 
+uint32 Channel::AddMember(uint64 guid, Player* plr)
+{
+    ChannelMember member;
+    member.guid = guid;
+    member.player = plr;
+    member.skipStamp = 0;
+    if (plr)
+        plr->GetSocial()->GetIgnoreList(member.ignores);
+
+    for (std::vector<uint32>::const_iterator itr = member.ignores.begin(); itr != member.ignores.end(); ++itr)
+        m_ignoredBy[*itr].push_back(guid);
+
+    m_members.push_back(member);
+    return m_members.size() - 1;
+}
+
+void Channel::RemoveMember(uint64 guid)
+{
+    PlayerList::iterator info = players.find(guid);
+    if (info == players.end() || info->second.slot == CHANNEL_NO_SLOT)
+        return;
+
+    uint32 slot = info->second.slot;
+    info->second.slot = CHANNEL_NO_SLOT;
+
+    std::vector<uint32> const& ignores = m_members[slot].ignores;
+    for (std::vector<uint32>::const_iterator itr = ignores.begin(); itr != ignores.end(); ++itr)
+        RemoveIgnoredBy(*itr, guid);
+
+    if (slot + 1 != m_members.size())
+    {
+        m_members[slot] = m_members.back();
+        players[m_members[slot].guid].slot = slot;
+    }
+    m_members.pop_back();
+}
+
+void Channel::RemoveIgnoredBy(uint32 ignored, uint64 guid)
+{
+    IgnoredByMap::iterator itr = m_ignoredBy.find(ignored);
+    if (itr == m_ignoredBy.end())
+        return;
+
+    std::vector<uint64>& members = itr->second;
+    std::vector<uint64>::iterator member = std::find(members.begin(), members.end(), guid);
+    if (member != members.end())
+    {
+        *member = members.back();
+        members.pop_back();
+    }
+
+    if (members.empty())
+        m_ignoredBy.erase(itr);
+}
+
+uint32 Channel::MarkIgnoring(uint64 p)
+{
+    if (++m_sendStamp == 0)
+    {
+        for (MemberList::iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
+            itr->skipStamp = 0;
+        m_sendStamp = 1;
+    }
+
+    IgnoredByMap::const_iterator itr = m_ignoredBy.find(GUID_LOPART(p));
+    if (itr == m_ignoredBy.end())
+        return m_sendStamp;
+
+    for (std::vector<uint64>::const_iterator guid = itr->second.begin(); guid != itr->second.end(); ++guid)
+    {
+        PlayerList::const_iterator info = players.find(*guid);
+        if (info != players.end() && info->second.slot != CHANNEL_NO_SLOT)
+            m_members[info->second.slot].skipStamp = m_sendStamp;
+    }
+
+    return m_sendStamp;
+}
+
+void Channel::SetIgnore(uint64 member, uint32 ignored, bool ignore)
+{
+    PlayerList::const_iterator info = players.find(member);
+    if (info == players.end() || info->second.slot == CHANNEL_NO_SLOT)
+        return;
+
+    std::vector<uint32>& ignores = m_members[info->second.slot].ignores;
+    std::vector<uint32>::iterator itr = std::find(ignores.begin(), ignores.end(), ignored);
+    if (ignore == (itr != ignores.end()))
+        return;
+
+    if (ignore)
+    {
+        ignores.push_back(ignored);
+        m_ignoredBy[ignored].push_back(member);
+    }
+    else
+    {
+        *itr = ignores.back();
+        ignores.pop_back();
+        RemoveIgnoredBy(ignored, member);
+    }
+}
+
 void Channel::ChangeOwner()
 {
     uint64 newOwner = 0;
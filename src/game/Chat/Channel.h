@@ -30,6 +30,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 enum ChannelIds
 {
@@ -43,6 +44,17 @@ enum ChannelIds
     CHANNEL_ID_LFG              = 26,
 };
 
+#define CHANNEL_NO_SLOT     0xFFFFFFFF
+
+// member as seen by broadcasts, player pointer is valid until member leaves (at latest on logout)
+struct ChannelMember
+{
+    uint64 guid;
+    Player* player;                                         // NULL if not online at join, looked up on every send then
+    std::vector<uint32> ignores;                            // low guids ignored by member, kept in sync by Player::ChannelIgnoreChanged
+    uint32 skipStamp;                                       // excluded from send with this stamp
+};
+
 class Channel
 {
     enum ChatNotify
@@ -102,8 +114,11 @@ class Channel
 
     struct PlayerInfo
     {
+        PlayerInfo() : player(0), flags(0), slot(CHANNEL_NO_SLOT) {}
+
         uint64 player;
         uint8 flags;
+        uint32 slot;                                        // index in m_members
 
         bool HasFlag(uint8 flag) { return flags & flag; }
         void SetFlag(uint8 flag) { if (!HasFlag(flag)) flags |= flag; }
@@ -139,8 +154,22 @@ class Channel
     uint32      m_channelId;
     uint64      m_ownerGUID;
 
+    // broadcast recipients, unordered
+    typedef     std::vector<ChannelMember> MemberList;
+    MemberList  m_members;
+    // low guid -> members ignoring it
+    typedef     UNORDERED_MAP<uint32, std::vector<uint64> > IgnoredByMap;
+    IgnoredByMap m_ignoredBy;
+    uint32      m_sendStamp;
+
     private:
         void ChangeOwner();
+
+        uint32 AddMember(uint64 guid, Player* plr);
+        void RemoveMember(uint64 guid);
+        void RemoveIgnoredBy(uint32 ignored, uint64 guid);
+        // marks members ignoring p, returns stamp they got
+        uint32 MarkIgnoring(uint64 p);
         // initial packet data (notify type and channel name)
         void MakeNotifyPacket(WorldPacket *data, uint8 notify_type);
         // type specific packet data
@@ -181,7 +210,8 @@ class Channel
         void MakeVoiceOn(WorldPacket *data, uint64 guid);                       //+ 0x22
         void MakeVoiceOff(WorldPacket *data, uint64 guid);                      //+ 0x23
 
-        void SendToAll(WorldPacket *data, uint64 p = 0);
+        // p - skip members ignoring this player, team - send only to members of team
+        void SendToAll(WorldPacket *data, uint64 p = 0, uint32 team = 0);
         void SendToAllButOne(WorldPacket *data, uint64 who);
         void SendToOne(WorldPacket *data, uint64 who);
 
@@ -263,6 +293,9 @@ class Channel
         void JoinNotify(uint64 guid);                                           // invisible notify
         void LeaveNotify(uint64 guid);                                          // invisible notify
         std::list<uint64> GetPlayers();
+
+        // member added or removed ignored player
+        void SetIgnore(uint64 member, uint32 ignored, bool ignore);
 };
 #endif
 
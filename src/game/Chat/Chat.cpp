@@ -141,8 +141,10 @@ ChatCommand * ChatHandler::getCommandTable()
 
     static ChatCommand serverCommandTable[] =
     {
+        { "aurastats",      SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   &ChatHandler::HandleServerAuraStatsCommand,     "", NULL },
         { "corpses",        SEC_BASIC_ADMIN,  SEC_CONSOLE, true,   &ChatHandler::HandleServerCorpsesCommand,       "", NULL },
         { "events",         SEC_PLAYER,    SEC_CONSOLE, true,   &ChatHandler::HandleServerEventsCommand,        "", NULL },
+        { "gridloads",      SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   &ChatHandler::HandleServerGridLoadsCommand,     "", NULL },
         { "exit",           SEC_CONSOLE,   SEC_CONSOLE, true,   &ChatHandler::HandleServerExitCommand,          "", NULL },
         { "idlerestart",    SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   NULL,                                           "", serverIdleRestartCommandTable },
         { "idleshutdown",   SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   NULL,                                           "", serverShutdownCommandTable },
@@ -150,6 +152,11 @@ ChatCommand * ChatHandler::getCommandTable()
         { "kickall",        SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   &ChatHandler::HandleServerKickallCommand,       "", NULL },
         { "motd",           SEC_PLAYER,    SEC_CONSOLE, true,   &ChatHandler::HandleServerMotdCommand,          "", NULL },
         { "mute",           SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   &ChatHandler::HandleServerMuteCommand,          "", NULL },
+        { "maptimes",       SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   &ChatHandler::HandleServerMapTimesCommand,      "", NULL },
+        { "relocstats",     SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   &ChatHandler::HandleServerRelocStatsCommand,    "", NULL },
+        { "opcodestats",    SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   &ChatHandler::HandleServerOpcodeStatsCommand,   "", NULL },
+        { "profile",        SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   &ChatHandler::HandleServerProfileCommand,       "", NULL },
+        { "prefetch",       SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   &ChatHandler::HandleServerPrefetchCommand,      "", NULL },
         { "pvp",            SEC_PLAYER,    SEC_CONSOLE, false,  &ChatHandler::HandleServerPVPCommand,           "", NULL },
         { "restart",        SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   NULL,                                           "", serverRestartCommandTable },
         { "rollshutdown",   SEC_ADMINISTRATOR,       SEC_CONSOLE, true,   &ChatHandler::HandleServerRollShutDownCommand,  "", NULL},
@@ -281,6 +288,7 @@ ChatCommand * ChatHandler::getCommandTable()
         { "stop",           SEC_GAMEMASTER,       SEC_CONSOLE, true,  &ChatHandler::HandleBotStopCommand,              "", NULL },
         { "start",          SEC_GAMEMASTER,       SEC_CONSOLE, true,  &ChatHandler::HandleBotStartCommand,             "", NULL },
         { "ranadd",         SEC_GAMEMASTER,       SEC_CONSOLE, true,  &ChatHandler::HandleBotAddRandomCommand,         "", NULL },
+        { "benchmark",      SEC_ADMINISTRATOR,    SEC_CONSOLE, true,  &ChatHandler::HandleBotBenchmarkCommand,         "", NULL },
         { NULL,             0,              0,            false, NULL,                                            "", NULL }
     };
 
@@ -531,6 +539,7 @@ ChatCommand * ChatHandler::getCommandTable()
         { "account",        SEC_GAMEMASTER,       SEC_CONSOLE, true,   &ChatHandler::HandleLookupPlayerAccountCommand, "", NULL },
         { "email",          SEC_BASIC_ADMIN,  SEC_CONSOLE, true,   &ChatHandler::HandleLookupPlayerEmailCommand,   "", NULL },
         { "ip",             SEC_GAMEMASTER,       SEC_CONSOLE, true,   &ChatHandler::HandleLookupPlayerIpCommand,      "", NULL },
+        { "online",         SEC_GAMEMASTER,       SEC_CONSOLE, true,   &ChatHandler::HandleLookupPlayerOnlineCommand,  "", NULL },
         { NULL,             0,              0,            false,  NULL,                                           "", NULL }
     };
 
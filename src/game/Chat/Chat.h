@@ -147,6 +147,7 @@ class ChatHandler
         bool HandleBotReloadCommand(const char * args);
         bool HandleBotStopCommand(const char * args);
         bool HandleBotStartCommand(const char * args);
+        bool HandleBotBenchmarkCommand(const char * args);
         bool PartyBotAddRequirementCheck(Player const* pPlayer, Player const* pTarget);
         bool HandlePartyBotAddCommand(const char * args);
         bool HandlePartyBotCloneCommand(const char * args);
@@ -308,6 +309,7 @@ class ChatHandler
         bool HandleLookupItemSetCommand(const char * args);
         bool HandleLookupObjectCommand(const char* args);
         bool HandleLookupPlayerIpCommand(const char* args);
+        bool HandleLookupPlayerOnlineCommand(const char* args);
         bool HandleLookupPlayerAccountCommand(const char* args);
         bool HandleLookupPlayerEmailCommand(const char* args);
         bool HandleLookupQuestCommand(const char* args);
@@ -495,8 +497,15 @@ class ChatHandler
         bool HandleServerIdleShutDownCommand(const char* args);
         bool HandleServerInfoCommand(const char* args);
         bool HandleServerKickallCommand(const char* args);
+        bool HandleServerAuraStatsCommand(const char* args);
         bool HandleServerMotdCommand(const char* args);
+        bool HandleServerMapTimesCommand(const char* args);
+        bool HandleServerRelocStatsCommand(const char* args);
+        bool HandleServerGridLoadsCommand(const char* args);
+        bool HandleServerPrefetchCommand(const char* args);
         bool HandleServerMuteCommand(const char* args);
+        bool HandleServerOpcodeStatsCommand(const char* args);
+        bool HandleServerProfileCommand(const char* args);
         bool HandleServerRestartCommand(const char* args);
         bool HandleServerSetMotdCommand(const char* args);
         bool HandleServerSetDiffTimeCommand(const char* args);
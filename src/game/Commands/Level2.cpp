@@ -54,6 +54,8 @@
 #include "TargetedMovementGenerator.h"                      // for HandleNpcUnFollowCommand
 #include "MoveMap.h"                                        // for mmap manager
 #include "PathFinder.h"                                     // for mmap commands
+#include "PathFinderQueue.h"                                // for mmap stats
+#include "WhoListCache.h"                                   // for online player lookup
 
 static uint32 ReputationRankStrIndex[MAX_REPUTATION_RANK] =
 {
@@ -4565,6 +4567,60 @@ bool ChatHandler::HandleLookupPlayerEmailCommand(const char* args)
     return LookupPlayerSearchCommand(result, limit);
 }
 
+// .lookup player online #nameprefix [#limit]
+bool ChatHandler::HandleLookupPlayerOnlineCommand(const char* args)
+{
+    if (!*args)
+        return false;
+
+    std::string prefix = strtok((char*)args, " ");
+    char* limit_str = strtok(NULL, " ");
+    uint32 limit = limit_str ? atoi(limit_str) : 0;
+    if (!limit)
+        limit = 50;
+
+    std::wstring wprefix;
+    if (!Utf8toWStr(prefix, wprefix))
+        return false;
+    wstrToLower(wprefix);
+
+    WhoListSnapshotPtr snapshot = sWhoListCache.GetSnapshot();
+    if (!snapshot)
+    {
+        PSendSysMessage(LANG_NO_PLAYERS_FOUND);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    typedef std::vector<std::pair<std::wstring, uint32> > NameList;
+    NameList::const_iterator itr = std::lower_bound(snapshot->names.begin(), snapshot->names.end(), std::make_pair(wprefix, uint32(0)));
+
+    uint32 count = 0;
+    for (; itr != snapshot->names.end() && itr->first.compare(0, wprefix.size(), wprefix) == 0 && count < limit; ++itr, ++count)
+    {
+        WhoListEntry const& entry = snapshot->entries[itr->second];
+
+        std::string zoneName = "<unknown>";
+        if (AreaTableEntry const* zone = GetAreaEntryByAreaID(entry.zoneId))
+            zoneName = zone->area_name[m_session ? LocaleConstant(m_session->GetSessionDbcLocale()) : LocaleConstant(sWorld.GetDefaultDbcLocale())];
+
+        PSendSysMessage("%s (guid %u) level %u, %s, zone %s (%u), guild %s, gm level %u",
+            entry.name.c_str(), GUID_LOPART(entry.guid), entry.level, entry.team == HORDE ? "horde" : "alliance",
+            zoneName.c_str(), entry.zoneId, entry.guildName.empty() ? "-" : entry.guildName.c_str(), entry.gmLevel);
+    }
+
+    if (!count)
+    {
+        PSendSysMessage(LANG_NO_PLAYERS_FOUND);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("%u players shown, list of %u online players is %u s old.",
+        count, uint32(snapshot->entries.size()), uint32(time(NULL) - snapshot->created));
+    return true;
+}
+
 bool ChatHandler::LookupPlayerSearchCommand(QueryResultAutoPtr result, int32 limit)
 {
     if (!result)
@@ -5348,6 +5404,18 @@ bool ChatHandler::HandleMmapStatsCommand(const char* /*args*/)
     MMAP::MMapManager *manager = MMAP::MMapFactory::createOrGetMMapManager();
     PSendSysMessage(" %u maps loaded with %u tiles overall", manager->getLoadedMapsCount(), manager->getLoadedTilesCount());
 
+    PathFinderQueue& queue = sPathFinderQueue;
+    uint64 syncSearches = queue.GetSyncSearches();
+    uint64 asyncSearches = queue.GetAsyncSearches();
+    uint64 waited = asyncSearches + queue.GetCancelled() + queue.GetFailed();
+    PSendSysMessage(" path finder queue %s, %u threads, %u pending", queue.IsActive() ? "running" : "stopped", queue.GetThreads(), queue.GetPending());
+    PSendSysMessage(" " UI64FMTD " sync searches, avg %u us", syncSearches, syncSearches ? uint32(queue.GetSyncTime() / syncSearches) : 0);
+    PSendSysMessage(" " UI64FMTD " async searches, avg %u us, max %u us", asyncSearches, asyncSearches ? uint32(queue.GetAsyncTime() / asyncSearches) : 0, queue.GetAsyncTimeMax());
+    PSendSysMessage(" queue wait avg %u us, max %u us, " UI64FMTD " cancelled, " UI64FMTD " failed",
+        waited ? uint32(queue.GetQueueWait() / waited) : 0, queue.GetQueueWaitMax(), queue.GetCancelled(), queue.GetFailed());
+    PSendSysMessage(" " UI64FMTD " targets followed by corridor patch, " UI64FMTD " poly paths from cache",
+        queue.GetCorridorPatches(), queue.GetCacheHits());
+
     const dtNavMesh* navmesh = manager->GetNavMesh(m_session->GetPlayer()->GetMapId());
     if (!navmesh)
     {
@@ -32,6 +32,7 @@
 #include "GameObject.h"
 #include "Chat.h"
 #include "Log.h"
+#include "Profiler.h"
 #include "Guild.h"
 #include "ObjectAccessor.h"
 #include "MapManager.h"
@@ -55,6 +56,8 @@
 #include "CreatureEventAIMgr.h"
 #include "ChannelMgr.h"
 #include "GuildMgr.h"
+#include "TerrainPrefetcher.h"
+#include "AuraTimerWheel.h"
 
 bool ChatHandler::HandleReloadAutobroadcastCommand(const char*)
 {
@@ -461,6 +464,7 @@ bool ChatHandler::HandleReloadSpellAffectCommand(const char*)
 {
     sLog.outString("Re-Loading SpellAffect definitions...");
     sSpellMgr.LoadSpellAffects();
+    sSpellMgr.LoadSpellHotInfo();
     SendGlobalGMSysMessage("DB table `spell_affect` (spell mods apply requirements) reloaded.");
     return true;
 }
@@ -477,6 +481,7 @@ bool ChatHandler::HandleReloadSpellElixirCommand(const char*)
 {
     sLog.outString("Re-Loading Spell Elixir types...");
     sSpellMgr.LoadSpellElixirs();
+    sSpellMgr.LoadSpellHotInfo();
     SendGlobalGMSysMessage("DB table `spell_elixir` (spell elixir types) reloaded.");
     return true;
 }
@@ -501,6 +506,7 @@ bool ChatHandler::HandleReloadSpellProcEventCommand(const char*)
 {
     sLog.outString("Re-Loading Spell Proc Event conditions...");
     sSpellMgr.LoadSpellProcEvents();
+    sSpellMgr.LoadSpellHotInfo();
     SendGlobalGMSysMessage("DB table `spell_proc_event` (spell proc trigger requirements) reloaded.");
     return true;
 }
@@ -4713,6 +4719,238 @@ bool ChatHandler::HandleServerMuteCommand(const char* args)
     return true;
 }
 
+// .server opcodestats [count] | log | reset
+bool ChatHandler::HandleServerOpcodeStatsCommand(const char* args)
+{
+    if (strncmp(args, "reset", 5) == 0)
+    {
+        ResetOpcodeCosts();
+        SendSysMessage("Opcode stats have been reset.");
+        return true;
+    }
+
+    bool toLog = strncmp(args, "log", 3) == 0;
+    uint32 limit = toLog ? NUM_MSG_TYPES : (*args ? atoi(args) : 0);
+    if (!limit)
+        limit = 10;
+
+    if (!sWorld.getConfig(CONFIG_SESSION_UPDATE_OPCODE_STATS))
+        SendSysMessage("SessionUpdate.OpcodeStats is disabled, stats are not being gathered.");
+
+    std::vector<std::pair<uint64, uint16> > opcodes;
+    for (uint16 i = 0; i < NUM_MSG_TYPES; ++i)
+        if (uint64 total = opcodeCostTable[i].totalTime.load(std::memory_order_relaxed))
+            opcodes.push_back(std::make_pair(total, i));
+
+    std::sort(opcodes.begin(), opcodes.end(), std::greater<std::pair<uint64, uint16> >());
+
+    if (toLog)
+        sLog.outLog(LOG_SESSION_DIFF, "OpcodeStats: opcode;name;count;total_us;avg_us;p50_us;p99_us;max_us");
+
+    for (uint32 i = 0; i < opcodes.size() && i < limit; ++i)
+    {
+        uint16 opcode = opcodes[i].second;
+        OpcodeCost const& cost = opcodeCostTable[opcode];
+
+        uint64 count = cost.count.load(std::memory_order_relaxed);
+        uint64 total = opcodes[i].first;
+        uint32 avg = count ? uint32(total / count) : 0;
+        uint32 p50 = GetOpcodeCostPercentile(opcode, 50.0f);
+        uint32 p99 = GetOpcodeCostPercentile(opcode, 99.0f);
+        uint32 max = cost.maxTime.load(std::memory_order_relaxed);
+
+        if (toLog)
+            sLog.outLog(LOG_SESSION_DIFF, "OpcodeStats: 0x%.4X;%s;" UI64FMTD ";" UI64FMTD ";%u;%u;%u;%u",
+                opcode, LookupOpcodeName(opcode), count, total, avg, p50, p99, max);
+        else
+            PSendSysMessage("%s: " UI64FMTD " calls, " UI64FMTD " ms total, avg %u us, p50 <%u us, p99 <%u us, max %u us",
+                LookupOpcodeName(opcode), count, total / 1000, avg, p50, p99, max);
+    }
+
+    if (toLog)
+        PSendSysMessage("Stats of %u opcodes written to session diff log.", uint32(opcodes.size()));
+
+    return true;
+}
+
+// .server maptimes [count]
+bool ChatHandler::HandleServerMapTimesCommand(const char* args)
+{
+    uint32 limit = *args ? atoi(args) : 0;
+    if (!limit)
+        limit = 10;
+
+    // copied under each map's lock, decoupled instances may be updating
+    std::vector<std::pair<uint32, Map*> > maps;
+    std::map<Map*, MapUpdateTimes> times;
+    for (MapManager::MapMapType::const_iterator itr = sMapMgr.Maps().begin(); itr != sMapMgr.Maps().end(); ++itr)
+    {
+        MapUpdateTimes& mapTimes = times[itr->second];
+        itr->second->GetUpdateTimes(mapTimes);
+        if (mapTimes.count)
+            maps.push_back(std::make_pair(mapTimes.Percentile(99.0f), itr->second));
+    }
+
+    std::sort(maps.begin(), maps.end(), std::greater<std::pair<uint32, Map*> >());
+
+    PSendSysMessage("Map update times of last %u updates, slowest p99 first:", MAP_UPDATE_TIME_HISTORY);
+    for (uint32 i = 0; i < maps.size() && i < limit; ++i)
+    {
+        Map* map = maps[i].second;
+        MapUpdateTimes const& mapTimes = times[map];
+        PSendSysMessage("%s (%u) instance %u: %u updates, p50 %u us, p95 %u us, p99 %u us, max %u us",
+            map->GetMapName(), map->GetId(), map->GetInstanceId(), mapTimes.count,
+            mapTimes.Percentile(50.0f), mapTimes.Percentile(95.0f), maps[i].first, mapTimes.Max());
+    }
+
+    return true;
+}
+
+// .server relocstats [count]
+bool ChatHandler::HandleServerRelocStatsCommand(const char* args)
+{
+    uint32 limit = *args ? atoi(args) : 0;
+    if (!limit)
+        limit = 10;
+
+    std::vector<std::pair<uint64, Map*> > maps;
+    for (MapManager::MapMapType::const_iterator itr = sMapMgr.Maps().begin(); itr != sMapMgr.Maps().end(); ++itr)
+        if (itr->second->GetRelocationNotifyPass().GetPasses())
+            maps.push_back(std::make_pair(itr->second->GetRelocationNotifyPass().GetTime(), itr->second));
+
+    std::sort(maps.begin(), maps.end(), std::greater<std::pair<uint64, Map*> >());
+
+    PSendSysMessage("Batched AI relocation notify: %s", sWorld.getConfig(CONFIG_AI_NOTIFY_BATCHED) ? "enabled" : "disabled");
+    PSendSysMessage("Maps with most time spent in relocation notify pass:");
+    for (uint32 i = 0; i < maps.size() && i < limit; ++i)
+    {
+        Map* map = maps[i].second;
+        RelocationNotifyPass const& pass = map->GetRelocationNotifyPass();
+        PSendSysMessage("%s (%u) instance %u: " UI64FMTD " passes, " UI64FMTD " movers in " UI64FMTD " grid visits, " UI64FMTD " pairs, " UI64FMTD " ms, %u queued",
+            map->GetMapName(), map->GetId(), map->GetInstanceId(), pass.GetPasses(), pass.GetMovers(), pass.GetVisits(),
+            pass.GetPairs(), maps[i].first / 1000, pass.GetQueued());
+    }
+
+    return true;
+}
+
+// .server gridloads [count]
+bool ChatHandler::HandleServerGridLoadsCommand(const char* args)
+{
+    uint32 limit = *args ? atoi(args) : 0;
+    if (!limit)
+        limit = 10;
+
+    // copied under each map's lock, maps may be loading grids meanwhile
+    std::vector<std::pair<uint64, Map*> > maps;
+    std::map<Map*, GridLoadStats> loads;
+    for (MapManager::MapMapType::const_iterator itr = sMapMgr.Maps().begin(); itr != sMapMgr.Maps().end(); ++itr)
+    {
+        GridLoadStats& stats = loads[itr->second];
+        itr->second->GetGridLoadStats(stats);
+        if (stats.loads)
+            maps.push_back(std::make_pair(stats.prepareTime + stats.linkTime, itr->second));
+    }
+
+    std::sort(maps.begin(), maps.end(), std::greater<std::pair<uint64, Map*> >());
+
+    PSendSysMessage("Maps with most time spent in grid loading:");
+    for (uint32 i = 0; i < maps.size() && i < limit; ++i)
+    {
+        Map* map = maps[i].second;
+        GridLoadStats const& stats = loads[map];
+        PSendSysMessage("%s (%u) instance %u: %u grids (%u prefetched), " UI64FMTD " objects, prepare " UI64FMTD " ms, link " UI64FMTD " ms, max %u us",
+            map->GetMapName(), map->GetId(), map->GetInstanceId(), stats.loads, stats.prefetched, stats.objects,
+            stats.prepareTime / 1000, stats.linkTime / 1000, stats.maxTime);
+
+        std::ostringstream histogram;
+        for (uint32 bucket = 0; bucket < GRID_LOAD_HISTOGRAM_BUCKETS; ++bucket)
+        {
+            if (bucket < GRID_LOAD_HISTOGRAM_BUCKETS - 1)
+                histogram << " <=" << GridLoadStats::BucketLimits[bucket] << "ms: ";
+            else
+                histogram << " more: ";
+            histogram << stats.histogram[bucket];
+        }
+        PSendSysMessage("  grids by load time:%s", histogram.str().c_str());
+    }
+
+    return true;
+}
+
+// .server aurastats [reset]
+bool ChatHandler::HandleServerAuraStatsCommand(const char* args)
+{
+    if (*args && strncmp(args, "reset", strlen(args)) == 0)
+    {
+        AuraTimerWheel::ResetStats();
+        SendSysMessage("Aura update stats of every map are reset at its next update.");
+        return true;
+    }
+
+    AuraUpdateStats stats = AuraTimerWheel::GetTotalStats();
+
+    PSendSysMessage("Aura timer wheel: %s", sWorld.getConfig(CONFIG_AURA_TIMER_WHEEL) ? "enabled" : "disabled");
+    PSendSysMessage("Unit aura updates: " UI64FMTD ", auras present: " UI64FMTD ", updated: " UI64FMTD " (%.1f%%), %.2f updated per unit update",
+        stats.updates, stats.present, stats.touched, stats.present ? float(stats.touched) * 100.0f / stats.present : 0.0f,
+        stats.updates ? float(stats.touched) / stats.updates : 0.0f);
+    SendSysMessage("Time in aura updates is recorded as Unit::_UpdateSpells zone by .server profile.");
+    return true;
+}
+
+// .server prefetch [reset]
+bool ChatHandler::HandleServerPrefetchCommand(const char* args)
+{
+    if (!sTerrainPrefetcher.IsActive())
+    {
+        SendSysMessage("Terrain prefetcher is not running, see GridPrefetch in config.");
+        return true;
+    }
+
+    if (*args && strncmp(args, "reset", strlen(args)) == 0)
+    {
+        sTerrainPrefetcher.ResetStats();
+        SendSysMessage("Terrain prefetcher stats reset.");
+        return true;
+    }
+
+    uint64 hits = sTerrainPrefetcher.GetHits();
+    uint64 misses = sTerrainPrefetcher.GetMisses();
+    uint64 loads = hits + misses;
+
+    PSendSysMessage("Tiles requested: " UI64FMTD ", queued: %u, expired unused: " UI64FMTD,
+        sTerrainPrefetcher.GetRequested(), sTerrainPrefetcher.GetQueued(), sTerrainPrefetcher.GetExpired());
+    PSendSysMessage("Grid loads: " UI64FMTD ", prefetched: " UI64FMTD " (%.1f%%), loaded on demand: " UI64FMTD,
+        loads, hits, loads ? float(hits) * 100.0f / loads : 0.0f, misses);
+    PSendSysMessage("Prefetched: avg link %u us, I/O moved off map threads " UI64FMTD " ms",
+        hits ? uint32(sTerrainPrefetcher.GetLinkTime() / hits) : 0, sTerrainPrefetcher.GetSavedTime() / 1000);
+    PSendSysMessage("On demand: avg stall %u us, max stall %u us",
+        misses ? uint32(sTerrainPrefetcher.GetStallTime() / misses) : 0, sTerrainPrefetcher.GetStallTimeMax());
+    return true;
+}
+
+// .server profile [seconds]
+bool ChatHandler::HandleServerProfileCommand(const char* args)
+{
+    uint32 seconds = *args ? atoi(args) : 10;
+    if (!seconds || seconds > 60)
+    {
+        SendSysMessage("Capture length must be between 1 and 60 seconds.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    if (!sProfiler.Start(seconds))
+    {
+        SendSysMessage("Profiler capture is already running.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Profiling next %u seconds, trace will be written to logs directory.", seconds);
+    return true;
+}
+
 bool ChatHandler::HandleServerShutDownCancelCommand(const char* /*args*/)
 {
     sWorld.ShutdownCancel();
@@ -6269,6 +6507,10 @@ bool ChatHandler::HandleInstanceStatsCommand(const char* /*args*/)
 {
     PSendSysMessage("instances loaded: %d", sMapMgr.GetNumInstances());
     PSendSysMessage("players in instances: %d", sMapMgr.GetNumPlayersInInstances());
+    PSendSysMessage("maps unloading: %u", sMapMgr.GetUnloadBacklog());
+    if (uint32 unloaded = sMapMgr.GetUnloadedMapsCount())
+        PSendSysMessage("maps unloaded: %u, teardown avg %.2f ms, max %.2f ms", unloaded,
+            float(sMapMgr.GetUnloadTimeTotal()) / unloaded / 1000.0f, float(sMapMgr.GetUnloadTimeMax()) / 1000.0f);
     PSendSysMessage("instance saves: %d", sInstanceSaveManager.GetNumInstanceSaves());
     PSendSysMessage("players bound: %d", sInstanceSaveManager.GetNumBoundPlayersTotal());
     PSendSysMessage("groups bound: %d", sInstanceSaveManager.GetNumBoundGroupsTotal());
@@ -1102,6 +1102,84 @@ void GameEventMgr::UpdateEventNPCVendor(uint16 event_id, bool activate)
     }
 }
 
+// quest removed from player on decoupled instance in its update
+class EventQuestRemoveCommand : public MapCommand
+{
+    public:
+        EventQuestRemoveCommand(uint64 guid, uint32 quest) : m_guid(guid), m_quest(quest) {}
+
+        void Execute(Map& map)
+        {
+            Player* player = ObjectAccessor::GetPlayer(m_guid);
+            if (player && player->GetMap() == &map)
+                GameEventMgr::RemoveEventQuest(player, m_quest);
+        }
+
+    private:
+        uint64 m_guid;
+        uint32 m_quest;
+};
+
+void GameEventMgr::RemoveEventQuest(Player* player, uint32 quest)
+{
+    if (player->IsInDecoupledUpdate() && !player->GetMap()->IsUpdateThread())
+    {
+        player->GetMap()->QueueCommand(new EventQuestRemoveCommand(player->GetGUID(), quest));
+        return;
+    }
+
+    if (player->GetQuestStatus(quest) != QUEST_STATUS_NONE)
+        player->SetQuestStatus(quest, QUEST_STATUS_NONE);
+}
+
+void GameEventMgr::QueueSpawnCommand(SpawnBatchMap& batches, int16 event_id, uint32 mapId, MapSpawnCommandType type, uint32 guid)
+{
+    SpawnBatchMap::iterator itr = batches.find(mapId);
+    if (itr == batches.end())
+    {
+        // objects of not created or instanced maps are loaded with their grids
+        Map* map = sMapMgr.FindMap(mapId);
+        MapSpawnBatch* batch = NULL;
+        if (map && !map->Instanceable())
+        {
+            batch = new MapSpawnBatch;
+            batch->eventId = event_id;
+        }
+
+        itr = batches.insert(SpawnBatchMap::value_type(mapId, std::make_pair(map, batch))).first;
+    }
+
+    if (MapSpawnBatch* batch = itr->second.second)
+        batch->commands.push_back(MapSpawnCommand(type, guid));
+}
+
+void GameEventMgr::QueueSpawnBatches(SpawnBatchMap& batches, int16 event_id, char const* action, uint64 start)
+{
+    uint32 commands = 0;
+    uint32 maps = 0;
+    for (SpawnBatchMap::iterator itr = batches.begin(); itr != batches.end(); ++itr)
+    {
+        MapSpawnBatch* batch = itr->second.second;
+        if (!batch)
+            continue;
+
+        if (batch->commands.empty())
+        {
+            delete batch;
+            continue;
+        }
+
+        commands += batch->commands.size();
+        ++maps;
+
+        batch->queued = WorldTimer::getMSTime();
+        itr->second.first->GetSpawnQueue().Queue(batch);
+    }
+
+    if (commands)
+        sLog.outString("GameEvent %i: %s queued %u commands for %u maps in %u us", event_id, action, commands, maps, uint32(WorldTimer::getUSTime() - start));
+}
+
 void GameEventMgr::GameEventSpawn(int16 event_id)
 {
     int32 internal_event_id = mGameEvent.size() + event_id - 1;
@@ -1112,6 +1190,9 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
         return;
     }
 
+    uint64 start = WorldTimer::getUSTime();
+    SpawnBatchMap batches;
+
     for (GuidList::iterator itr = mGameEventCreatureGuids[internal_event_id].begin();itr != mGameEventCreatureGuids[internal_event_id].end();++itr)
     {
         // Add to correct cell
@@ -1120,25 +1201,15 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
         {
             sObjectMgr.AddCreatureToGrid(*itr, data);
 
-            // Spawn if necessary (loaded grids only)
-            if (Map* map = const_cast<Map*>(sMapMgr.FindMap(data->mapid)))
-            {
-                if (!map->Instanceable() && map->IsLoaded(data->posX,data->posY))
-                {
-                    Creature* pCreature = new Creature;
-                    //sLog.outDebug("Spawning creature %u",*itr);
-                    if (!pCreature->LoadFromDB(*itr, map))
-                        delete pCreature;
-                    else
-                        map->Add(pCreature);
-                }
-            }
+            // Spawn if necessary (loaded grids only), done by the map in its update
+            QueueSpawnCommand(batches, event_id, data->mapid, MAP_SPAWN_CREATURE, *itr);
         }
     }
 
     if (internal_event_id < 0 || internal_event_id >= mGameEventGameobjectGuids.size())
     {
         sLog.outLog(LOG_DEFAULT, "ERROR: GameEventMgr::GameEventSpawn attempt access to out of range mGameEventGameobjectGuids element %i (size: %lu)",internal_event_id,mGameEventGameobjectGuids.size());
+        QueueSpawnBatches(batches, event_id, "spawn", start);
         return;
     }
 
@@ -1149,27 +1220,13 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
         if (data)
         {
             sObjectMgr.AddGameobjectToGrid(*itr, data);
-            // Spawn if necessary (loaded grids only)
-            // this base map checked as non-instanced and then only existed
-            // We use current coords to unspawn, not spawn coords since creature can have changed grid
-            if (Map* map = const_cast<Map*>(sMapMgr.FindMap(data->mapid)))
-            {
-                if (!map->Instanceable() && map->IsLoaded(data->posX, data->posY))
-                {
-                    GameObject* pGameobject = new GameObject;
-                    //sLog.outDebug("Spawning gameobject %u", *itr);
-                    if (!pGameobject->LoadFromDB(*itr, map))
-                        delete pGameobject;
-                    else
-                    {
-                        if (pGameobject->isSpawnedByDefault())
-                            map->Add(pGameobject);
-                    }
-                }
-            }
+
+            // Spawn if necessary (loaded grids only), done by the map in its update
+            QueueSpawnCommand(batches, event_id, data->mapid, MAP_SPAWN_GAMEOBJECT, *itr);
         }
     }
 
+    QueueSpawnBatches(batches, event_id, "spawn", start);
 }
 
 void GameEventMgr::GameEventUnspawn(int16 event_id)
@@ -1182,6 +1239,9 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
         return;
     }
 
+    uint64 start = WorldTimer::getUSTime();
+    SpawnBatchMap batches;
+
     for (GuidList::iterator itr = mGameEventCreatureGuids[internal_event_id].begin();itr != mGameEventCreatureGuids[internal_event_id].end();++itr)
     {
         // check if it's needed by another event, if so, don't remove
@@ -1193,15 +1253,14 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
         {
             sObjectMgr.RemoveCreatureFromGrid(*itr, data);
 
-            if (Map * tmpMap = sMapMgr.FindMap(data->mapid))
-                if (Creature * pCreature = tmpMap->GetCreature(MAKE_NEW_GUID(*itr, data->id, HIGHGUID_UNIT)))
-                    pCreature->AddObjectToRemoveList();
+            QueueSpawnCommand(batches, event_id, data->mapid, MAP_UNSPAWN_CREATURE, *itr);
         }
     }
 
     if (internal_event_id < 0 || internal_event_id >= mGameEventGameobjectGuids.size())
     {
         sLog.outLog(LOG_DEFAULT, "ERROR: GameEventMgr::GameEventUnspawn attempt access to out of range mGameEventGameobjectGuids element %i (size: %lu)",internal_event_id,mGameEventGameobjectGuids.size());
+        QueueSpawnBatches(batches, event_id, "unspawn", start);
         return;
     }
 
@@ -1215,12 +1274,11 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
         {
             sObjectMgr.RemoveGameobjectFromGrid(*itr, data);
 
-            Map * tmpMap = sMapMgr.FindMap(data->mapid);
-            if (tmpMap)
-                if (GameObject* pGameobject = tmpMap->GetGameObject(MAKE_NEW_GUID(*itr, data->id, HIGHGUID_GAMEOBJECT)))
-                    pGameobject->AddObjectToRemoveList();
+            QueueSpawnCommand(batches, event_id, data->mapid, MAP_UNSPAWN_GAMEOBJECT, *itr);
         }
     }
+
+    QueueSpawnBatches(batches, event_id, "unspawn", start);
 }
 
 void GameEventMgr::ChangeEquipOrModel(int16 event_id, bool activate)
@@ -1384,8 +1442,7 @@ void GameEventMgr::UpdateEventQuests(uint16 event_id, bool Activate)
                     RealmDataDatabase.PExecute("DELETE FROM character_queststatus WHERE quest = %u",itr->second);
                     HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
                     for (HashMapHolder<Player>::MapType::iterator pitr = m.begin(); pitr != m.end(); ++pitr)
-                        if (pitr->second->GetQuestStatus(itr->second) != QUEST_STATUS_NONE)
-                            pitr->second->SetQuestStatus(itr->second,QUEST_STATUS_NONE);
+                        RemoveEventQuest(pitr->second, itr->second);
                 }
                 // Remove the pair(id,quest) from the multimap
                 QuestRelations::iterator qitr = CreatureQuestMap.find(itr->first);
@@ -1418,8 +1475,7 @@ void GameEventMgr::UpdateEventQuests(uint16 event_id, bool Activate)
                     RealmDataDatabase.PExecute("DELETE FROM character_queststatus WHERE quest = %u",itr->second);
                     HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
                     for (HashMapHolder<Player>::MapType::iterator pitr = m.begin(); pitr != m.end(); ++pitr)
-                        if (pitr->second->GetQuestStatus(itr->second) != QUEST_STATUS_NONE)
-                            pitr->second->SetQuestStatus(itr->second,QUEST_STATUS_NONE);
+                        RemoveEventQuest(pitr->second, itr->second);
                 }
                 // Remove the pair(id,quest) from the multimap
                 QuestRelations::iterator qitr = GameObjectQuestMap.find(itr->first);
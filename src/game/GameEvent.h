@@ -26,6 +26,7 @@
 #include "Common.h"
 #include "SharedDefines.h"
 #include "Platform/Define.h"
+#include "MapSpawnQueue.h"
 
 #define max_ge_check_delay 86400                            // 1 day in seconds
 
@@ -120,6 +121,8 @@ class GameEventMgr
         void HandleWorldEventGossip(Player * plr, Creature * c);
         uint32 GetNPCFlag(Creature * cr);
         uint32 GetNpcTextId(uint32 guid);
+        // world thread, player on decoupled instance loses the quest in its update
+        static void RemoveEventQuest(Player* player, uint32 quest);
     private:
         void SendWorldStateUpdate(Player * plr, uint16 event_id);
         void AddActiveEvent(uint16 event_id) { m_ActiveEvents.insert(event_id); }
@@ -128,6 +131,10 @@ class GameEventMgr
         void UnApplyEvent(uint16 event_id);
         void GameEventSpawn(int16 event_id);
         void GameEventUnspawn(int16 event_id);
+        // per map batches of one GameEventSpawn or GameEventUnspawn call, map id -> map, batch (NULL if map not spawned now)
+        typedef std::map<uint32, std::pair<Map*, MapSpawnBatch*> > SpawnBatchMap;
+        void QueueSpawnCommand(SpawnBatchMap& batches, int16 event_id, uint32 mapId, MapSpawnCommandType type, uint32 guid);
+        void QueueSpawnBatches(SpawnBatchMap& batches, int16 event_id, char const* action, uint64 start);
         void ChangeEquipOrModel(int16 event_id, bool activate);
         void UpdateEventQuests(uint16 event_id, bool Activate);
         void UpdateEventNPCFlags(uint16 event_id);
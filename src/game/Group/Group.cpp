@@ -820,6 +820,18 @@ void Group::Update(uint32 diff)
     }
 }
 
+bool Group::HasMemberInDecoupledUpdate()
+{
+    for (GroupReference* itr = GetFirstMember(); itr != NULL; itr = itr->next())
+    {
+        Player* member = itr->getSource();
+        if (member && member->IsInDecoupledUpdate())
+            return true;
+    }
+
+    return false;
+}
+
 void Group::UpdatePlayerOutOfRange(Player* pPlayer)
 {
     if (!pPlayer || !pPlayer->IsInWorld())
@@ -1540,6 +1552,18 @@ void Roll::targetObjectBuildLink()
     getTarget()->addLootValidatorRef(this);
 }
 
+bool Roll::IsInDecoupledUpdate() const
+{
+    for (PlayerVote::const_iterator itr = playerVote.begin(); itr != playerVote.end(); ++itr)
+    {
+        Player* player = ObjectAccessor::GetPlayer(itr->first);
+        if (player && player->IsInDecoupledUpdate())
+            return true;
+    }
+
+    return false;
+}
+
 void Roll::SendLootStartRoll(uint32 CountDown)
 {
     WorldPacket data(SMSG_LOOT_START_ROLL, (8 + 4 + 4 + 4 + 4 + 4));
@@ -134,6 +134,8 @@ class Roll : public LootValidatorRef
         void SendLootRollWon(const uint64& SourceGuid, const uint64& TargetGuid, uint8 RollNumber, uint8 RollType);
         void SendLootAllPassed();
         void CountTheRoll();
+        // a voter is on decoupled instance that is still updating
+        bool IsInDecoupledUpdate() const;
         bool CountRollVote(const uint64& playerGUID, uint8 Choice);
 
         uint64 itemGUID;
@@ -324,6 +326,8 @@ class Group
         void SendTargetIconList(WorldSession *session);
         void SendUpdate();
         void Update(uint32 diff);
+        // world thread must not change members while one is on decoupled instance that is still updating
+        bool HasMemberInDecoupledUpdate();
         void UpdatePlayerOutOfRange(Player* pPlayer);
                                                             // ignore: GUID of player that will be ignored
         void BroadcastPacket(WorldPacket *packet, bool ignorePlayersInBGRaid, int group=-1, uint64 ignore=0);
@@ -50,6 +50,7 @@
 #include "AccountMgr.h"
 #include "Group.h"
 #include "GuildMgr.h"
+#include "WhoListCache.h"
 
 void WorldSession::HandleRepopRequestOpcode(WorldPacket & /*recv_data*/)
 {
@@ -75,6 +76,108 @@ void WorldSession::HandleRepopRequestOpcode(WorldPacket & /*recv_data*/)
     GetPlayer()->RepopAtGraveyard();
 }
 
+// CMSG_WHO request checked against WhoListCache entries
+struct WhoListFilter
+{
+    Player* player;
+    uint32 team;
+    bool seeAll;
+    bool allowTwoSide;
+    bool gmInWhoList;
+    bool arenaZone;
+    uint32 levelMin;
+    uint32 levelMax;
+    uint32 raceMask;
+    uint32 classMask;
+    uint32 const* zones;
+    uint32 zonesCount;
+    std::wstring const* name;
+    std::wstring const* guild;
+    std::wstring const* strings;
+    uint32 stringsCount;
+    LocaleConstant locale;
+
+    // same rules as Player::IsVisibleGloballyfor
+    bool IsVisible(WhoListEntry const& entry) const
+    {
+        if (entry.guid == player->GetGUID())
+            return true;
+
+        if (entry.visibility == VISIBILITY_ON)
+            return true;
+
+        if (player->GetSession()->HasHigherGMLevel(SEC_DEVELOPER))
+            return entry.gmLevel <= player->GetSession()->GetGMLevel();
+
+        return entry.visibility != VISIBILITY_OFF;
+    }
+
+    // appends entry to SMSG_WHO if it passes
+    bool Match(WhoListEntry const& entry, WorldPacket& data) const
+    {
+        if (!seeAll)
+        {
+            // player can see member of other team only if CONFIG_ALLOW_TWO_SIDE_WHO_LIST
+            if (entry.team != team && !allowTwoSide)
+                return false;
+
+            // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
+            if (entry.gmLevel >= SEC_GAMEMASTER && !gmInWhoList)
+                return false;
+        }
+
+        if (entry.level < levelMin || entry.level > levelMax)
+            return false;
+
+        if (!(classMask & (1 << entry.class_)) || !(raceMask & (1 << entry.race)))
+            return false;
+
+        if (!IsVisible(entry))
+            return false;
+
+        uint32 zoneId = arenaZone ? entry.arenaZoneId : entry.zoneId;
+        if (zonesCount && std::find(zones, zones + zonesCount, zoneId) == zones + zonesCount)
+            return false;
+
+        if (!(name->empty() || entry.lowerName.find(*name) != std::wstring::npos))
+            return false;
+
+        if (!(guild->empty() || entry.lowerGuildName.find(*guild) != std::wstring::npos))
+            return false;
+
+        std::string areaName;
+        if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(zoneId))
+            areaName = areaEntry->area_name[locale];
+
+        bool show = true;
+        for (uint32 i = 0; i < stringsCount; i++)
+        {
+            if (!strings[i].empty())
+            {
+                if (entry.lowerGuildName.find(strings[i]) != std::wstring::npos ||
+                    entry.lowerName.find(strings[i]) != std::wstring::npos ||
+                    Utf8FitTo(areaName, strings[i]))
+                {
+                    show = true;
+                    break;
+                }
+                show = false;
+            }
+        }
+        if (!show)
+            return false;
+
+        data << entry.name;                                 // player name
+        data << entry.guildName;                            // guild name
+        data << uint32(entry.level);                        // player level
+        data << uint32(entry.class_);                       // player class
+        data << uint32(entry.race);                         // player race
+        data << uint8(entry.gender);                        // player gender
+        data << uint32(zoneId);                             // player zone id
+        return true;
+    }
+};
+
 void WorldSession::HandleWhoOpcode(WorldPacket & recv_data)
 {
     CHECK_PACKET_SIZE(recv_data,4+4+1+1+4+4+4+4);
@@ -157,130 +260,70 @@ void WorldSession::HandleWhoOpcode(WorldPacket & recv_data)
     if (level_max >= MAX_LEVEL)
         level_max = STRONG_MAX_LEVEL;
 
-    uint32 team = _player->GetTeam();
-    bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_ALLOW_TWO_SIDE_WHO_LIST);
-    bool gmInWhoList         = sWorld.getConfig(CONFIG_GM_IN_WHO_LIST);
+    WhoListFilter filter;
+    filter.player = _player;
+    filter.team = _player->GetTeam();
+    filter.seeAll = HasHigherGMLevel(SEC_DEVELOPER);
+    filter.allowTwoSide = sWorld.getConfig(CONFIG_ALLOW_TWO_SIDE_WHO_LIST);
+    filter.gmInWhoList = sWorld.getConfig(CONFIG_GM_IN_WHO_LIST);
+    filter.arenaZone = !GetPlayer()->IsGameMaster() && sWorld.getConfig(CONFIG_ENABLE_FAKE_WHO_ON_ARENA);
+    filter.levelMin = level_min;
+    filter.levelMax = level_max;
+    filter.raceMask = racemask;
+    filter.classMask = classmask;
+    filter.zones = zoneids;
+    filter.zonesCount = zones_count;
+    filter.name = &wplayer_name;
+    filter.guild = &wguild_name;
+    filter.strings = str;
+    filter.stringsCount = str_count;
+    filter.locale = GetSessionDbcLocale();
 
     WorldPacket data(SMSG_WHO, 50);                         // guess size
     data << clientcount;                                    // clientcount place holder
     data << clientcount;                                    // clientcount place holder
 
-    ACE_GUARD(ACE_Thread_Mutex, guard, *HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (HashMapHolder<Player>::MapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-    {
-        if (!HasHigherGMLevel(SEC_DEVELOPER))
-        {
-            // player can see member of other team only if CONFIG_ALLOW_TWO_SIDE_WHO_LIST
-            if (itr->second->GetTeam() != team && !allowTwoSideWhoList)
-                continue;
-
-            // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
-            if (itr->second->GetSession()->HasHigherGMLevel(SEC_GAMEMASTER) && !gmInWhoList)
-                continue;
-        }
-
-        //do not process players which are not in world
-        if (!itr->second->IsInWorld())
-            continue;
-
-        // check if target is globally visible for player
-        if (!itr->second->IsVisibleGloballyfor(_player))
-            continue;
-
-        // check if target's level is in level range
-        uint32 lvl = itr->second->GetLevel();
-        if (lvl < level_min || lvl > level_max)
-            continue;
+    // 49 is maximum player count sent to client - can be overridden
+    // through config, but is unstable, 0 means no limit
+    uint32 maxCount = sWorld.getConfig(CONFIG_MAX_WHO);
+    if (!maxCount)
+        maxCount = 0xFFFFFFFF;
 
-        // check if class matches classmask
-        uint32 class_ = itr->second->GetClass();
-        if (!(classmask & (1 << class_)))
-            continue;
-
-        // check if race matches racemask
-        uint32 race = itr->second->GetRace();
-        if (!(racemask & (1 << race)))
-            continue;
-
-        uint32 pzoneid = itr->second->GetCachedZone();
-        if (!GetPlayer()->IsGameMaster() && sWorld.getConfig(CONFIG_ENABLE_FAKE_WHO_ON_ARENA))
+    // served from copy of online players, it may be few seconds old
+    if (WhoListSnapshotPtr snapshot = sWhoListCache.GetSnapshot())
+    {
+        std::vector<WhoListEntry> const& entries = snapshot->entries;
+        if (zones_count)
         {
-            if (itr->second->InArena())
+            for (uint32 i = 0; i < zones_count && clientcount != maxCount; ++i)
             {
-                Player *pPlayer = itr->second;
-                pzoneid = sTerrainMgr.GetZoneId(pPlayer->GetBattleGroundEntryPointMap(), pPlayer->GetBattleGroundEntryPointX(), pPlayer->GetBattleGroundEntryPointY(), pPlayer->GetBattleGroundEntryPointZ());
-            }
-        }
+                // client may send same zone twice
+                if (std::find(zoneids, zoneids + i, zoneids[i]) != zoneids + i)
+                    continue;
 
-        uint8 gender = itr->second->getGender();
+                WhoListSnapshot::IndexList const* zone = snapshot->GetZone(zoneids[i], filter.arenaZone);
+                if (!zone)
+                    continue;
 
-        bool z_show = true;
-        for (uint32 i = 0; i < zones_count; i++)
-        {
-            if (zoneids[i] == pzoneid)
-            {
-                z_show = true;
-                break;
+                for (WhoListSnapshot::IndexList::const_iterator itr = zone->begin(); itr != zone->end() && clientcount != maxCount; ++itr)
+                    if (filter.Match(entries[*itr], data))
+                        ++clientcount;
             }
-
-            z_show = false;
         }
-        if (!z_show)
-            continue;
-
-        std::string pname = itr->second->GetName();
-        std::wstring wpname;
-        if (!Utf8toWStr(pname,wpname))
-            continue;
-        wstrToLower(wpname);
-
-        if (!(wplayer_name.empty() || wpname.find(wplayer_name) != std::wstring::npos))
-            continue;
-
-        std::string gname = sGuildMgr.GetGuildNameById(itr->second->GetGuildId());
-        std::wstring wgname;
-        if (!Utf8toWStr(gname,wgname))
-            continue;
-        wstrToLower(wgname);
-
-        if (!(wguild_name.empty() || wgname.find(wguild_name) != std::wstring::npos))
-            continue;
-
-        std::string aname;
-        if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(pzoneid))
-            aname = areaEntry->area_name[GetSessionDbcLocale()];
-
-        bool s_show = true;
-        for (uint32 i = 0; i < str_count; i++)
+        else
         {
-            if (!str[i].empty())
+            for (uint32 teamIndex = 0; teamIndex < WHO_LIST_TEAMS && clientcount != maxCount; ++teamIndex)
             {
-                if (wgname.find(str[i]) != std::wstring::npos ||
-                    wpname.find(str[i]) != std::wstring::npos ||
-                    Utf8FitTo(aname, str[i]))
-                {
-                    s_show = true;
-                    break;
-                }
-                s_show = false;
+                if (!filter.seeAll && !filter.allowTwoSide && teamIndex != WhoListSnapshot::GetTeamIndex(filter.team))
+                    continue;
+
+                uint32 begin, end;
+                snapshot->GetLevelRange(teamIndex, level_min, level_max, begin, end);
+                for (uint32 i = begin; i < end && clientcount != maxCount; ++i)
+                    if (filter.Match(entries[i], data))
+                        ++clientcount;
             }
         }
-        if (!s_show)
-            continue;
-
-        data << pname;                                  // player name
-        data << gname;                                  // guild name
-        data << uint32(lvl);                            // player level
-        data << uint32(class_);                         // player class
-        data << uint32(race);                           // player race
-        data << uint8(gender);                          // player gender
-        data << uint32(pzoneid);                        // player zone id
-
-        // 49 is maximum player count sent to client - can be overridden
-        // through config, but is unstable
-        if ((++clientcount) == sWorld.getConfig(CONFIG_MAX_WHO))
-            break;
     }
 
     data.put(0, clientcount);                //insert right count
@@ -628,6 +671,8 @@ void WorldSession::HandleAddIgnoreOpcodeCallBack(QueryResultAutoPtr result, uint
                     // ignore list full
                     if (!session->GetPlayer()->GetSocial()->AddToSocialList(GUID_LOPART(IgnoreGuid), true))
                         ignoreResult = FRIEND_IGNORE_FULL;
+                    else
+                        session->GetPlayer()->ChannelIgnoreChanged(GUID_LOPART(IgnoreGuid), true);
                 }
             }
         }
@@ -649,6 +694,7 @@ void WorldSession::HandleDelIgnoreOpcode(WorldPacket & recv_data)
     recv_data >> IgnoreGUID;
 
     _player->GetSocial()->RemoveFromSocialList(GUID_LOPART(IgnoreGUID), true);
+    _player->ChannelIgnoreChanged(GUID_LOPART(IgnoreGUID), false);
 
     sSocialMgr.SendFriendStatus(GetPlayer(), FRIEND_IGNORE_REMOVED, GUID_LOPART(IgnoreGUID), false);
 
@@ -36,6 +36,25 @@
 #include "Language.h"
 #include "Spell.h"
 
+// ends transfer into decoupled instance on its update thread
+class WorldportAckCommand : public MapCommand
+{
+    public:
+        WorldportAckCommand(WorldSession* session, WorldLocation const& oldLoc, bool resetNotify)
+            : m_session(session), m_oldLoc(oldLoc), m_resetNotify(resetNotify) {}
+
+        void Execute(Map& /*map*/)
+        {
+            m_session->FinishWorldportAck(m_oldLoc, m_resetNotify);
+            m_session->SetMapTransferPending(false);
+        }
+
+    private:
+        WorldSession* m_session;                            // kept by world thread while transfer is pending
+        WorldLocation m_oldLoc;
+        bool m_resetNotify;
+};
+
 void WorldSession::HandleMoveWorldportAckOpcode(WorldPacket & /*recv_data*/)
 {
     sLog.outDebug("WORLD: got MSG_MOVE_WORLDPORT_ACK.");
@@ -110,6 +129,23 @@ void WorldSession::HandleMoveWorldportAckOpcode()
     bool reset_notify = (GetPlayer()->GetBoundInstance(GetPlayer()->GetMapId(), GetPlayer()->GetDifficulty()) == NULL);
 
     GetPlayer()->SendInitialPacketsBeforeAddToMap();
+
+    // decoupled instance may be updating now, it adds the player in its own update
+    if (map->IsDecoupled())
+    {
+        SetMapTransferPending(true);
+        map->QueueCommand(new WorldportAckCommand(this, old_loc, reset_notify));
+        return;
+    }
+
+    FinishWorldportAck(old_loc, reset_notify);
+}
+
+void WorldSession::FinishWorldportAck(WorldLocation const& old_loc, bool reset_notify)
+{
+    MapEntry const* mEntry = sMapStore.LookupEntry(GetPlayer()->GetMapId());
+    InstanceTemplate const* mInstance = ObjectMgr::GetInstanceTemplate(GetPlayer()->GetMapId());
+
     // the CanEnter checks are done in TeleporTo but conditions may change
     // while the player is in transit, for example the map may get full
     if (!GetPlayer()->GetMap()->Add(GetPlayer()))
@@ -65,17 +65,17 @@ void WorldSession::SendNameQueryOpcodeFromDB(uint64 guid)
     RealmDataDatabase.AsyncPQuery(&WorldSession::SendNameQueryOpcodeFromDBCallBack, GetAccountId(),
         !sWorld.getConfig(CONFIG_DECLINED_NAMES_USED) ?
     //   ------- Query Without Declined Names --------
-    //          0                1     2
-        "SELECT guid, name, SUBSTRING(data, LENGTH(SUBSTRING_INDEX(data, ' ', '%u'))+2, LENGTH(SUBSTRING_INDEX(data, ' ', '%u')) - LENGTH(SUBSTRING_INDEX(data, ' ', '%u'))-1) "
+    //          0     1     2     3       4
+        "SELECT guid, name, race, gender, class "
         "FROM characters WHERE guid = '%u'"
         :
     //   --------- Query With Declined Names ---------
-    //          0                1     2
-        "SELECT characters.guid, name, SUBSTRING(data, LENGTH(SUBSTRING_INDEX(data, ' ', '%u'))+2, LENGTH(SUBSTRING_INDEX(data, ' ', '%u')) - LENGTH(SUBSTRING_INDEX(data, ' ', '%u'))-1), "
-    //   3         4       5           6             7
+    //          0                1     2     3       4
+        "SELECT characters.guid, name, race, gender, class, "
+    //   5         6       7           8             9
         "genitive, dative, accusative, instrumental, prepositional "
         "FROM characters LEFT JOIN character_declinedname ON characters.guid = character_declinedname.guid WHERE characters.guid = '%u'",
-        UNIT_FIELD_BYTES_0, UNIT_FIELD_BYTES_0+1, UNIT_FIELD_BYTES_0, GUID_LOPART(guid));
+        GUID_LOPART(guid));
 }
 
 void WorldSession::SendNameQueryOpcodeFromDBCallBack(QueryResultAutoPtr result, uint32 accountId)
@@ -90,26 +90,32 @@ void WorldSession::SendNameQueryOpcodeFromDBCallBack(QueryResultAutoPtr result,
     Field *fields = result->Fetch();
     uint32 guid      = fields[0].GetUInt32();
     std::string name = fields[1].GetCppString();
-    uint32 field     = 0;
+    uint32 race      = 0;
+    uint32 gender    = 0;
+    uint32 class_    = 0;
     if (name == "")
         name         = session->GetMangosString(LANG_NON_EXIST_CHARACTER);
     else
-        field        = fields[2].GetUInt32();
+    {
+        race         = fields[2].GetUInt32();
+        gender       = fields[3].GetUInt32();
+        class_       = fields[4].GetUInt32();
+    }
 
                                                         // guess size
     WorldPacket data(SMSG_NAME_QUERY_RESPONSE, (8+1+4+4+4+10));
     data << MAKE_NEW_GUID(guid, 0, HIGHGUID_PLAYER);
     data << name;
     data << (uint8)0;
-    data << (uint32)(field & 0xFF);
-    data << (uint32)((field >> 16) & 0xFF);
-    data << (uint32)((field >> 8) & 0xFF);
+    data << race;
+    data << gender;
+    data << class_;
 
-    // if the first declined name field (3) is empty, the rest must be too
-    if (sWorld.getConfig(CONFIG_DECLINED_NAMES_USED) && fields[3].GetCppString() != "")
+    // if the first declined name field (5) is empty, the rest must be too
+    if (sWorld.getConfig(CONFIG_DECLINED_NAMES_USED) && fields[5].GetCppString() != "")
     {
         data << (uint8)1;                                   // is declined
-        for (int i = 3; i < MAX_DECLINED_NAME_CASES+3; ++i)
+        for (int i = 5; i < MAX_DECLINED_NAME_CASES+5; ++i)
             data << fields[i].GetCppString();
     }
     else
@@ -538,6 +538,27 @@ void InstanceSaveManager::_ResetSave(InstanceSaveHashMap::iterator &itr)
     lock_instLists = false;
 }
 
+// reset or reset warning of decoupled instance, done in its update
+class InstanceResetCommand : public MapCommand
+{
+    public:
+        InstanceResetCommand(bool warn, uint8 method, uint32 timeLeft) : m_warn(warn), m_method(method), m_timeLeft(timeLeft) {}
+
+        void Execute(Map& map)
+        {
+            InstanceMap& instance = (InstanceMap&)map;
+            if (m_warn)
+                instance.SendResetWarnings(m_timeLeft);
+            else
+                instance.Reset(m_method);
+        }
+
+    private:
+        bool m_warn;
+        uint8 m_method;
+        uint32 m_timeLeft;
+};
+
 void InstanceSaveManager::_ResetInstance(uint32 mapid, uint32 instanceId)
 {
     sLog.outDebug("InstanceSaveMgr::_ResetInstance %u, %u", mapid, instanceId);
@@ -559,7 +580,9 @@ void InstanceSaveManager::_ResetInstance(uint32 mapid, uint32 instanceId)
     DeleteInstanceFromDB(instanceId);                       // even if save not loaded
 
     Map * iMap = sMapMgr.FindMap(mapid, instanceId);
-    if (iMap && iMap->IsDungeon())
+    if (iMap && iMap->IsDecoupled())
+        iMap->QueueCommand(new InstanceResetCommand(false, INSTANCE_RESET_RESPAWN_DELAY, 0));
+    else if (iMap && iMap->IsDungeon())
         ((InstanceMap*)iMap)->Reset(INSTANCE_RESET_RESPAWN_DELAY);
     else
         sObjectMgr.DeleteRespawnTimeForInstance(instanceId);// even if map is not loaded
@@ -623,7 +646,9 @@ void InstanceSaveManager::_ResetOrWarnAll(uint32 mapid, bool warn, uint32 timeLe
         if(map2->GetId() != mapid)
             break;
 
-        if (warn)
+        if (map2->IsDecoupled())
+            map2->QueueCommand(new InstanceResetCommand(warn, INSTANCE_RESET_GLOBAL, timeLeft));
+        else if (warn)
             ((InstanceMap*)map2)->SendResetWarnings(timeLeft);
         else
             ((InstanceMap*)map2)->Reset(INSTANCE_RESET_GLOBAL);
@@ -23,6 +23,7 @@
 #include "MapManager.h"
 #include "World.h"
 #include "Database/DatabaseEnv.h"
+#include "Profiler.h"
 
 #include <ace/Guard_T.h>
 #include <ace/Method_Request.h>
@@ -62,26 +63,50 @@ class MapUpdateRequest : public ACE_Method_Request
     public:
         Map& m_map;
         MapUpdater& m_updater;
-        ACE_UINT32 m_diff;
+        ACE_UINT32 m_diff;                                  // grid count for MAP_UPDATE_UNLOAD
+        MapUpdateType m_type;
 
-        MapUpdateRequest(Map& m, MapUpdater& u, ACE_UINT32 d) : m_map(m), m_updater(u), m_diff(d) {}
+        MapUpdateRequest(Map& m, MapUpdater& u, ACE_UINT32 d, MapUpdateType type) : m_map(m), m_updater(u), m_diff(d), m_type(type) {}
 
         virtual int call(void)
         {
             m_updater.register_thread(ACE_OS::thr_self(), m_map.GetId(), m_map.GetInstanceId());
 
-            if (!m_map.IsBroken())
-                m_map.Update(m_diff);
-            else
-                m_map.ForcedUnload();
+            uint32 mapId = m_map.GetId();
+            {
+                ProfileZone zone("MapUpdateRequest");
+                if (m_type == MAP_UPDATE_UNLOAD)
+                {
+                    ProfileZone unloadZone("Map::UnloadGrids");
+                    m_map.UnloadGrids(m_diff);
+                }
+                else if (m_type == MAP_UPDATE_DELAYED)
+                    m_map.DelayedUpdate(m_diff);
+                else if (m_map.IsBroken())
+                    m_map.ForcedUnload();
+                else if (m_type == MAP_UPDATE_DECOUPLED)
+                {
+                    m_map.SetUpdateThread(true);
+                    m_map.Update(m_diff);
+                    m_map.DelayedUpdate(m_diff);
+                    m_map.SetUpdateThread(false);
+                }
+                else
+                    m_map.Update(m_diff);
+            }
 
             m_updater.unregister_thread(ACE_OS::thr_self());
-            m_updater.update_finished(m_map.GetId());
+
+            // world thread may unload the map as soon as it is not updating
+            if (m_type == MAP_UPDATE_DECOUPLED)
+                m_map.EndDecoupledUpdate();
+
+            m_updater.update_finished(mapId, m_type);
             return 0;
         }
 };
 
-MapUpdater::MapUpdater() : m_mutex(), m_condition(m_mutex), m_executor(), pending_requests(0)
+MapUpdater::MapUpdater() : m_mutex(), m_condition(m_mutex), m_executor(), pending_requests(0), decoupled_requests(0)
 {
     freezeDetectTime = sWorld.getConfig(CONFIG_VMSS_FREEZEDETECTTIME);
 }
@@ -98,7 +123,7 @@ int MapUpdater::activate(size_t num_threads)
 
 int MapUpdater::deactivate(void)
 {
-    this->wait();
+    this->wait_decoupled();
 
     return this->m_executor.deactivate();
 }
@@ -113,17 +138,55 @@ int MapUpdater::wait()
     return 0;
 }
 
+int MapUpdater::wait_decoupled()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex,guard,this->m_mutex,-1);
+
+    while (this->pending_requests > 0 || this->decoupled_requests > 0)
+        this->m_condition.wait();
+
+    return 0;
+}
+
 int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
+{
+    return schedule(map, diff, MAP_UPDATE_REGULAR);
+}
+
+int MapUpdater::schedule_delayed_update(Map& map, ACE_UINT32 diff)
+{
+    return schedule(map, diff, MAP_UPDATE_DELAYED);
+}
+
+int MapUpdater::schedule_unload(Map& map, ACE_UINT32 grids)
+{
+    return schedule(map, grids, MAP_UPDATE_UNLOAD);
+}
+
+int MapUpdater::schedule_decoupled_update(Map& map, ACE_UINT32 diff)
+{
+    map.BeginDecoupledUpdate();
+    if (schedule(map, diff, MAP_UPDATE_DECOUPLED) == -1)
+    {
+        map.EndDecoupledUpdate();
+        return -1;
+    }
+
+    return 0;
+}
+
+int MapUpdater::schedule(Map& map, ACE_UINT32 diff, MapUpdateType type)
 {
     ACE_GUARD_RETURN(ACE_Thread_Mutex,guard,this->m_mutex,-1);
 
-    ++this->pending_requests;
+    size_t& requests = type == MAP_UPDATE_DECOUPLED ? this->decoupled_requests : this->pending_requests;
+    ++requests;
 
-    if (this->m_executor.execute(new MapUpdateRequest(map,*this,diff)) == -1)
+    if (this->m_executor.execute(new MapUpdateRequest(map,*this,diff,type)) == -1)
     {
         ACE_DEBUG((LM_ERROR, ACE_TEXT ("(%t) \n"), ACE_TEXT ("Failed to schedule Map Update")));
 
-        --this->pending_requests;
+        --requests;
         return -1;
     }
 
@@ -135,19 +198,21 @@ bool MapUpdater::activated()
     return m_executor.activated();
 }
 
-void MapUpdater::update_finished(uint32 map)
+void MapUpdater::update_finished(uint32 map, MapUpdateType type)
 {
     ACE_GUARD(ACE_Thread_Mutex, guard, this->m_mutex);
 
-    this->lastMapId = map;
+    size_t& requests = type == MAP_UPDATE_DECOUPLED ? this->decoupled_requests : this->pending_requests;
+    if (type != MAP_UPDATE_DECOUPLED)
+        this->lastMapId = map;
 
-    if (this->pending_requests == 0)
+    if (requests == 0)
     {
         ACE_ERROR ((LM_ERROR, ACE_TEXT("(%t)\n"), ACE_TEXT("MapUpdater::update_finished BUG, report to devs")));
         return;
     }
 
-    --this->pending_requests;
+    --requests;
 
     //TODO can more than one thread call wait (), it shouldnt happen
     //however I ensure if in future more than 1 thread call it by
@@ -45,6 +45,14 @@ struct MapUpdateInfo
 
 typedef std::map<ACE_thread_t const, MapUpdateInfo> ThreadMapMap;
 
+enum MapUpdateType
+{
+    MAP_UPDATE_REGULAR  = 0,
+    MAP_UPDATE_DELAYED  = 1,                                // Map::DelayedUpdate
+    MAP_UPDATE_UNLOAD   = 2,                                // unload some grids of map removed from MapManager
+    MAP_UPDATE_DECOUPLED = 3                                // Map::Update and DelayedUpdate of decoupled map, not waited for
+};
+
 class MapUpdater
 {
     public:
@@ -58,9 +66,25 @@ class MapUpdater
         /// it may even start before the call returns
         int schedule_update(Map& map, ACE_UINT32 diff);
 
+        /// schedule Map::DelayedUpdate, callers must wait() for
+        /// all regular updates before scheduling delayed ones
+        int schedule_delayed_update(Map& map, ACE_UINT32 diff);
+
+        /// schedule unloading of up to grids grids of map that was
+        /// already removed from MapManager, same rules as delayed updates
+        int schedule_unload(Map& map, ACE_UINT32 grids);
+
+        /// schedule Map::Update followed by Map::DelayedUpdate of decoupled
+        /// map, wait() does not wait for it, the map is marked as updating
+        /// until the update finishes
+        int schedule_decoupled_update(Map& map, ACE_UINT32 diff);
+
         /// Wait until all pending updates finish
         int wait();
 
+        /// Wait until decoupled updates finish too
+        int wait_decoupled();
+
         /// Start the worker threads
         int activate(size_t num_threads);
 
@@ -68,7 +92,7 @@ class MapUpdater
         int deactivate(void);
 
         bool activated();
-        void update_finished(uint32 map);
+        void update_finished(uint32 map, MapUpdateType type);
 
         void register_thread(ACE_thread_t const threadId, uint32 mapId, uint32 instanceId);
         void unregister_thread(ACE_thread_t const threadId);
@@ -79,6 +103,8 @@ class MapUpdater
 
         uint32 GetLastMapId() { return lastMapId; };
     private:
+        int schedule(Map& map, ACE_UINT32 diff, MapUpdateType type);
+
         ThreadMapMap m_threads;
 
         uint32 freezeDetectTime;
@@ -87,6 +113,7 @@ class MapUpdater
         ACE_Condition_Thread_Mutex m_condition;
         ACE_Thread_Mutex m_mutex;
         size_t pending_requests;
+        size_t decoupled_requests;
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
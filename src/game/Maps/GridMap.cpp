@@ -28,6 +28,7 @@
 #include "GridMap.h"
 #include "VMapFactory.h"
 #include "MoveMap.h"
+#include "TerrainPrefetcher.h"
 #include "World.h"
 #include "Database/DatabaseEnv.h"
 
@@ -991,22 +992,36 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
         if(!m_GridMaps[x][y])
         {
-            GridMap * map = new GridMap();
+            uint64 loadStart = WorldTimer::getUSTime();
 
-            // map file name
-            char *tmp=NULL;
-            int len = sWorld.GetDataPath().length()+strlen("maps/%03u%02u%02u.map")+1;
-            tmp = new char[len];
-            snprintf(tmp, len, (char *)(sWorld.GetDataPath()+"maps/%03u%02u%02u.map").c_str(),m_mapId, x, y);
-            sLog.outDetail("Loading map %s",tmp);
+            // tile read ahead by I/O thread, we only link it
+            PrefetchedTile* prefetched = sTerrainPrefetcher.Take(m_mapId, x, y);
 
-            if(!map->loadData(tmp))
+            GridMap * map;
+            if (prefetched && prefetched->gridMap)
             {
-                sLog.outLog(LOG_DEFAULT, "ERROR: Error load map file: \n %s\n", tmp);
-                //ASSERT(false);
+                map = prefetched->gridMap;
+                prefetched->gridMap = NULL;
+            }
+            else
+            {
+                map = new GridMap();
+
+                // map file name
+                char *tmp=NULL;
+                int len = sWorld.GetDataPath().length()+strlen("maps/%03u%02u%02u.map")+1;
+                tmp = new char[len];
+                snprintf(tmp, len, (char *)(sWorld.GetDataPath()+"maps/%03u%02u%02u.map").c_str(),m_mapId, x, y);
+                sLog.outDetail("Loading map %s",tmp);
+
+                if(!map->loadData(tmp))
+                {
+                    sLog.outLog(LOG_DEFAULT, "ERROR: Error load map file: \n %s\n", tmp);
+                    //ASSERT(false);
+                }
+
+                delete [] tmp;
             }
-
-            delete [] tmp;
 
             //load VMAPs for current map/grid...
             const MapEntry * i_mapEntry = sMapStore.LookupEntry(m_mapId);
@@ -1025,9 +1040,18 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
                 break;
             }
 
-            MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y);
+            MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y, prefetched ? &prefetched->mmap : NULL);
 
             m_GridMaps[x][y] = map;
+
+            uint32 loadTime = uint32(WorldTimer::getUSTime() - loadStart);
+            if (prefetched)
+            {
+                sTerrainPrefetcher.RecordHit(loadTime, prefetched->loadTime);
+                delete prefetched;
+            }
+            else if (sTerrainPrefetcher.IsActive())
+                sTerrainPrefetcher.RecordMiss(loadTime);
         }
     }
 
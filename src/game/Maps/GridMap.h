@@ -271,6 +271,9 @@ class TerrainInfo : public Referencable<AtomicLong>
         bool IsLineOfSightEnabled() const;
         bool IsPathFindingEnabled() const;
 
+        // unlocked check, result may be stale by the time it's used
+        bool IsGridLoaded(uint32 x, uint32 y) const { return m_GridMaps[x][y] != NULL; }
+
     protected:
         friend class Map;
         //load/unload terrain data
@@ -24,6 +24,7 @@
 #include "GridNotifiers.h"
 #include "WorldSession.h"
 #include "Log.h"
+#include "Profiler.h"
 #include "GridStates.h"
 #include "CellImpl.h"
 #include "InstanceData.h"
@@ -43,6 +44,7 @@
 #include "InstanceSaveMgr.h"
 #include "VMapFactory.h"
 #include "MoveMap.h"
+#include "TerrainPrefetcher.h"
 
 #define DEFAULT_GRID_EXPIRY     300
 #define MAX_GRID_LOAD_TIME      50
@@ -62,10 +64,16 @@ Map::~Map()
 {
     UnloadAll();
 
+    MapCommand* command;
+    while (m_commands.next(command))
+        delete command;
+
     if (!m_scriptSchedule.empty())
         sWorld.DecreaseScheduledScriptCount(m_scriptSchedule.size());
 
-     MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_TerrainData->GetMapId(), GetInstanceId());
+    // already released by BeginUnload, a new map may use the same instance id by now
+    if (!m_unloading)
+        MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_TerrainData->GetMapId(), GetInstanceId());
 
     //release reference count
     if (m_TerrainData->Release())
@@ -91,7 +99,8 @@ void Map::DeleteStateMachine()
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
    : i_mapEntry (sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
      i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0), i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
-     m_activeNonPlayersIter(m_activeNonPlayers.end()), i_scriptLock(true)
+     m_activeNonPlayersIter(m_activeNonPlayers.end()), i_scriptLock(true), m_updateTimeTotal(0), m_updateCount(0), m_updateTimeAvg(0),
+     m_unloading(false), m_unloadTime(0), m_decoupledUpdating(false), m_updateThread(ACE_thread_t())
 {
     for (unsigned int j=0; j < MAX_NUMBER_OF_GRIDS; ++j)
     {
@@ -117,6 +126,9 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
         m_wanted_delay = sWorld.getConfig(CONFIG_MAPUPDATE_INSTANCES);
     else
         m_wanted_delay = sWorld.getConfig(CONFIG_MAPUPDATE_CONTINENTS);
+
+    // battlegrounds are driven by BattleGroundMgr from world thread, keep them in lockstep
+    m_decoupled = IsDungeon() && sWorld.getConfig(CONFIG_MAPUPDATE_DECOUPLED_INSTANCES);
 }
 
 void Map::InitVisibilityDistance()
@@ -429,8 +441,17 @@ void Map::Update(const uint32 &t_diff)
 {
     volatile uint32 debug_map_id = GetId();
     uint32 startTime = WorldTimer::getMSTime();
+    uint64 updateStart = WorldTimer::getUSTime();
+    ProfileZone mapZone("Map::Update");
+    ProfileZone zone("Map::Update sessions");
+    if (m_decoupled)
+        ProcessCommands();
+
     _dynamicTree.update(t_diff);
 
+    // auras due by now wait in their units' lists for the updates below
+    m_auraTimerWheel.Advance(t_diff);
+
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
@@ -446,6 +467,7 @@ void Map::Update(const uint32 &t_diff)
     if (WorldTimer::getMSTimeDiffToNow(startTime) > 90)
         sLog.outLog(LOG_DIFF, "Map::Update sessions (%u ms) map %u", WorldTimer::getMSTimeDiffToNow(startTime), GetId());
     startTime = WorldTimer::getMSTime();
+    zone.Next("Map::Update players");
     /// update players at tick
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
@@ -460,10 +482,24 @@ void Map::Update(const uint32 &t_diff)
     if (WorldTimer::getMSTimeDiffToNow(startTime) > 50)
         sLog.outLog(LOG_DIFF, "Map::Update players (%u ms) map %u", WorldTimer::getMSTimeDiffToNow(startTime), GetId());
 
+    if (sTerrainPrefetcher.IsActive() && m_terrainPrefetchTimer.Expired(t_diff))
+    {
+        zone.Next("Map::Update terrain prefetch");
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* plr = m_mapRefIter->getSource();
+            if (plr && plr->IsInWorld())
+                sTerrainPrefetcher.PrefetchFor(*plr, *m_TerrainData);
+        }
+
+        m_terrainPrefetchTimer.Reset(TERRAIN_PREFETCH_INTERVAL);
+    }
+
     uint32 alloweddiff = sWorld.getConfig(CONFIG_MIN_LOG_CELL);
 
     resetMarkedCells();
 
+    zone.Next("Map::Update cells");
     MaNGOS::ObjectUpdater updater(t_diff);
     // for creature
     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> grid_object_update(updater);
@@ -509,6 +545,7 @@ void Map::Update(const uint32 &t_diff)
 
     float updatedistance = GetActiveObjectUpdateDistance();
     alloweddiff = sWorld.getConfig(CONFIG_MIN_LOG_ACTIVE_CELL);
+    zone.Next("Map::Update active objects");
     // non-player active objects
     if (!m_activeNonPlayers.empty() && updatedistance>=0)
     {
@@ -559,7 +596,15 @@ void Map::Update(const uint32 &t_diff)
             }
         }
     }
+    zone.Next("Map::Update relocation notify");
+    // AI reactions to units moved since last pass
+    m_relocationNotify.Update(*this, t_diff);
+
+    zone.Next("Map::Update event spawns");
+    m_spawnQueue.Update(*this, sWorld.getConfig(CONFIG_MAPUPDATE_EVENT_SPAWNS));
+
     startTime = WorldTimer::getMSTime();
+    zone.Next("Map::Update scripts and moves");
     // Send world objects and item update field changes
     SendObjectUpdates();
 
@@ -575,6 +620,75 @@ void Map::Update(const uint32 &t_diff)
 
     if (WorldTimer::getMSTimeDiffToNow(startTime) > 100)
         sLog.outLog(LOG_DIFF,"Map::Update all thats left (%u ms) map %u", WorldTimer::getMSTimeDiffToNow(startTime), GetId());
+
+    uint32 updateTime = uint32(WorldTimer::getUSTime() - updateStart);
+    m_updateTimeAvg = m_updateCount ? (m_updateTimeAvg * 7 + updateTime) / 8 : updateTime;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_updateTimesLock);
+    m_updateTimeTotal += updateTime;
+    m_updateTimes[m_updateCount % MAP_UPDATE_TIME_HISTORY] = updateTime;
+    ++m_updateCount;
+}
+
+void Map::GetUpdateTimes(MapUpdateTimes& times) const
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_updateTimesLock);
+    times.total = m_updateTimeTotal;
+    times.count = m_updateCount;
+    times.recent.assign(m_updateTimes, m_updateTimes + std::min<uint32>(m_updateCount, MAP_UPDATE_TIME_HISTORY));
+}
+
+void Map::AddGridLoad(uint32 objectCount, uint32 prepare, uint32 link, bool prefetched)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_gridLoadStatsLock);
+    m_gridLoadStats.Add(objectCount, prepare, link, prefetched);
+}
+
+void Map::GetGridLoadStats(GridLoadStats& stats) const
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_gridLoadStatsLock);
+    stats = m_gridLoadStats;
+}
+
+uint32 MapUpdateTimes::Percentile(float pct) const
+{
+    if (recent.empty())
+        return 0;
+
+    std::vector<uint32> times(recent);
+    std::vector<uint32>::iterator nth = times.begin() + uint32((times.size() - 1) * pct / 100.0f);
+    std::nth_element(times.begin(), nth, times.end());
+    return *nth;
+}
+
+uint32 MapUpdateTimes::Max() const
+{
+    return recent.empty() ? 0 : *std::max_element(recent.begin(), recent.end());
+}
+
+bool Map::IsUpdateThread() const
+{
+    return m_decoupledUpdating.load(std::memory_order_acquire) && ACE_OS::thr_equal(m_updateThread.load(), ACE_OS::thr_self());
+}
+
+void Map::SetUpdateThread(bool own)
+{
+    m_updateThread.store(own ? ACE_OS::thr_self() : ACE_thread_t());
+}
+
+void Map::QueueCommand(MapCommand* command)
+{
+    m_commands.add(command);
+}
+
+void Map::ProcessCommands()
+{
+    MapCommand* command;
+    while (m_commands.next(command))
+    {
+        command->Execute(*this);
+        delete command;
+    }
 }
 
 void Map::CheckHostileRefFor(Player* plr)
@@ -586,6 +700,8 @@ void Map::CheckHostileRefFor(Player* plr)
 
 void Map::SendObjectUpdates()
 {
+    ProfileZone zone("Map::SendObjectUpdates");
+
     UpdateDataMapType update_players;
     for (ObjectSet::const_iterator it = i_objectsToClientUpdate.begin(); it != i_objectsToClientUpdate.end(); ++it)
     {
@@ -882,6 +998,8 @@ bool Map::UnloadGrid(const uint32 &x, const uint32 &y, bool unloadAll)
 
         ASSERT(i_objectsToRemove.empty());
 
+        m_unitSearch.ClearGrid(x, y);
+
         delete grid;
         setNGrid(NULL, x, y);
     }
@@ -892,15 +1010,42 @@ bool Map::UnloadGrid(const uint32 &x, const uint32 &y, bool unloadAll)
 
 void Map::UnloadAll()
 {
+    PrepareUnload();
+
     // clear all delayed moves, useless anyway do this moves before map unload.
     i_creaturesToMove.clear();
 
+    UnloadGrids(0);
+}
+
+void Map::BeginUnload()
+{
+    m_unloading = true;
+
+    PrepareUnload();
+
+    i_creaturesToMove.clear();
+
+    // navmesh queries are kept per instance id, don't keep it until the grids are gone
+    MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_TerrainData->GetMapId(), GetInstanceId());
+}
+
+bool Map::UnloadGrids(uint32 count)
+{
+    uint64 start = WorldTimer::getUSTime();
+
     for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end();)
     {
         NGridType &grid(*i->getSource());
         ++i;
         UnloadGrid(grid.getX(), grid.getY(), true);       // deletes the grid and removes it from the GridRefManager
+
+        if (count && !--count)
+            break;
     }
+
+    m_unloadTime += WorldTimer::getUSTime() - start;
+    return GridRefManager<NGridType>::isEmpty();
 }
 
 bool Map::CheckGridIntegrity(Creature* c, bool moved) const
@@ -1028,8 +1173,12 @@ inline void Map::setNGrid(NGridType *grid, uint32 x, uint32 y)
 
 void Map::DelayedUpdate(const uint32 t_diff)
 {
+    ProfileZone mapZone("Map::DelayedUpdate");
+    ProfileZone zone("Map::DelayedUpdate remove list");
     RemoveAllObjectsInRemoveList();
 
+    zone.Next("Map::DelayedUpdate grid states");
+
     // Don't unload grids if it's battleground, since we may have manually added GOs,creatures, those doesn't load from DB at grid re-load !
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
     if (!IsBattleGroundOrArena())
@@ -2443,7 +2592,7 @@ void InstanceMap::PermBindAllPlayers(Player *player)
         sLog.outLog(LOG_RAID_BINDS, "%s", str.str().c_str());
 }
 
-void InstanceMap::UnloadAll()
+void InstanceMap::PrepareUnload()
 {
     if (HavePlayers())
     {
@@ -2457,8 +2606,6 @@ void InstanceMap::UnloadAll()
 
     if (m_resetAfterUnload == true)
         sObjectMgr.DeleteRespawnTimeForInstance(GetInstanceId());
-
-    Map::UnloadAll();
 }
 
 void InstanceMap::SendResetWarnings(uint32 timeLeft) const
@@ -2584,7 +2731,7 @@ void BattleGroundMap::SetUnload()
     m_unloadTimer.Reset(MIN_UNLOAD_DELAY);
 }
 
-void BattleGroundMap::UnloadAll()
+void BattleGroundMap::PrepareUnload()
 {
     while (HavePlayers())
     {
@@ -2597,8 +2744,6 @@ void BattleGroundMap::UnloadAll()
             plr->GetMapRef().unlink();
         }
     }
-
-    Map::UnloadAll();
 }
 
 Creature * Map::GetCreature(uint64 guid)
@@ -3193,7 +3338,8 @@ void Map::UpdateHelper::Update( DelayedMapList& delayedUpdate )
 {
     if (m_map->m_wanted_delay > GetTimeElapsed())
         return;
-    sMapMgr.GetMapUpdater()->schedule_update(*m_map, GetTimeElapsed());
+
+    // scheduled by MapManager once all maps due in this tick are known
     delayedUpdate.push_back(std::make_pair(m_map, uint32(GetTimeElapsed())));
 
     m_map->m_updateTracker.Reset();
@@ -3288,6 +3434,9 @@ bool Map::GetWalkHitPosition(Transport* transport, float srcX, float srcY, float
         return false;
     }
 
+    // tiles must not be added or removed while we walk the mesh
+    MMAP::MMapManager::ReadGuard guard(mmap->GetLock());
+
     /// Find navmesh position near source
     float point[3] = { srcY, srcZ, srcX };
     // Warning : Coord order is Y,Z,X
@@ -33,10 +33,16 @@
 #include "GridMap.h"
 #include "GameSystem/GridRefManager.h"
 #include "MapRefManager.h"
+#include "AuraTimerWheel.h"
+#include "RelocationNotifyPass.h"
+#include "UnitSearchIndex.h"
+#include "MapSpawnQueue.h"
+#include "ObjectGridLoader.h"
 #include "vmap/DynamicTree.h"
 #include "G3D/Vector3.h"
 //#include "mersennetwister/MersenneTwister.h"
 
+#include <atomic>
 #include <bitset>
 #include <list>
 
@@ -107,6 +113,7 @@ enum LevelRequirementVsMode
 #define MAX_HEIGHT            100000.0f                     // can be use for find ground height at surface
 #define INVALID_HEIGHT       -100000.0f                     // for check, must be equal to VMAP_INVALID_HEIGHT, real value for unknown height is VMAP_INVALID_HEIGHT_VALUE
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
+#define MAP_UPDATE_TIME_HISTORY 256                         // Map::Update durations kept for percentiles
 
 typedef UNORDERED_MAP<Creature*, CreatureMover>                 CreatureMoveList;
 typedef std::map<uint32/*leaderDBGUID*/, CreatureGroup*>        CreatureGroupHolderType;
@@ -125,6 +132,28 @@ enum GetCreatureGuidType
 
 typedef std::list<std::pair<Map*, uint32> > DelayedMapList;
 
+// work other threads hand to a decoupled map, run at the start of its next
+// Map::Update on the map's thread and deleted afterwards
+class MapCommand
+{
+    public:
+        virtual ~MapCommand() {}
+        virtual void Execute(Map& map) = 0;
+};
+
+// copy of recent Map::Update durations, microseconds
+struct MapUpdateTimes
+{
+    MapUpdateTimes() : total(0), count(0) {}
+
+    uint32 Percentile(float pct) const;
+    uint32 Max() const;
+
+    uint64 total;
+    uint32 count;
+    std::vector<uint32> recent;                             // last MAP_UPDATE_TIME_HISTORY updates
+};
+
 class Map : public GridRefManager<NGridType>
 {
     friend class MapReference;
@@ -189,6 +218,16 @@ class Map : public GridRefManager<NGridType>
 
         virtual void UnloadAll();
 
+        // map was removed from MapManager, release everything shared with the world
+        // so grids can be unloaded later by UnloadGrids, world thread only
+        void BeginUnload();
+        // unload at most count grids (0 = all), returns true when no grid is left
+        bool UnloadGrids(uint32 count);
+        bool IsUnloading() const { return m_unloading; }
+        bool IsUnloaded() const { return m_unloading && GridRefManager<NGridType>::isEmpty(); }
+        // time spent in UnloadGrids so far, microseconds
+        uint64 GetUnloadTime() const { return m_unloadTime; }
+
         void ResetGridExpiry(NGridType &grid, float factor = 1) const;
 
         time_t GetGridExpiry(void) const { return i_gridExpiry; }
@@ -358,6 +397,37 @@ class Map : public GridRefManager<NGridType>
 
 
         std::string getDebugData();
+
+        // Map::Update cost, any thread, decoupled maps may be updating meanwhile
+        void GetUpdateTimes(MapUpdateTimes& times) const;
+        // smoothed recent Map::Update duration, used to order map updates
+        uint32 GetUpdateTimeAvg() const { return m_updateTimeAvg; }
+
+        // dungeon updated without waiting for other maps at the end of world tick,
+        // see MapUpdate.DecoupledInstances
+        bool IsDecoupled() const { return m_decoupled; }
+        // decoupled map update scheduled and not finished yet, world thread must
+        // not touch the map's objects and sends a MapCommand instead
+        bool IsDecoupledUpdating() const { return m_decoupledUpdating.load(std::memory_order_acquire); }
+        // caller runs the map's update, always false for maps that are not decoupled
+        bool IsUpdateThread() const;
+        // world thread, around update of a decoupled map on update thread
+        void BeginDecoupledUpdate() { m_decoupledUpdating.store(true, std::memory_order_release); }
+        void SetUpdateThread(bool own);
+        void EndDecoupledUpdate() { m_decoupledUpdating.store(false, std::memory_order_release); }
+
+        // any thread, command is owned by map from now on
+        void QueueCommand(MapCommand* command);
+        bool HasQueuedCommands() { return !m_commands.empty(); }
+
+        AuraTimerWheel& GetAuraTimerWheel() { return m_auraTimerWheel; }
+        RelocationNotifyPass& GetRelocationNotifyPass() { return m_relocationNotify; }
+        UnitSearchIndex& GetUnitSearchIndex() { return m_unitSearch; }
+        MapSpawnQueue& GetSpawnQueue() { return m_spawnQueue; }
+        // map thread, after ObjectGridLoader::LoadN
+        void AddGridLoad(uint32 objectCount, uint32 prepare, uint32 link, bool prefetched);
+        // any thread, copy of stats
+        void GetGridLoadStats(GridLoadStats& stats) const;
     private:
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
         //uint64 CalculateGridMask(const uint32 &y) const;
@@ -385,6 +455,7 @@ class Map : public GridRefManager<NGridType>
 
         void CheckHostileRefFor(Player*);
         void SendObjectUpdates();
+        void ProcessCommands();
 
         typedef std::set<Object*> ObjectSet;
         ObjectSet i_objectsToClientUpdate;
@@ -399,11 +470,21 @@ class Map : public GridRefManager<NGridType>
     protected:
         ACE_Thread_Mutex Lock;
 
+        // players and world wide data, called before grids are unloaded
+        virtual void PrepareUnload() {}
+
         MapEntry const* i_mapEntry;
         uint8 i_spawnMode;
         uint32 i_id;
         uint32 i_InstanceId;
         Timer m_unloadTimer;
+        Countdown m_terrainPrefetchTimer;
+        AuraTimerWheel m_auraTimerWheel;
+        RelocationNotifyPass m_relocationNotify;
+        UnitSearchIndex m_unitSearch;
+        MapSpawnQueue m_spawnQueue;
+        mutable ACE_Thread_Mutex m_gridLoadStatsLock;
+        GridLoadStats m_gridLoadStats;
 
         float m_ActiveObjectUpdateDistance;
 
@@ -431,6 +512,20 @@ class Map : public GridRefManager<NGridType>
         bool i_scriptLock;
         uint32 m_wanted_delay;
 
+        mutable ACE_Thread_Mutex m_updateTimesLock;         // guards times below, not m_updateTimeAvg
+        uint64 m_updateTimeTotal;
+        uint32 m_updateCount;
+        uint32 m_updateTimeAvg;
+        uint32 m_updateTimes[MAP_UPDATE_TIME_HISTORY];
+
+        bool m_decoupled;
+        std::atomic<bool> m_decoupledUpdating;
+        std::atomic<ACE_thread_t> m_updateThread;
+        ACE_Based::LockedQueue<MapCommand*, ACE_Thread_Mutex> m_commands;
+
+        bool m_unloading;
+        uint64 m_unloadTime;
+
         std::set<WorldObject *> i_objectsToRemove;
         std::map<WorldObject*, bool> i_objectsToSwitch;
         std::multimap<time_t, ScriptAction> m_scriptSchedule;
@@ -469,7 +564,6 @@ class InstanceMap : public Map
         uint32 GetScriptId() { return i_script_id; }
         InstanceData* GetInstanceData() { return i_data; }
         void PermBindAllPlayers(Player *player);
-        void UnloadAll();
         bool CanEnter(Player* player);
         bool EncounterInProgress(Player *player);
         void SendResetWarnings(uint32 timeLeft) const;
@@ -478,6 +572,8 @@ class InstanceMap : public Map
         uint32 GetMaxPlayers() const;
 
         void SummonUnlootedCreatures();
+    protected:
+        void PrepareUnload();
     private:
         bool m_resetAfterUnload;
         bool m_unloadWhenEmpty;
@@ -498,8 +594,9 @@ class BattleGroundMap : public Map
         void Update(const uint32&);
         virtual void InitVisibilityDistance();
         void SetUnload();
-        void UnloadAll();
         void SetBattleGround(BattleGround *pBg){ m_bg = pBg; }
+    protected:
+        void PrepareUnload();
     private:
         BattleGround *m_bg;
 };
@@ -22,6 +22,7 @@
 #include "InstanceSaveMgr.h"
 #include "Database/DatabaseEnv.h"
 #include "Log.h"
+#include "Profiler.h"
 #include "ObjectAccessor.h"
 #include "Transports.h"
 #include "GridDefines.h"
@@ -33,8 +34,11 @@
 #include "GridMap.h"
 
 #include "BattleGround.h"
+#include "PathFinderQueue.h"
+#include "TerrainPrefetcher.h"
 
-MapManager::MapManager() : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_INTERVAL_GRIDCLEAN))
+MapManager::MapManager() : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_INTERVAL_GRIDCLEAN)),
+    m_unloadedMaps(0), m_unloadTimeTotal(0), m_unloadTimeMax(0)
 {
 }
 
@@ -43,6 +47,9 @@ MapManager::~MapManager()
     for (MapMapType::iterator iter=i_maps.begin(); iter != i_maps.end(); ++iter)
         delete iter->second;
 
+    for (MapList::iterator iter = i_unloadingMaps.begin(); iter != i_unloadingMaps.end(); ++iter)
+        delete *iter;
+
     for (TransportSet::iterator i = m_Transports.begin(); i != m_Transports.end(); ++i)
         delete *i;
 
@@ -62,6 +69,12 @@ void MapManager::Initialize()
         sLog.outLog(LOG_DEFAULT, "ERROR: MapUpdater cannot be activated !!!!!");
         abort();
     }
+
+    if (sWorld.getConfig(CONFIG_MMAP_ENABLED) && sPathFinderQueue.Activate(sWorld.getConfig(CONFIG_MMAP_ASYNC_THREADS)))
+        sLog.outString("Path finder queue started with %u threads", sPathFinderQueue.GetThreads());
+
+    if (sWorld.getConfig(CONFIG_GRID_PREFETCH) && sTerrainPrefetcher.Activate())
+        sLog.outString("Terrain prefetcher started");
 }
 
 void MapManager::InitializeVisibilityDistanceInfo()
@@ -218,25 +231,73 @@ void MapManager::DeleteInstance(uint32 mapid, uint32 instanceId)
         if (pMap->Instanceable())
         {
             i_maps.erase(iter);
+            QueueUnload(pMap);
+        }
+    }
+}
 
-            pMap->UnloadAll();
-            delete pMap;
+void MapManager::QueueUnload(Map* map)
+{
+    map->BeginUnload();
+    i_unloadingMaps.push_back(map);
+}
+
+void MapManager::DeleteUnloadedMaps()
+{
+    for (MapList::iterator iter = i_unloadingMaps.begin(); iter != i_unloadingMaps.end();)
+    {
+        Map* map = *iter;
+        if (!map->IsUnloaded())
+        {
+            ++iter;
+            continue;
         }
+
+        uint64 start = WorldTimer::getUSTime();
+        uint32 mapId = map->GetId();
+        uint32 instanceId = map->GetInstanceId();
+        uint64 unloadTime = map->GetUnloadTime();
+        delete map;
+        unloadTime += WorldTimer::getUSTime() - start;
+
+        ++m_unloadedMaps;
+        m_unloadTimeTotal += unloadTime;
+        if (unloadTime > m_unloadTimeMax)
+            m_unloadTimeMax = unloadTime;
+
+        sLog.outDetail("Map %u instance %u unloaded in " UI64FMTD " us", mapId, instanceId, unloadTime);
+        iter = i_unloadingMaps.erase(iter);
     }
 }
 
 typedef std::list<std::pair<Map*, uint32> > DelayedMapList;
+
+static bool MapUpdateCostGreater(std::pair<Map*, uint32> const& lhs, std::pair<Map*, uint32> const& rhs)
+{
+    return lhs.first->GetUpdateTimeAvg() > rhs.first->GetUpdateTimeAvg();
+}
+
 void MapManager::Update(uint32 diff)
 {
+    ProfileZone zone("MapManager::Update");
+
     DiffRecorder dr(sWorld.getConfig(CONFIG_MIN_LOG_UPDATE));
     DelayedMapList delayedUpdate;
     for (MapMapType::iterator iter=i_maps.begin(); iter != i_maps.end();)
     {
-        if (iter->second->CanUnload(diff))
+        // decoupled instance still busy with an earlier tick isn't rescheduled,
+        // its next update covers the time elapsed meanwhile
+        if (iter->second->IsDecoupledUpdating())
         {
-            iter->second->UnloadAll();
-            delete iter->second;
+            ++iter;
+            continue;
+        }
 
+        // queued teleports must find the map
+        if (!iter->second->HasQueuedCommands() && iter->second->CanUnload(diff))
+        {
+            // grids are unloaded after map updates, few per tick
+            QueueUnload(iter->second);
             i_maps.erase(iter++);
         }
         else
@@ -247,15 +308,61 @@ void MapManager::Update(uint32 diff)
             ++iter;
         }
     }
+
+    // decoupled instances run their update and delayed update in one go and are
+    // not waited for below, world thread hands them work through MapCommand
+    for (DelayedMapList::iterator iter = delayedUpdate.begin(); iter != delayedUpdate.end();)
+    {
+        if (iter->first->IsDecoupled())
+        {
+            m_updater.schedule_decoupled_update(*iter->first, iter->second);
+            iter = delayedUpdate.erase(iter);
+        }
+        else
+            ++iter;
+    }
+
+    // other maps end their tick at the barrier below, world thread code touches
+    // their objects between ticks. The tick waits for the slowest map, start the
+    // expensive ones first so they don't begin late after worker threads were busy
+    // with cheap maps
+    delayedUpdate.sort(MapUpdateCostGreater);
+    for (DelayedMapList::iterator iter = delayedUpdate.begin(); iter != delayedUpdate.end(); ++iter)
+        m_updater.schedule_update(*iter->first, iter->second);
+
     dr.RecordTimeFor("MapManager-general");
     m_updater.wait();
     if (dr.RecordTimeFor("MapManager-wait"))
         sLog.outLog(LOG_DIFF, "last updated map %u", m_updater.GetLastMapId());
 
-    for (DelayedMapList::iterator iter = delayedUpdate.begin(); iter != delayedUpdate.end(); ++iter)
-        iter->first->DelayedUpdate(iter->second);
-    delayedUpdate.clear();
+    {
+        ProfileZone delayedZone("MapManager::DelayedUpdate");
+
+        // maps do not share grids or remove lists, so once every map finished its
+        // regular update the delayed phase can run as a second parallel wave
+        uint32 unloadGrids = sWorld.getConfig(CONFIG_MAPUPDATE_UNLOAD_GRIDS);
+        if (sWorld.getConfig(CONFIG_MAPUPDATE_PARALLEL_DELAYED))
+        {
+            for (DelayedMapList::iterator iter = delayedUpdate.begin(); iter != delayedUpdate.end(); ++iter)
+                m_updater.schedule_delayed_update(*iter->first, iter->second);
+            for (MapList::iterator iter = i_unloadingMaps.begin(); iter != i_unloadingMaps.end(); ++iter)
+                m_updater.schedule_unload(**iter, unloadGrids);
+            m_updater.wait();
+        }
+        else
+        {
+            for (DelayedMapList::iterator iter = delayedUpdate.begin(); iter != delayedUpdate.end(); ++iter)
+                iter->first->DelayedUpdate(iter->second);
+            for (MapList::iterator iter = i_unloadingMaps.begin(); iter != i_unloadingMaps.end(); ++iter)
+                (*iter)->UnloadGrids(unloadGrids);
+        }
+        delayedUpdate.clear();
+    }
     dr.RecordTimeFor("MapManager-delayed");
+
+    DeleteUnloadedMaps();
+    sTerrainPrefetcher.Update();
+    dr.RecordTimeFor("MapManager-unload");
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
     {
         WorldObject::UpdateHelper helper(*iter);
@@ -282,6 +389,11 @@ bool MapManager::IsValidMAP(uint32 mapid)
 
 void MapManager::UnloadAll()
 {
+    m_updater.wait_decoupled();
+
+    sPathFinderQueue.Deactivate();
+    sTerrainPrefetcher.Deactivate();
+
     for (MapMapType::iterator iter=i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->UnloadAll();
 
@@ -292,6 +404,13 @@ void MapManager::UnloadAll()
         delete temp;
     }
 
+    while (!i_unloadingMaps.empty())
+    {
+        i_unloadingMaps.front()->UnloadGrids(0);
+        delete i_unloadingMaps.front();
+        i_unloadingMaps.pop_front();
+    }
+
     sTerrainMgr.UnloadAll();
 
     m_updater.deactivate();
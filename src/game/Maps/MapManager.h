@@ -141,6 +141,13 @@ class MapManager
         uint32 GetNumInstances();
         uint32 GetNumPlayersInInstances();
 
+        // maps already removed from the world but still unloading grids
+        uint32 GetUnloadBacklog() const { return i_unloadingMaps.size(); }
+        uint32 GetUnloadedMapsCount() const { return m_unloadedMaps; }
+        // teardown cost of unloaded maps, microseconds
+        uint64 GetUnloadTimeTotal() const { return m_unloadTimeTotal; }
+        uint64 GetUnloadTimeMax() const { return m_unloadTimeMax; }
+
         MapUpdater* GetMapUpdater() { return &m_updater; };
 
         //get list of all maps
@@ -160,9 +167,19 @@ class MapManager
         InstanceMap* CreateInstanceMap(uint32 id, uint32 InstanceId, DungeonDifficulties difficulty, InstanceSave *save = NULL);
         BattleGroundMap* CreateBattleGroundMap(uint32 id, uint32 InstanceId, BattleGround* bg);
 
+        // hand map removed from i_maps over to map update threads for unloading
+        void QueueUnload(Map* map);
+        void DeleteUnloadedMaps();
+
         uint32 i_gridCleanUpDelay;
         MapMapType i_maps;
 
+        typedef std::list<Map*> MapList;
+        MapList i_unloadingMaps;
+        uint32 m_unloadedMaps;
+        uint64 m_unloadTimeTotal;
+        uint64 m_unloadTimeMax;
+
         MapUpdater m_updater;
         uint32 i_MaxInstanceId;
 
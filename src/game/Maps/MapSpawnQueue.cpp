@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "MapSpawnQueue.h"
+#include "Map.h"
+#include "ObjectMgr.h"
+#include "Creature.h"
+#include "GameObject.h"
+
+MapSpawnQueue::~MapSpawnQueue()
+{
+    for (std::vector<MapSpawnBatch*>::iterator itr = m_incoming.begin(); itr != m_incoming.end(); ++itr)
+        delete *itr;
+
+    for (std::deque<MapSpawnBatch*>::iterator itr = m_batches.begin(); itr != m_batches.end(); ++itr)
+        delete *itr;
+}
+
+void MapSpawnQueue::Queue(MapSpawnBatch* batch)
+{
+    m_queued += batch->commands.size();
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+    m_incoming.push_back(batch);
+}
+
+void MapSpawnQueue::Update(Map& map, uint32 budget)
+{
+    if (!m_queued.value())
+        return;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        m_batches.insert(m_batches.end(), m_incoming.begin(), m_incoming.end());
+        m_incoming.clear();
+    }
+
+    uint32 applied = 0;
+    while (!m_batches.empty())
+    {
+        MapSpawnBatch* batch = m_batches.front();
+
+        uint64 start = WorldTimer::getUSTime();
+        for (; batch->next < batch->commands.size() && (!budget || applied < budget); ++batch->next, ++applied)
+        {
+            if (Apply(map, batch->commands[batch->next]))
+                ++batch->done;
+            else
+                ++batch->skipped;
+        }
+        batch->workTime += WorldTimer::getUSTime() - start;
+
+        if (batch->next < batch->commands.size())
+            break;
+
+        sLog.outString("GameEvent %i: map %u applied %u spawn commands (%u skipped) in %u ms, %u us of work",
+            batch->eventId, map.GetId(), batch->done, batch->skipped,
+            WorldTimer::getMSTimeDiffToNow(batch->queued), uint32(batch->workTime));
+
+        m_batches.pop_front();
+        delete batch;
+    }
+
+    m_queued -= applied;
+}
+
+bool MapSpawnQueue::Apply(Map& map, MapSpawnCommand const& command)
+{
+    switch (command.type)
+    {
+        case MAP_SPAWN_CREATURE:
+        {
+            CreatureData const* data = sObjectMgr.GetCreatureData(command.guid);
+            if (!data || !map.IsLoaded(data->posX, data->posY))
+                return false;
+
+            // grid loaded after the command was queued already has it
+            if (map.GetCreature(MAKE_NEW_GUID(command.guid, data->id, HIGHGUID_UNIT)))
+                return false;
+
+            Creature* pCreature = new Creature;
+            if (!pCreature->LoadFromDB(command.guid, &map))
+            {
+                delete pCreature;
+                return false;
+            }
+
+            map.Add(pCreature);
+            return true;
+        }
+        case MAP_UNSPAWN_CREATURE:
+        {
+            CreatureData const* data = sObjectMgr.GetCreatureData(command.guid);
+            if (!data)
+                return false;
+
+            Creature* pCreature = map.GetCreature(MAKE_NEW_GUID(command.guid, data->id, HIGHGUID_UNIT));
+            if (!pCreature)
+                return false;
+
+            pCreature->AddObjectToRemoveList();
+            return true;
+        }
+        case MAP_SPAWN_GAMEOBJECT:
+        {
+            GameObjectData const* data = sObjectMgr.GetGOData(command.guid);
+            if (!data || !map.IsLoaded(data->posX, data->posY))
+                return false;
+
+            if (map.GetGameObject(MAKE_NEW_GUID(command.guid, data->id, HIGHGUID_GAMEOBJECT)))
+                return false;
+
+            GameObject* pGameobject = new GameObject;
+            if (!pGameobject->LoadFromDB(command.guid, &map) || !pGameobject->isSpawnedByDefault())
+            {
+                delete pGameobject;
+                return false;
+            }
+
+            map.Add(pGameobject);
+            return true;
+        }
+        case MAP_UNSPAWN_GAMEOBJECT:
+        {
+            GameObjectData const* data = sObjectMgr.GetGOData(command.guid);
+            if (!data)
+                return false;
+
+            GameObject* pGameobject = map.GetGameObject(MAKE_NEW_GUID(command.guid, data->id, HIGHGUID_GAMEOBJECT));
+            if (!pGameobject)
+                return false;
+
+            pGameobject->AddObjectToRemoveList();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _MAP_SPAWN_QUEUE_H
+#define _MAP_SPAWN_QUEUE_H
+
+#include "Common.h"
+
+#include "ace/Atomic_Op.h"
+#include "ace/Thread_Mutex.h"
+
+#include <deque>
+
+class Map;
+
+enum MapSpawnCommandType
+{
+    MAP_SPAWN_CREATURE,
+    MAP_UNSPAWN_CREATURE,
+    MAP_SPAWN_GAMEOBJECT,
+    MAP_UNSPAWN_GAMEOBJECT
+};
+
+struct MapSpawnCommand
+{
+    MapSpawnCommand(MapSpawnCommandType t, uint32 g) : type(t), guid(g) {}
+
+    MapSpawnCommandType type;
+    uint32 guid;                                            // db guid of creature or gameobject
+};
+
+// commands of one game event (de)activation for one map
+struct MapSpawnBatch
+{
+    MapSpawnBatch() : eventId(0), queued(0), next(0), done(0), skipped(0), workTime(0) {}
+
+    int16 eventId;                                          // negative for (de)activation of negative event
+    uint32 queued;                                          // WorldTimer::getMSTime()
+    std::vector<MapSpawnCommand> commands;
+    uint32 next;
+
+    uint32 done;
+    uint32 skipped;                                         // grid not loaded or object already there
+    uint64 workTime;                                        // microseconds
+};
+
+/**
+ * Game event spawns and removals waiting for one map.
+ *
+ * GameEventMgr only updates spawn data of cells and queues batches here,
+ * creatures and gameobjects are created and added by the map in its own
+ * update, at most budget commands per update. Whether the grid is loaded
+ * and whether the object is already there is checked when the command is
+ * applied, a grid loaded meanwhile spawns the object itself.
+ */
+class MapSpawnQueue
+{
+    public:
+        MapSpawnQueue() : m_queued(0) {}
+        ~MapSpawnQueue();
+
+        // any thread
+        void Queue(MapSpawnBatch* batch);
+        uint32 GetQueued() const { return uint32(m_queued.value()); }
+
+        // map thread, budget 0 = apply everything
+        void Update(Map& map, uint32 budget);
+
+    private:
+        MapSpawnQueue(const MapSpawnQueue&);
+        MapSpawnQueue& operator=(const MapSpawnQueue&);
+
+        bool Apply(Map& map, MapSpawnCommand const& command);
+
+        ACE_Thread_Mutex m_lock;
+        std::vector<MapSpawnBatch*> m_incoming;             // guarded by m_lock
+        std::deque<MapSpawnBatch*> m_batches;               // map thread only
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_queued;     // commands not applied yet
+};
+
+#endif
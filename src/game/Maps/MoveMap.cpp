@@ -60,8 +60,11 @@ namespace MMAP
     bool MMapManager::loadMapData(uint32 mapId)
     {
         // we already have this map loaded?
-        if (loadedMMaps.find(mapId) != loadedMMaps.end())
-            return true;
+        {
+            ReadGuard guard(m_lock);
+            if (loadedMMaps.find(mapId) != loadedMMaps.end())
+                return true;
+        }
 
         // load and init dtNavMesh - read parameters from file
         uint32 pathLen = sWorld.GetDataPath().length() + strlen("mmaps/%03i.mmap")+1;
@@ -95,6 +98,15 @@ namespace MMAP
         sLog.outDetail("MMAP:loadMapData: Loaded %03i.mmap", mapId);
 
         // store inside our map list
+        WriteGuard guard(m_lock);
+
+        // other map thread may have been faster
+        if (loadedMMaps.find(mapId) != loadedMMaps.end())
+        {
+            dtFreeNavMesh(mesh);
+            return true;
+        }
+
         MMapData* mmap_data = new MMapData(mesh);
         mmap_data->mmapLoadedTiles.clear();
 
@@ -107,24 +119,8 @@ namespace MMAP
         return uint32(x << 16 | y);
     }
 
-    bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y)
+    bool MMapManager::readTile(uint32 mapId, int32 x, int32 y, MMapTileData& tile)
     {
-        // make sure the mmap is loaded and ready to load tiles
-        if(!loadMapData(mapId))
-            return false;
-
-        // get this mmap data
-        MMapData* mmap = loadedMMaps[mapId];
-        ASSERT(mmap->navMesh);
-
-        // check if we already have this tile loaded
-        uint32 packedGridPos = packTileID(x, y);
-        if (mmap->mmapLoadedTiles.find(packedGridPos) != mmap->mmapLoadedTiles.end())
-        {
-            sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:loadMap: Asked to load already loaded navmesh tile. %03u%02i%02i.mmtile", mapId, x, y);
-            return false;
-        }
-
         // load this tile :: mmaps/MMMXXYY.mmtile
         uint32 pathLen = sWorld.GetDataPath().length() + strlen("mmaps/%03i%02i%02i.mmtile")+1;
         char *fileName = new char[pathLen];
@@ -146,6 +142,7 @@ namespace MMAP
         if (fileHeader.mmapMagic != MMAP_MAGIC)
         {
             sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
+            fclose(file);
             return false;
         }
 
@@ -153,6 +150,7 @@ namespace MMAP
         {
             sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:loadMap: %03u%02i%02i.mmtile was built with generator v%i, expected v%i",
                                                 mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
+            fclose(file);
             return false;
         }
 
@@ -163,19 +161,78 @@ namespace MMAP
         if(!result)
         {
             sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
+            dtFree(data);
             fclose(file);
             return false;
         }
 
         fclose(file);
 
-        dtMeshHeader* header = (dtMeshHeader*)data;
+        tile.data = data;
+        tile.size = fileHeader.size;
+        return true;
+    }
+
+    void MMapManager::freeTile(MMapTileData& tile)
+    {
+        if (tile.data)
+            dtFree(tile.data);
+
+        tile.data = NULL;
+        tile.size = 0;
+    }
+
+    bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y, MMapTileData* prefetched)
+    {
+        MMapTileData tile;
+        if (prefetched)
+        {
+            tile = *prefetched;
+            prefetched->data = NULL;
+            prefetched->size = 0;
+        }
+
+        // make sure the mmap is loaded and ready to load tiles
+        if(!loadMapData(mapId))
+        {
+            freeTile(tile);
+            return false;
+        }
+
+        // get this mmap data
+        MMapData* mmap;
+        uint32 packedGridPos = packTileID(x, y);
+        {
+            ReadGuard guard(m_lock);
+            mmap = loadedMMaps[mapId];
+            ASSERT(mmap->navMesh);
+
+            // check if we already have this tile loaded
+            if (mmap->mmapLoadedTiles.find(packedGridPos) != mmap->mmapLoadedTiles.end())
+            {
+                sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:loadMap: Asked to load already loaded navmesh tile. %03u%02i%02i.mmtile", mapId, x, y);
+                freeTile(tile);
+                return false;
+            }
+        }
+
+        // prefetcher already tried to read the file
+        if (!prefetched && !readTile(mapId, x, y, tile))
+            return false;
+
+        if (!tile.data)
+            return false;
+
+        dtMeshHeader* header = (dtMeshHeader*)tile.data;
         dtTileRef tileRef = 0;
 
+        WriteGuard guard(m_lock);
+
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        if(DT_SUCCESS == mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef))
+        if(DT_SUCCESS == mmap->navMesh->addTile(tile.data, tile.size, DT_TILE_FREE_DATA, 0, &tileRef))
         {
             mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+            mmap->pathCache.Clear();
             ++loadedTiles;
             sLog.outDetail("MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
             return true;
@@ -183,7 +240,7 @@ namespace MMAP
         else
         {
             sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
-            dtFree(data);
+            freeTile(tile);
             return false;
         }
 
@@ -192,6 +249,8 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     {
+        WriteGuard guard(m_lock);
+
         // check if we have this map loaded
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
         {
@@ -225,6 +284,7 @@ namespace MMAP
         else
         {
             mmap->mmapLoadedTiles.erase(packedGridPos);
+            mmap->pathCache.Clear();
             --loadedTiles;
             sLog.outDetail("MMAP:unloadMap: Unloaded mmtile %03i[%02i,%02i] from %03i", mapId, x, y, mapId);
             return true;
@@ -235,6 +295,8 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId)
     {
+        WriteGuard guard(m_lock);
+
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
         {
             // file may not exist, therefore not loaded
@@ -266,6 +328,8 @@ namespace MMAP
 
     bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
     {
+        WriteGuard guard(m_lock);
+
         // check if we have this map loaded
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
         {
@@ -292,14 +356,37 @@ namespace MMAP
 
     dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
-            return NULL;
+        ReadGuard guard(m_lock);
+        return GetNavMeshLocked(mapId);
+    }
+
+    dtNavMesh const* MMapManager::GetNavMeshLocked(uint32 mapId) const
+    {
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        return itr != loadedMMaps.end() ? itr->second->navMesh : NULL;
+    }
 
-        return loadedMMaps[mapId]->navMesh;
+    MMapPathCache* MMapManager::GetPathCacheLocked(uint32 mapId)
+    {
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        return itr != loadedMMaps.end() ? &itr->second->pathCache : NULL;
     }
 
     dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
     {
+        {
+            ReadGuard guard(m_lock);
+
+            MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+            if (itr == loadedMMaps.end())
+                return NULL;
+
+            NavMeshQuerySet::const_iterator query = itr->second->navMeshQueries.find(instanceId);
+            if (query != itr->second->navMeshQueries.end())
+                return query->second;
+        }
+
+        WriteGuard guard(m_lock);
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
             return NULL;
 
@@ -322,4 +409,66 @@ namespace MMAP
 
         return mmap->navMeshQueries[instanceId];
     }
+
+    bool MMapPathCache::Find(dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef* path, uint32& length, uint32 maxLength)
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+        EntryMap::iterator itr = m_entries.find(Key(startPoly, endPoly, filter));
+        if (itr == m_entries.end())
+            return false;
+
+        if (WorldTimer::getMSTimeDiff(itr->second.time, WorldTimer::getMSTime()) > MMAP_PATH_CACHE_EXPIRE)
+        {
+            m_entries.erase(itr);
+            return false;
+        }
+
+        if (itr->second.path.size() > maxLength)
+            return false;
+
+        length = itr->second.path.size();
+        memcpy(path, &itr->second.path[0], length * sizeof(dtPolyRef));
+        return true;
+    }
+
+    void MMapPathCache::Store(dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef const* path, uint32 length)
+    {
+        if (!length)
+            return;
+
+        uint32 now = WorldTimer::getMSTime();
+
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+        if (m_entries.size() >= MMAP_PATH_CACHE_SIZE)
+        {
+            RemoveExpired(now);
+
+            // burst of unique searches, don't let it grow
+            if (m_entries.size() >= MMAP_PATH_CACHE_SIZE)
+                m_entries.clear();
+        }
+
+        Entry& entry = m_entries[Key(startPoly, endPoly, filter)];
+        entry.path.assign(path, path + length);
+        entry.time = now;
+    }
+
+    void MMapPathCache::Clear()
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        m_entries.clear();
+    }
+
+    void MMapPathCache::RemoveExpired(uint32 now)
+    {
+        for (EntryMap::iterator itr = m_entries.begin(); itr != m_entries.end();)
+        {
+            if (WorldTimer::getMSTimeDiff(itr->second.time, now) > MMAP_PATH_CACHE_EXPIRE)
+                m_entries.erase(itr++);
+            else
+                ++itr;
+        }
+    }
 }
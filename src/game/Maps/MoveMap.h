@@ -22,6 +22,12 @@
 
 #include "Utilities/UnorderedMap.h"
 
+#include <ace/RW_Thread_Mutex.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Guard_T.h>
+#include <map>
+#include <vector>
+
 #include "../../dep/recastnavigation/Detour/Include/DetourAlloc.h"
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMesh.h"
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMeshQuery.h"
@@ -43,6 +49,60 @@ namespace MMAP
     typedef UNORDERED_MAP<uint32, dtTileRef> MMapTileSet;
     typedef UNORDERED_MAP<uint32, dtNavMeshQuery*> NavMeshQuerySet;
 
+    // cached poly paths are dropped after (ms)
+    #define MMAP_PATH_CACHE_EXPIRE      1000
+    #define MMAP_PATH_CACHE_SIZE        512
+
+    // poly paths found recently on one navmesh
+    //
+    // mobs chasing the same target search between the same polygons many
+    // times within a second, those searches are answered from here. Poly
+    // refs are valid for all instances of the map, so the cache belongs to
+    // navmesh and is cleared whenever a tile is added or removed.
+    class MMapPathCache
+    {
+        public:
+            MMapPathCache() {}
+
+            // false when there is no fresh path or it does not fit into maxLength
+            bool Find(dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef* path, uint32& length, uint32 maxLength);
+            void Store(dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef const* path, uint32 length);
+            void Clear();
+
+        private:
+            struct Key
+            {
+                Key(dtPolyRef start, dtPolyRef end, dtQueryFilter const& filter) :
+                    startPoly(start), endPoly(end), flags((uint32(filter.getIncludeFlags()) << 16) | filter.getExcludeFlags()) {}
+
+                bool operator<(Key const& other) const
+                {
+                    if (startPoly != other.startPoly)
+                        return startPoly < other.startPoly;
+                    if (endPoly != other.endPoly)
+                        return endPoly < other.endPoly;
+                    return flags < other.flags;
+                }
+
+                dtPolyRef startPoly;
+                dtPolyRef endPoly;
+                uint32 flags;
+            };
+
+            struct Entry
+            {
+                std::vector<dtPolyRef> path;
+                uint32 time;
+            };
+
+            typedef std::map<Key, Entry> EntryMap;
+
+            void RemoveExpired(uint32 now);
+
+            ACE_Thread_Mutex m_lock;
+            EntryMap m_entries;
+    };
+
     // dummy struct to hold map's mmap data
     struct MMapData
     {
@@ -61,20 +121,39 @@ namespace MMAP
         // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
         NavMeshQuerySet navMeshQueries;     // instanceId to query
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
+        MMapPathCache pathCache;
     };
 
 
     typedef UNORDERED_MAP<uint32, MMapData*> MMapDataSet;
 
+    // tile file read into memory but not linked into navmesh yet
+    struct MMapTileData
+    {
+        MMapTileData() : data(NULL), size(0) {}
+
+        unsigned char* data;                // dtAlloc()ed, owned by navmesh once loadMap() succeeds
+        uint32 size;
+    };
+
     // singelton class
     // holds all all access to mmap loading unloading and meshes
+    //
+    // tiles are added and removed by map threads while async path finder
+    // workers query the same meshes, so navmesh changes are done under write
+    // lock and every path search has to hold the read lock
     class MMapManager
     {
         public:
+            typedef ACE_RW_Thread_Mutex         LockType;
+            typedef ACE_Read_Guard<LockType>    ReadGuard;
+            typedef ACE_Write_Guard<LockType>   WriteGuard;
+
             MMapManager() : loadedTiles(0) {}
             ~MMapManager();
 
-            bool loadMap(uint32 mapId, int32 x, int32 y);
+            // prefetched: tile read by readTile() on other thread (data may be NULL when file is missing)
+            bool loadMap(uint32 mapId, int32 x, int32 y, MMapTileData* prefetched = NULL);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
             bool unloadMapInstance(uint32 mapId, uint32 instanceId);
@@ -82,15 +161,27 @@ namespace MMAP
             // the returned [dtNavMeshQuery const*] is NOT threadsafe
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
+            // same as GetNavMesh() for callers already holding the read lock
+            dtNavMesh const* GetNavMeshLocked(uint32 mapId) const;
+            // NULL when mmap is not loaded, caller must hold the read lock
+            MMapPathCache* GetPathCacheLocked(uint32 mapId);
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
+
+            LockType& GetLock() { return m_lock; }
+
+            // file access only, safe from any thread
+            static bool readTile(uint32 mapId, int32 x, int32 y, MMapTileData& tile);
+            static void freeTile(MMapTileData& tile);
         private:
             bool loadMapData(uint32 mapId);
             uint32 packTileID(int32 x, int32 y);
 
             MMapDataSet loadedMMaps;
             uint32 loadedTiles;
+
+            LockType m_lock;
     };
 
     // static class
@@ -21,24 +21,26 @@
 #include "GridMap.h"
 #include "Creature.h"
 #include "PathFinder.h"
+#include "PathFinderQueue.h"
 #include "Log.h"
 
 #include "../recastnavigation/Detour/Include/DetourCommon.h"
 
 ////////////////// PathFinder //////////////////
 PathFinder::PathFinder(const Unit* owner) :
-    m_polyLength(0), m_type(PATHFIND_BLANK),
+    m_polyLength(0), m_corridorPatches(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH),
-    m_sourceUnit(owner), m_navMesh(NULL), m_navMeshQuery(NULL)
+    m_sourceUnit(owner), m_navMesh(NULL), m_navMeshQuery(NULL),
+    m_mapId(owner->GetMapId()), m_ownerGuidLow(owner->GetGUIDLow()), m_ownerIsCreature(owner->GetTypeId() == TYPEID_UNIT),
+    m_ownerCanFly(false), m_ownerCanSwim(false), m_startInWater(false), m_endInWater(false), m_pathCache(NULL)
 {
     //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
 
     if (m_sourceUnit->GetTerrain() && m_sourceUnit->GetTerrain()->IsPathFindingEnabled())
     {
-        uint32 mapId = m_sourceUnit->GetMapId();
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        m_navMesh = mmap->GetNavMesh(mapId);
-        m_navMeshQuery = mmap->GetNavMeshQuery(mapId, m_sourceUnit->GetInstanceId());
+        m_navMesh = mmap->GetNavMesh(m_mapId);
+        m_navMeshQuery = mmap->GetNavMeshQuery(m_mapId, m_sourceUnit->GetInstanceId());
     }
 
     createFilter();
@@ -50,12 +52,29 @@ PathFinder::~PathFinder()
 }
 
 bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest)
+{
+    switch (prepare(destX, destY, destZ, forceDest))
+    {
+        case PATH_PREPARE_UNCHANGED:
+            return false;
+        case PATH_PREPARE_SEARCH:
+            search();
+            break;
+        default:
+            break;
+    }
+
+    finalize();
+    return true;
+}
+
+PathPrepareResult PathFinder::prepare(float destX, float destY, float destZ, bool forceDest)
 {
     float x, y, z;
     m_sourceUnit->GetPosition(x, y, z);
 
     if (!MaNGOS::IsValidMapCoord(destX, destY, destZ) || !MaNGOS::IsValidMapCoord(x, y, z))
-        return false;
+        return PATH_PREPARE_UNCHANGED;
 
     Vector3 oldDest = getEndPosition();
     Vector3 dest(destX, destY, destZ);
@@ -70,15 +89,23 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
 
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
-    if (!m_navMesh || !m_navMeshQuery || m_sourceUnit->HasUnitState(UNIT_STAT_IGNORE_PATHFINDING) ||
-        !HaveTile(start) || !HaveTile(dest))
+    bool useNavMesh = m_navMesh && m_navMeshQuery && !m_sourceUnit->HasUnitState(UNIT_STAT_IGNORE_PATHFINDING);
+    if (useNavMesh)
+    {
+        MMAP::MMapManager::ReadGuard guard(MMAP::MMapFactory::createOrGetMMapManager()->GetLock());
+        useNavMesh = HaveTile(start) && HaveTile(dest);
+    }
+
+    if (!useNavMesh)
     {
         BuildShortcut();
         m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
-        return true;
+        return PATH_PREPARE_READY;
     }
 
-    updateFilter();
+    // owner stands at start, the same terrain lookup serves the filter and BuildPolyPath()
+    m_startInWater = m_sourceUnit->GetTerrain()->IsInWater(start.x, start.y, start.z);
+    updateFilter(m_startInWater);
 
     // check if destination moved - if not we can optimize something here
     // we are following old, precalculated path?
@@ -90,14 +117,72 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
         //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate:: precalculated path\n");
 
         m_pathPoints.erase(m_pathPoints.begin());
-        return false;
+        return PATH_PREPARE_UNCHANGED;
     }
-    else
+
+    // target moved, so we need to update the poly path
+    // snapshot everything BuildPolyPath() would ask the owner about
+    if (m_ownerIsCreature)
+    {
+        Creature const* creature = m_sourceUnit->ToCreature();
+        m_ownerCanFly = creature->CanFly();
+        m_ownerCanSwim = creature->CanSwim();
+        m_endInWater = m_sourceUnit->GetTerrain()->IsInWater(dest.x, dest.y, dest.z);
+    }
+
+    return PATH_PREPARE_SEARCH;
+}
+
+void PathFinder::search(dtNavMeshQuery const* query, bool retryForced)
+{
+    uint64 start = WorldTimer::getUSTime();
     {
-        // target moved, so we need to update the poly path
-        BuildPolyPath(start, dest);
-        return true;
+        MMAP::MMapManager::ReadGuard guard(MMAP::MMapFactory::createOrGetMMapManager()->GetLock());
+        searchLocked(query, retryForced);
     }
+    sPathFinderQueue.RecordSyncSearch(uint32(WorldTimer::getUSTime() - start));
+}
+
+void PathFinder::searchLocked(dtNavMeshQuery const* query, bool retryForced)
+{
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+
+    // m_navMesh was taken at construction, mmap may have been unloaded or reloaded since;
+    // only the mesh looked up under the lock is safe to touch until the lock is released
+    dtNavMesh const* navMesh = mmap->GetNavMeshLocked(m_mapId);
+    if (!navMesh || (!query && navMesh != m_navMesh))
+    {
+        BuildShortcut();
+        m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        return;
+    }
+
+    // path finder queue workers can't share owner's query
+    dtNavMesh const* ownNavMesh = m_navMesh;
+    dtNavMeshQuery const* ownQuery = m_navMeshQuery;
+    m_navMesh = navMesh;
+    if (query)
+        m_navMeshQuery = query;
+
+    m_pathCache = mmap->GetPathCacheLocked(m_mapId);
+
+    BuildPolyPath(getStartPosition(), getEndPosition());
+
+    if (retryForced && !m_forceDestination && (m_type & PATHFIND_NOPATH))
+    {
+        m_forceDestination = true;
+        setEndPosition(getEndPosition());
+        BuildPolyPath(getStartPosition(), getEndPosition());
+    }
+
+    m_pathCache = NULL;
+    m_navMesh = ownNavMesh;
+    m_navMeshQuery = ownQuery;
+}
+
+void PathFinder::finalize()
+{
+    NormalizePath();
 }
 
 dtPolyRef PathFinder::getPathPolyByPosition(const dtPolyRef *polyPath, uint32 polyPathSize, const float* point, float *distance) const
@@ -186,19 +271,9 @@ void PathFinder::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
         //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (startPoly == 0 || endPoly == 0)\n");
         BuildShortcut();
 
-        bool path = m_sourceUnit->GetTypeId() == TYPEID_UNIT && m_sourceUnit->ToCreature()->CanFly();
-        bool waterPath = m_sourceUnit->GetTypeId() == TYPEID_UNIT && m_sourceUnit->ToCreature()->CanSwim();
-        if (waterPath)
-        {
-            // Check both start and end points, if they're both in water, then we can *safely* let the creature move
-            for (int i = 0; i < m_pathPoints.size(); ++i)
-            {
-                if (waterPath = m_sourceUnit->GetTerrain()->IsInWater(m_pathPoints[i].x, m_pathPoints[i].y, m_pathPoints[i].z))
-                    continue;
-
-                break;
-            }
-        }
+        bool path = m_ownerIsCreature && m_ownerCanFly;
+        // Check both start and end points, if they're both in water, then we can *safely* let the creature move
+        bool waterPath = m_ownerIsCreature && m_ownerCanSwim && m_startInWater && m_endInWater;
 
         m_type = (path || waterPath) ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
         return;
@@ -211,21 +286,19 @@ void PathFinder::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
         //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: farFromPoly distToStartPoly=%.3f distToEndPoly=%.3f\n", distToStartPoly, distToEndPoly);
 
         bool buildShotrcut = false;
-        if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        if (m_ownerIsCreature)
         {
-            Creature* owner = (Creature*)m_sourceUnit;
-
-            Vector3 p = (distToStartPoly > 7.0f) ? startPos : endPos;
-            if (m_sourceUnit->GetTerrain()->IsInWater(p.x, p.y, p.z))
+            bool inWater = (distToStartPoly > 7.0f) ? m_startInWater : m_endInWater;
+            if (inWater)
             {
                 //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: underWater case\n");
-                if (owner->CanSwim())
+                if (m_ownerCanSwim)
                     buildShotrcut = true;
             }
             else
             {
                 //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: flying case\n");
-                if (owner->CanFly())
+                if (m_ownerCanFly)
                     buildShotrcut = true;
             }
         }
@@ -264,6 +337,7 @@ void PathFinder::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
         m_polyLength = 1;
 
         m_type = farFromPoly ? PATHFIND_INCOMPLETE : PATHFIND_NORMAL;
+        UpdateCorridorEnd(endPoint);
         //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: path type %d\n", m_type);
         return;
     }
@@ -307,6 +381,12 @@ void PathFinder::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
         m_polyLength = pathEndIndex - pathStartIndex + 1;
         memmove(m_pathPolyRefs, m_pathPolyRefs+pathStartIndex, m_polyLength*sizeof(dtPolyRef));
     }
+    else if (startPolyFound && PatchCorridorEnd(pathStartIndex, endPoly, endPoint))
+    {
+        // target made only a small step out of our poly-path
+        // corridor was extended to its new poly without any search
+        sPathFinderQueue.RecordCorridorPatch();
+    }
     else if (startPolyFound && !endPolyFound)
     {
         //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (startPolyFound && !endPolyFound)\n");
@@ -315,6 +395,7 @@ void PathFinder::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
         // so we have atleast part of poly-path ready
 
         m_polyLength -= pathStartIndex;
+        m_corridorPatches = 0;
 
         // try to adjust the suffix of the path instead of recalculating entire length
         // at given interval the target cannot get too far from its last location
@@ -347,14 +428,13 @@ void PathFinder::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
 
         // generate suffix
         uint32 suffixPolyLength = 0;
-        dtStatus dtResult = m_navMeshQuery->findPath(
+        dtStatus dtResult = FindPolyPath(
                                 suffixStartPoly,    // start polygon
                                 endPoly,            // end polygon
                                 suffixEndPoint,     // start position
                                 endPoint,           // end position
-                                &m_filter,            // polygon search filter
                                 m_pathPolyRefs + prefixPolyLength - 1,    // [out] path
-                                (int*)&suffixPolyLength,
+                                suffixPolyLength,
                                 MAX_PATH_LENGTH-prefixPolyLength);   // max number of polygons in output path
 
         if (!suffixPolyLength || dtResult != DT_SUCCESS)
@@ -362,7 +442,7 @@ void PathFinder::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
             // this is probably an error state, but we'll leave it
             // and hopefully recover on the next Update
             // we still need to copy our preffix
-            sLog.outLog(LOG_DEFAULT, "ERROR: %u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
+            sLog.outLog(LOG_DEFAULT, "ERROR: %u's Path Build failed: 0 length path", m_ownerGuidLow);
         }
 
         //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++  m_polyLength=%u prefixPolyLength=%u suffixPolyLength=%u \n",m_polyLength, prefixPolyLength, suffixPolyLength);
@@ -381,20 +461,19 @@ void PathFinder::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
         // free and invalidate old path data
         clear();
 
-        dtStatus dtResult = m_navMeshQuery->findPath(
+        dtStatus dtResult = FindPolyPath(
                 startPoly,          // start polygon
                 endPoly,            // end polygon
                 startPoint,         // start position
                 endPoint,           // end position
-                &m_filter,           // polygon search filter
                 m_pathPolyRefs,     // [out] path
-                (int*)&m_polyLength,
+                m_polyLength,
                 MAX_PATH_LENGTH);   // max number of polygons in output path
 
         if (!m_polyLength || dtResult != DT_SUCCESS)
         {
             // only happens if we passed bad data to findPath(), or navmesh is messed up
-            sLog.outLog(LOG_DEFAULT, "ERROR: %u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
+            sLog.outLog(LOG_DEFAULT, "ERROR: %u's Path Build failed: 0 length path", m_ownerGuidLow);
             BuildShortcut();
             m_type = PATHFIND_NOPATH;
             return;
@@ -407,10 +486,96 @@ void PathFinder::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
     else
         m_type = PATHFIND_INCOMPLETE;
 
+    UpdateCorridorEnd(endPoint);
+
     // generate the point-path out of our up-to-date poly-path
     BuildPointPath(startPoint, endPoint);
 }
 
+void PathFinder::UpdateCorridorEnd(const float* endPoint)
+{
+    // corridor that does not reach its end point can't be extended from there
+    if (m_type == PATHFIND_NORMAL)
+        dtVcopy(m_corridorEnd, endPoint);
+    else
+        m_corridorPatches = PATH_CORRIDOR_MAX_PATCHES;
+}
+
+bool PathFinder::PatchCorridorEnd(uint32 pathStartIndex, dtPolyRef endPoly, const float* endPoint)
+{
+    // long chases drift away from optimal path, give it a real search from time to time
+    if (m_corridorPatches >= PATH_CORRIDOR_MAX_PATCHES)
+        return false;
+
+    if (dtVdist2DSqr(m_corridorEnd, endPoint) > PATH_CORRIDOR_PATCH_DIST * PATH_CORRIDOR_PATCH_DIST)
+        return false;
+
+    dtPolyRef* path = m_pathPolyRefs + pathStartIndex;
+    uint32 pathLength = m_polyLength - pathStartIndex;
+
+    // walk from old corridor end to the new one, same as dtPathCorridor::moveTargetPosition()
+    float resultPoint[VERTEX_SIZE];
+    dtPolyRef visited[PATH_CORRIDOR_MAX_VISITED];
+    int visitedCount = 0;
+    if (DT_SUCCESS != m_navMeshQuery->moveAlongSurface(path[pathLength - 1], m_corridorEnd, endPoint, &m_filter,
+                                                       resultPoint, visited, &visitedCount, PATH_CORRIDOR_MAX_VISITED))
+        return false;
+
+    // stopped at a wall or ended on different floor, needs a search
+    if (!visitedCount || visited[visitedCount - 1] != endPoly || dtVdist2DSqr(resultPoint, endPoint) > 0.25f)
+        return false;
+
+    // furthest poly both have in common, visited polys replace everything behind it
+    int furthestPath = -1;
+    int furthestVisited = -1;
+    for (int i = int(pathLength) - 1; i >= 0 && furthestPath < 0; --i)
+    {
+        for (int j = visitedCount - 1; j >= 0; --j)
+        {
+            if (path[i] == visited[j])
+            {
+                furthestPath = i;
+                furthestVisited = j;
+                break;
+            }
+        }
+    }
+
+    if (furthestPath < 0)
+        return false;
+
+    uint32 suffixLength = visitedCount - furthestVisited;
+    if (furthestPath + suffixLength > MAX_PATH_LENGTH)
+        return false;
+
+    memmove(m_pathPolyRefs, path, furthestPath * sizeof(dtPolyRef));
+    memcpy(m_pathPolyRefs + furthestPath, visited + furthestVisited, suffixLength * sizeof(dtPolyRef));
+    m_polyLength = furthestPath + suffixLength;
+
+    ++m_corridorPatches;
+    return true;
+}
+
+dtStatus PathFinder::FindPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPoint, const float* endPoint,
+                                  dtPolyRef* path, uint32& pathLength, uint32 maxPathLength)
+{
+    // someone else searched between the same polys a moment ago
+    if (m_pathCache && m_pathCache->Find(startPoly, endPoly, m_filter, path, pathLength, maxPathLength))
+    {
+        sPathFinderQueue.RecordCacheHit();
+        return DT_SUCCESS;
+    }
+
+    int length = 0;
+    dtStatus result = m_navMeshQuery->findPath(startPoly, endPoly, startPoint, endPoint, &m_filter, path, &length, maxPathLength);
+    pathLength = length;
+
+    if (m_pathCache && result == DT_SUCCESS)
+        m_pathCache->Store(startPoly, endPoly, m_filter, path, pathLength);
+
+    return result;
+}
+
 void PathFinder::BuildPointPath(const float *startPoint, const float *endPoint)
 {
     float pathPoints[MAX_POINT_PATH_LENGTH*VERTEX_SIZE];
@@ -462,8 +627,6 @@ void PathFinder::BuildPointPath(const float *startPoint, const float *endPoint)
     for (uint32 i = 0; i < pointCount; ++i)
         m_pathPoints[i] = Vector3(pathPoints[i*VERTEX_SIZE+2], pathPoints[i*VERTEX_SIZE], pathPoints[i*VERTEX_SIZE+1]);
 
-    NormalizePath();
-
     // first point is always our current location - we need the next one
     setActualEndPosition(m_pathPoints[pointCount-1]);
 
@@ -509,8 +672,6 @@ void PathFinder::BuildShortcut()
     m_pathPoints[0] = getStartPosition();
     m_pathPoints[1] = getActualEndPosition();
 
-    NormalizePath();
-
     m_type = PATHFIND_SHORTCUT;
 }
 
@@ -538,14 +699,15 @@ void PathFinder::createFilter()
     m_filter.setIncludeFlags(includeFlags);
     m_filter.setExcludeFlags(excludeFlags);
 
-    updateFilter();
+    updateFilter(m_sourceUnit->IsInWater());
 }
 
-void PathFinder::updateFilter()
+void PathFinder::updateFilter(bool inWater)
 {
     // allow creatures to cheat and use different movement types if they are moved
     // forcefully into terrain they can't normally move in
-    if (m_sourceUnit->IsInWater() || m_sourceUnit->IsUnderWater())
+    // (under water implies in water, any liquid status counts for IsInWater)
+    if (inWater)
     {
         uint16 includedFlags = m_filter.getIncludeFlags();
         includedFlags |= getNavTerrain(m_sourceUnit->GetPositionX(),
@@ -31,6 +31,11 @@ using Movement::PointsArray;
 
 class Unit;
 
+namespace MMAP
+{
+    class MMapPathCache;
+}
+
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
 // I think we can safely cut those down even more
@@ -43,6 +48,12 @@ class Unit;
 #define VERTEX_SIZE       3
 #define INVALID_POLYREF   0
 
+// chased target that moved less than this is followed by extending current corridor
+#define PATH_CORRIDOR_PATCH_DIST    8.0f
+// patched corridors drift from optimal path, search again after this many patches
+#define PATH_CORRIDOR_MAX_PATCHES   8
+#define PATH_CORRIDOR_MAX_VISITED   16
+
 enum PathType
 {
     PATHFIND_BLANK          = 0x0000,   // path not built yet
@@ -54,8 +65,17 @@ enum PathType
     PATHFIND_SHORT          = 0x0020    // too long path, truncating
 };
 
+enum PathPrepareResult
+{
+    PATH_PREPARE_UNCHANGED  = 0,        // following precalculated path, nothing to do
+    PATH_PREPARE_READY      = 1,        // path built without navmesh, only finalize() is needed
+    PATH_PREPARE_SEARCH     = 2         // navmesh search() needed before finalize()
+};
+
 class PathFinder
 {
+    friend class PathFinderQueue;
+
     public:
         PathFinder(Unit const* owner);
         ~PathFinder();
@@ -63,12 +83,23 @@ class PathFinder
         // Calculate the path from owner to given destination
         // return: true if new path was calculated, false otherwise (no change needed)
         bool calculate(float destX, float destY, float destZ, bool forceDest = false);
+
+        // calculate() split in steps, so the navmesh search can run on path finder queue
+        // prepare() and finalize() need the owner and must be called from its map thread,
+        // search() uses only data snapshotted by prepare() and is safe on any thread
+        // retryForced: when no path is found, search again with forced destination
+        PathPrepareResult prepare(float destX, float destY, float destZ, bool forceDest = false);
+        void search(dtNavMeshQuery const* query = NULL, bool retryForced = false);
+        void finalize();
+
+        uint32 getMapId() const { return m_mapId; }
         // after calculating we can make our path a bit shorter (to arive distance before end point)
         void stepBack(float distance);
         // we like to start calculations from begining
         void reinitialize()
         {
             m_polyLength = 0;
+            m_corridorPatches = 0;
             m_pathPoints.clear();
             m_type = PATHFIND_BLANK;
         };
@@ -90,6 +121,8 @@ class PathFinder
 
         dtPolyRef      m_pathPolyRefs[MAX_PATH_LENGTH];   // array of detour polygon references
         uint32         m_polyLength;                      // number of polygons in the path
+        float          m_corridorEnd[VERTEX_SIZE];        // end point poly path was built for, YZX
+        uint32         m_corridorPatches;                 // end moves followed without search
 
         PointsArray    m_pathPoints;       // our actual (x,y,z) path to the target
         PathType       m_type;             // tells what kind of path this is
@@ -102,11 +135,21 @@ class PathFinder
         Vector3        m_endPosition;      // {x, y, z} of the destination
         Vector3        m_actualEndPosition;// {x, y, z} of the closest possible point to given destination
 
-        const Unit* const       m_sourceUnit;       // the unit that is moving
+        const Unit* const       m_sourceUnit;       // the unit that is moving, never touched by search()
         const dtNavMesh*        m_navMesh;          // the nav mesh
         const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
 
+        // owner state snapshotted by prepare() for search()
+        uint32         m_mapId;
+        uint32         m_ownerGuidLow;
+        bool           m_ownerIsCreature;
+        bool           m_ownerCanFly;
+        bool           m_ownerCanSwim;
+        bool           m_startInWater;
+        bool           m_endInWater;
+
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
+        MMAP::MMapPathCache* m_pathCache;           // set only during searchLocked()
 
         void setStartPosition(Vector3 point) { m_startPosition = point; }
         void setEndPosition(Vector3 point) { m_actualEndPosition = point; m_endPosition = point; }
@@ -115,6 +158,7 @@ class PathFinder
         void clear()
         {
             m_polyLength = 0;
+            m_corridorPatches = 0;
             m_pathPoints.clear();
         }
 
@@ -127,14 +171,22 @@ class PathFinder
         bool HaveTile(const Vector3 &p) const;
 
         void BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos);
+        void UpdateCorridorEnd(const float* endPoint);
+        bool PatchCorridorEnd(uint32 pathStartIndex, dtPolyRef endPoly, const float* endPoint);
+        dtStatus FindPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPoint, const float* endPoint,
+                              dtPolyRef* path, uint32& pathLength, uint32 maxPathLength);
         void BuildPointPath(const float *startPoint, const float *endPoint);
         void BuildShortcut();
 
         void NormalizePath();
 
+        // search() for caller already holding mmap read lock, uses the mesh loaded now
+        // instead of m_navMesh, query must belong to that mesh
+        void searchLocked(dtNavMeshQuery const* query, bool retryForced);
+
         NavTerrain getNavTerrain(float x, float y, float z);
         void createFilter();
-        void updateFilter();
+        void updateFilter(bool inWater);
 
         // smooth path aux functions
         uint32 fixupCorridor(dtPolyRef* path, uint32 npath, uint32 maxPath,
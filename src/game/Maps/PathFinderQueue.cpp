@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "PathFinderQueue.h"
+#include "MoveMap.h"
+#include "Log.h"
+#include "Profiler.h"
+
+#include <ace/Method_Request.h>
+#include <ace/TSS_T.h>
+
+#include <map>
+
+struct PathFinderWorkerSlot
+{
+    // mapId -> navmesh the query was created for and the query itself
+    typedef std::map<uint32, std::pair<dtNavMesh const*, dtNavMeshQuery*> > QueryMap;
+
+    ~PathFinderWorkerSlot()
+    {
+        for (QueryMap::iterator itr = queries.begin(); itr != queries.end(); ++itr)
+            dtFreeNavMeshQuery(itr->second.second);
+    }
+
+    // caller must hold mmap read lock
+    dtNavMeshQuery const* GetQuery(MMAP::MMapManager const* mmap, uint32 mapId)
+    {
+        dtNavMesh const* navMesh = mmap->GetNavMeshLocked(mapId);
+        if (!navMesh)
+            return NULL;
+
+        QueryMap::iterator itr = queries.find(mapId);
+        if (itr != queries.end())
+        {
+            if (itr->second.first == navMesh)
+                return itr->second.second;
+
+            // mmap was reloaded since, query points to freed mesh
+            dtFreeNavMeshQuery(itr->second.second);
+            queries.erase(itr);
+        }
+
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        ASSERT(query);
+        if (DT_SUCCESS != query->init(navMesh, 1024))
+        {
+            dtFreeNavMeshQuery(query);
+            sLog.outLog(LOG_DEFAULT, "ERROR: PathFinderQueue: Failed to initialize dtNavMeshQuery for mapId %03u", mapId);
+            return NULL;
+        }
+
+        queries[mapId] = std::make_pair(navMesh, query);
+        return query;
+    }
+
+    QueryMap queries;
+};
+
+typedef ACE_TSS<PathFinderWorkerSlot> PathFinderWorkerSlotTSS;
+
+static PathFinderWorkerSlotTSS workerSlot;
+
+class PathSearchRequest : public ACE_Method_Request
+{
+    public:
+        PathSearchRequest(PathRequestPtr const& request) : m_request(request) {}
+
+        virtual int call(void)
+        {
+            sPathFinderQueue.Process(m_request);
+            return 0;
+        }
+
+    private:
+        PathRequestPtr m_request;
+};
+
+PathFinderQueue::PathFinderQueue() : m_active(false), m_threads(0), m_pending(0)
+{
+    ResetStats();
+}
+
+PathFinderQueue::~PathFinderQueue()
+{
+    Deactivate();
+}
+
+bool PathFinderQueue::Activate(uint32 threads)
+{
+    if (m_active || !threads)
+        return false;
+
+    if (m_executor.activate(int(threads)) == -1)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: PathFinderQueue: cannot start %u threads, path finding stays synchronous", threads);
+        return false;
+    }
+
+    m_threads = threads;
+    m_active = true;
+    return true;
+}
+
+void PathFinderQueue::Deactivate()
+{
+    if (!m_active)
+        return;
+
+    // requests still queued are dropped, their owners are being unloaded anyway
+    m_active = false;
+    m_executor.deactivate();
+}
+
+PathRequestPtr PathFinderQueue::Schedule(PathFinder const& path, bool retryForced)
+{
+    if (!m_active)
+        return PathRequestPtr();
+
+    PathRequestPtr request = std::make_shared<PathRequest>(path, retryForced);
+
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    if (m_executor.execute(new PathSearchRequest(request)) == -1)
+    {
+        m_pending.fetch_sub(1, std::memory_order_relaxed);
+        return PathRequestPtr();
+    }
+
+    return request;
+}
+
+void PathFinderQueue::Process(PathRequestPtr const& request)
+{
+    uint64 start = WorldTimer::getUSTime();
+    uint32 wait = uint32(start - request->m_queueTime);
+
+    m_pending.fetch_sub(1, std::memory_order_relaxed);
+    m_queueWait.fetch_add(wait, std::memory_order_relaxed);
+    StoreMax(m_queueWaitMax, wait);
+
+    // owner dropped the request (new target, generator removed, ...)
+    if (request.use_count() == 1)
+    {
+        m_cancelled.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    PathRequestState state = PATH_REQUEST_FAILED;
+    {
+        ProfileZone zone("PathFinderQueue::Process");
+
+        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+        MMAP::MMapManager::ReadGuard guard(mmap->GetLock());
+
+        if (dtNavMeshQuery const* query = workerSlot->GetQuery(mmap, request->m_path.getMapId()))
+        {
+            request->m_path.searchLocked(query, request->m_retryForced);
+            state = PATH_REQUEST_DONE;
+        }
+    }
+
+    if (state == PATH_REQUEST_DONE)
+    {
+        uint32 time = uint32(WorldTimer::getUSTime() - start);
+        m_asyncSearches.fetch_add(1, std::memory_order_relaxed);
+        m_asyncTime.fetch_add(time, std::memory_order_relaxed);
+        StoreMax(m_asyncTimeMax, time);
+    }
+    else
+        m_failed.fetch_add(1, std::memory_order_relaxed);
+
+    request->m_state.store(state, std::memory_order_release);
+}
+
+void PathFinderQueue::RecordSyncSearch(uint32 time)
+{
+    m_syncSearches.fetch_add(1, std::memory_order_relaxed);
+    m_syncTime.fetch_add(time, std::memory_order_relaxed);
+}
+
+void PathFinderQueue::ResetStats()
+{
+    m_syncSearches.store(0, std::memory_order_relaxed);
+    m_syncTime.store(0, std::memory_order_relaxed);
+    m_asyncSearches.store(0, std::memory_order_relaxed);
+    m_asyncTime.store(0, std::memory_order_relaxed);
+    m_asyncTimeMax.store(0, std::memory_order_relaxed);
+    m_queueWait.store(0, std::memory_order_relaxed);
+    m_queueWaitMax.store(0, std::memory_order_relaxed);
+    m_cancelled.store(0, std::memory_order_relaxed);
+    m_failed.store(0, std::memory_order_relaxed);
+    m_corridorPatches.store(0, std::memory_order_relaxed);
+    m_cacheHits.store(0, std::memory_order_relaxed);
+}
+
+void PathFinderQueue::StoreMax(std::atomic<uint32>& value, uint32 candidate)
+{
+    uint32 current = value.load(std::memory_order_relaxed);
+    while (current < candidate && !value.compare_exchange_weak(current, candidate, std::memory_order_relaxed));
+}
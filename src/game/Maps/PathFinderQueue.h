@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _PATH_FINDER_QUEUE_H
+#define _PATH_FINDER_QUEUE_H
+
+#include "Common.h"
+#include "DelayExecutor.h"
+#include "PathFinder.h"
+#include "Timer.h"
+
+#include <ace/Singleton.h>
+#include <ace/Thread_Mutex.h>
+#include <atomic>
+#include <memory>
+
+enum PathRequestState
+{
+    PATH_REQUEST_QUEUED     = 0,
+    PATH_REQUEST_DONE       = 1,                            // searched, finalize() on owner's map thread
+    PATH_REQUEST_FAILED     = 2                             // navmesh of map is gone, nothing searched
+};
+
+class PathRequest
+{
+    friend class PathFinderQueue;
+
+    public:
+        PathRequest(PathFinder const& path, bool retryForced) :
+            m_path(path), m_retryForced(retryForced), m_queueTime(WorldTimer::getUSTime()), m_state(PATH_REQUEST_QUEUED) {}
+
+        PathRequestState GetState() const { return PathRequestState(m_state.load(std::memory_order_acquire)); }
+        PathFinder const& GetPath() const { return m_path; }
+
+    private:
+        PathFinder m_path;                                  // owner's path copy, worker only until state changes
+        bool m_retryForced;
+        uint64 m_queueTime;
+        std::atomic<uint32> m_state;
+};
+
+typedef std::shared_ptr<PathRequest> PathRequestPtr;
+
+/**
+ * Runs navmesh searches of movement generators on worker threads.
+ *
+ * dtNavMeshQuery is not thread safe, so each worker keeps its own query per
+ * mmap instead of using the per instance ones from MMapManager. Requester
+ * keeps the returned PathRequestPtr and polls it on next ticks, dropping the
+ * pointer cancels the search if it did not start yet. Anything that can't
+ * wait (charges, spells, commands) keeps using PathFinder::calculate().
+ */
+class PathFinderQueue
+{
+    friend class ACE_Singleton<PathFinderQueue, ACE_Thread_Mutex>;
+
+    public:
+        bool Activate(uint32 threads);
+        void Deactivate();
+        bool IsActive() const { return m_active; }
+
+        // queue search() of path already prepare()d by owner, empty pointer when queue is not running
+        PathRequestPtr Schedule(PathFinder const& path, bool retryForced);
+
+        // worker thread only
+        void Process(PathRequestPtr const& request);
+
+        void RecordSyncSearch(uint32 time);
+        void RecordCorridorPatch() { m_corridorPatches.fetch_add(1, std::memory_order_relaxed); }
+        void RecordCacheHit() { m_cacheHits.fetch_add(1, std::memory_order_relaxed); }
+        void ResetStats();
+
+        uint32 GetThreads() const { return m_threads; }
+        uint32 GetPending() const { return m_pending.load(std::memory_order_relaxed); }
+        uint64 GetSyncSearches() const { return m_syncSearches.load(std::memory_order_relaxed); }
+        uint64 GetSyncTime() const { return m_syncTime.load(std::memory_order_relaxed); }
+        uint64 GetAsyncSearches() const { return m_asyncSearches.load(std::memory_order_relaxed); }
+        uint64 GetAsyncTime() const { return m_asyncTime.load(std::memory_order_relaxed); }
+        uint32 GetAsyncTimeMax() const { return m_asyncTimeMax.load(std::memory_order_relaxed); }
+        uint64 GetQueueWait() const { return m_queueWait.load(std::memory_order_relaxed); }
+        uint32 GetQueueWaitMax() const { return m_queueWaitMax.load(std::memory_order_relaxed); }
+        uint64 GetCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+        uint64 GetFailed() const { return m_failed.load(std::memory_order_relaxed); }
+        uint64 GetCorridorPatches() const { return m_corridorPatches.load(std::memory_order_relaxed); }
+        uint64 GetCacheHits() const { return m_cacheHits.load(std::memory_order_relaxed); }
+
+    private:
+        PathFinderQueue();
+        ~PathFinderQueue();
+
+        static void StoreMax(std::atomic<uint32>& value, uint32 candidate);
+
+        DelayExecutor m_executor;
+        bool m_active;
+        uint32 m_threads;
+
+        std::atomic<uint32> m_pending;
+        std::atomic<uint64> m_syncSearches;
+        std::atomic<uint64> m_syncTime;                     // microseconds
+        std::atomic<uint64> m_asyncSearches;
+        std::atomic<uint64> m_asyncTime;
+        std::atomic<uint32> m_asyncTimeMax;
+        std::atomic<uint64> m_queueWait;
+        std::atomic<uint32> m_queueWaitMax;
+        std::atomic<uint64> m_cancelled;
+        std::atomic<uint64> m_failed;
+        std::atomic<uint64> m_corridorPatches;              // target followed without findPath()
+        std::atomic<uint64> m_cacheHits;                    // findPath() answered from MMapPathCache
+};
+
+#define sPathFinderQueue (*ACE_Singleton<PathFinderQueue, ACE_Thread_Mutex>::instance())
+
+#endif
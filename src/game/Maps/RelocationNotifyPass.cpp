@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "RelocationNotifyPass.h"
+#include "Map.h"
+#include "Creature.h"
+#include "Player.h"
+#include "GridNotifiersImpl.h"
+#include "CellImpl.h"
+
+namespace MaNGOS
+{
+    // pairs every visited unit with movers of one bucket
+    struct RelocationBucketNotifier
+    {
+        RelocationNotifyPass const& _pass;
+        std::vector<RelocationMover> const& _movers;
+        uint32 const* _begin;
+        uint32 const* _end;
+        uint32 _pairs;
+
+        RelocationBucketNotifier(RelocationNotifyPass const& pass, std::vector<RelocationMover> const& movers, uint32 const* begin, uint32 const* end)
+            : _pass(pass), _movers(movers), _begin(begin), _end(end), _pairs(0) {}
+
+        void Visit(PlayerMapType& m)
+        {
+            for (PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+                Notify(iter->getSource());
+        }
+
+        void Visit(CreatureMapType& m)
+        {
+            for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+                Notify(iter->getSource());
+        }
+
+        template<class NOT_INTERESTED>
+        void Visit(GridRefManager<NOT_INTERESTED>&) {}
+
+        void Notify(Unit* target);
+    };
+
+    void RelocationBucketNotifier::Notify(Unit* target)
+    {
+        RelocationMover const* other = _pass.GetMover(target);
+        uint32 otherIndex = target->_GetAINotifyIndex();
+        bool targetIsPlayer = target->GetTypeId() == TYPEID_PLAYER;
+
+        for (uint32 const* itr = _begin; itr != _end; ++itr)
+        {
+            RelocationMover const& mover = _movers[*itr];
+            Unit* unit = mover.unit;
+            if (!unit || unit == target || !mover.reacting)
+                continue;
+
+            bool unitIsPlayer = unit->GetTypeId() == TYPEID_PLAYER;
+            if (unitIsPlayer && targetIsPlayer)
+                continue;
+
+            float dx = unit->GetPositionX() - target->GetPositionX();
+            float dy = unit->GetPositionY() - target->GetPositionY();
+            float distSq = dx * dx + dy * dy;
+            if (distSq > mover.radiusSq)
+                continue;
+
+            // both moved, the one earlier in queue takes the pair
+            if (other && other->reacting && otherIndex < *itr && distSq <= other->radiusSq)
+                continue;
+
+            if (unitIsPlayer)
+                PlayerCreatureRelocationWorker(unit->ToPlayer(), target->ToCreature());
+            else if (targetIsPlayer)
+                PlayerCreatureRelocationWorker(target->ToPlayer(), unit->ToCreature());
+            else
+            {
+                CreatureCreatureRelocationWorker(target->ToCreature(), unit->ToCreature());
+                CreatureCreatureRelocationWorker(unit->ToCreature(), target->ToCreature());
+            }
+
+            ++_pairs;
+        }
+    }
+}
+
+RelocationNotifyPass::RelocationNotifyPass() : m_clock(0), m_inPass(false),
+    m_passes(0), m_movers(0), m_visits(0), m_pairs(0), m_time(0)
+{
+}
+
+void RelocationNotifyPass::Schedule(Unit* unit, uint32 delay)
+{
+    unit->_SetAINotifyScheduled(true);
+    unit->_SetAINotifyIndex(m_queue.size());
+
+    Entry entry;
+    entry.unit = unit;
+    entry.due = m_clock + delay;
+    m_queue.push_back(entry);
+}
+
+void RelocationNotifyPass::Remove(Unit* unit)
+{
+    uint32 index = unit->_GetAINotifyIndex();
+    if (index == AI_NOTIFY_NOT_QUEUED)
+        return;
+
+    unit->_SetAINotifyScheduled(false);
+    unit->_SetAINotifyIndex(AI_NOTIFY_NOT_QUEUED);
+
+    // indexes must stay valid till the pass ends, Finish() drops the hole
+    if (m_inPass)
+    {
+        m_queue[index].unit = NULL;
+        if (index < m_due.size())
+            m_due[index].unit = NULL;
+        return;
+    }
+
+    if (index + 1 != m_queue.size())
+    {
+        m_queue[index] = m_queue.back();
+        m_queue[index].unit->_SetAINotifyIndex(index);
+    }
+    m_queue.pop_back();
+}
+
+RelocationMover const* RelocationNotifyPass::GetMover(Unit const* unit) const
+{
+    uint32 index = unit->_GetAINotifyIndex();
+    if (index < m_due.size() && m_due[index].unit == unit)
+        return &m_due[index];
+
+    return NULL;
+}
+
+void RelocationNotifyPass::Update(Map& map, uint32 diff)
+{
+    m_clock += diff;
+    if (m_queue.empty())
+        return;
+
+    uint64 start = WorldTimer::getUSTime();
+
+    m_buckets.clear();
+    for (uint32 i = 0; i < m_queue.size(); ++i)
+    {
+        Entry const& entry = m_queue[i];
+        if (entry.due > m_clock)
+            continue;
+
+        CellPair cell = MaNGOS::ComputeCellPair(entry.unit->GetPositionX(), entry.unit->GetPositionY());
+        m_buckets.push_back(std::make_pair(cell.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + cell.x_coord, i));
+    }
+
+    if (m_buckets.empty())
+        return;
+
+    m_inPass = true;
+    m_due.assign(m_queue.size(), RelocationMover());
+    for (uint32 i = 0; i < m_buckets.size(); ++i)
+    {
+        RelocationMover& mover = m_due[m_buckets[i].second];
+        mover.unit = m_queue[m_buckets[i].second].unit;
+
+        float radius = map.GetVisibilityDistance(mover.unit);
+        mover.radiusSq = radius * radius;
+        mover.reacting = mover.unit->GetTypeId() == TYPEID_PLAYER || mover.unit->IsAlive();
+    }
+
+    std::sort(m_buckets.begin(), m_buckets.end());
+
+    for (uint32 i = 0; i < m_buckets.size();)
+    {
+        uint32 cell = m_buckets[i].first;
+        m_bucket.clear();
+        for (; i < m_buckets.size() && m_buckets[i].first == cell; ++i)
+            m_bucket.push_back(m_buckets[i].second);
+
+        VisitBucket(map, &m_bucket[0], &m_bucket[0] + m_bucket.size());
+    }
+
+    ++m_passes;
+    m_movers += m_buckets.size();
+
+    Finish();
+
+    m_time += WorldTimer::getUSTime() - start;
+}
+
+void RelocationNotifyPass::VisitBucket(Map& map, uint32 const* begin, uint32 const* end)
+{
+    float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f, radiusSq = 0.0f;
+    bool any = false;
+    for (uint32 const* itr = begin; itr != end; ++itr)
+    {
+        RelocationMover const& mover = m_due[*itr];
+        if (!mover.unit || !mover.reacting)
+            continue;
+
+        float x = mover.unit->GetPositionX();
+        float y = mover.unit->GetPositionY();
+        if (!any)
+        {
+            minX = maxX = x;
+            minY = maxY = y;
+            any = true;
+        }
+        else
+        {
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+        }
+        radiusSq = std::max(radiusSq, mover.radiusSq);
+    }
+
+    if (!any)
+        return;
+
+    // one visit covering visibility of every mover of the bucket
+    float halfX = (maxX - minX) / 2;
+    float halfY = (maxY - minY) / 2;
+    float radius = sqrt(radiusSq) + sqrt(halfX * halfX + halfY * halfY);
+
+    MaNGOS::RelocationBucketNotifier notify(*this, m_due, begin, end);
+    Cell::VisitAllObjects(minX + halfX, minY + halfY, &map, notify, radius);
+
+    ++m_visits;
+    m_pairs += notify._pairs;
+}
+
+void RelocationNotifyPass::Finish()
+{
+    for (uint32 i = 0; i < m_due.size(); ++i)
+    {
+        if (Unit* unit = m_due[i].unit)
+        {
+            unit->_SetAINotifyScheduled(false);
+            unit->_SetAINotifyIndex(AI_NOTIFY_NOT_QUEUED);
+            m_queue[i].unit = NULL;
+        }
+    }
+
+    // keep units not due yet, removed ones left holes
+    uint32 kept = 0;
+    for (uint32 i = 0; i < m_queue.size(); ++i)
+    {
+        if (!m_queue[i].unit)
+            continue;
+
+        m_queue[kept] = m_queue[i];
+        m_queue[kept].unit->_SetAINotifyIndex(kept);
+        ++kept;
+    }
+    m_queue.resize(kept);
+
+    m_due.clear();
+    m_inPass = false;
+}
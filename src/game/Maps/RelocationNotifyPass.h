@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _RELOCATION_NOTIFY_PASS_H
+#define _RELOCATION_NOTIFY_PASS_H
+
+#include "Common.h"
+
+class Map;
+class Unit;
+
+#define AI_NOTIFY_NOT_QUEUED    0xFFFFFFFF                  // Unit::_GetAINotifyIndex() of unit not waiting here
+
+// unit due in current pass
+struct RelocationMover
+{
+    RelocationMover() : unit(NULL), radiusSq(0.0f), reacting(false) {}
+
+    Unit* unit;
+    float radiusSq;                                         // visibility distance, squared
+    bool reacting;                                          // player, or creature alive at start of pass
+};
+
+/**
+ * AI relocation notify of all units of one map.
+ *
+ * Moved units wait here instead of each scheduling own event and visiting
+ * grid around itself. Once per map update, units that are due are bucketed
+ * by grid cell and every bucket visits cells around it once, pairing each
+ * visited player and creature with all movers of the bucket in their
+ * visibility distance. Pair of two movers is handled by the first of them
+ * only, so MoveInLineOfSight is not called twice for it. Map thread only.
+ */
+class RelocationNotifyPass
+{
+    public:
+        RelocationNotifyPass();
+
+        // notify about unit after delay milliseconds, unit must be in world of this map
+        void Schedule(Unit* unit, uint32 delay);
+        void Remove(Unit* unit);
+
+        void Update(Map& map, uint32 diff);
+
+        uint32 GetQueued() const { return m_queue.size(); }
+
+        // counters since map creation
+        uint64 GetPasses() const { return m_passes; }
+        uint64 GetMovers() const { return m_movers; }
+        uint64 GetVisits() const { return m_visits; }
+        uint64 GetPairs() const { return m_pairs; }
+        uint64 GetTime() const { return m_time; }           // microseconds
+
+        // mover data of unit due in current pass, NULL for others
+        RelocationMover const* GetMover(Unit const* unit) const;
+
+    private:
+        RelocationNotifyPass(const RelocationNotifyPass&);
+        RelocationNotifyPass& operator=(const RelocationNotifyPass&);
+
+        void VisitBucket(Map& map, uint32 const* begin, uint32 const* end);
+        void Finish();
+
+        struct Entry
+        {
+            Unit* unit;
+            uint64 due;
+        };
+
+        std::vector<Entry> m_queue;
+        uint64 m_clock;                                     // map time in milliseconds
+
+        // valid during Update() only, movers indexed as m_queue
+        std::vector<RelocationMover> m_due;
+        std::vector<std::pair<uint32, uint32> > m_buckets;  // cell id, queue index
+        std::vector<uint32> m_bucket;
+        bool m_inPass;
+
+        uint64 m_passes;
+        uint64 m_movers;
+        uint64 m_visits;
+        uint64 m_pairs;
+        uint64 m_time;
+};
+
+#endif
@@ -0,0 +1,415 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "TerrainPrefetcher.h"
+#include "GridMap.h"
+#include "MapTree.h"
+#include "ObjectGridLoader.h"
+#include "Player.h"
+#include "World.h"
+#include "Log.h"
+#include "Profiler.h"
+#include "WaypointMovementGenerator.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Method_Request.h>
+
+// taxi speed is fixed by client
+#define TERRAIN_PREFETCH_TAXI_SPEED     32.0f
+
+PrefetchedTile::~PrefetchedTile()
+{
+    delete gridMap;
+    MMAP::MMapManager::freeTile(mmap);
+}
+
+class TilePrefetchRequest : public ACE_Method_Request
+{
+    public:
+        TilePrefetchRequest(uint32 mapId, uint32 x, uint32 y) : m_mapId(mapId), m_x(x), m_y(y) {}
+
+        virtual int call(void)
+        {
+            sTerrainPrefetcher.Process(m_mapId, m_x, m_y);
+            return 0;
+        }
+
+    private:
+        uint32 m_mapId;
+        uint32 m_x;
+        uint32 m_y;
+};
+
+class SpawnsPrefetchRequest : public ACE_Method_Request
+{
+    public:
+        SpawnsPrefetchRequest(uint32 mapId, uint32 instanceId, uint8 spawnMode, uint32 x, uint32 y, uint32 requestId)
+            : m_mapId(mapId), m_instanceId(instanceId), m_spawnMode(spawnMode), m_x(x), m_y(y), m_requestId(requestId) {}
+
+        virtual int call(void)
+        {
+            sTerrainPrefetcher.ProcessSpawns(m_mapId, m_instanceId, m_spawnMode, m_x, m_y, m_requestId);
+            return 0;
+        }
+
+    private:
+        uint32 m_mapId;
+        uint32 m_instanceId;
+        uint8 m_spawnMode;
+        uint32 m_x;
+        uint32 m_y;
+        uint32 m_requestId;
+};
+
+TerrainPrefetcher::TerrainPrefetcher() : m_active(false), m_spawnsRequestId(0)
+{
+    ResetStats();
+}
+
+TerrainPrefetcher::~TerrainPrefetcher()
+{
+    Deactivate();
+
+    for (std::map<uint32, PrefetchedTile*>::iterator itr = m_ready.begin(); itr != m_ready.end(); ++itr)
+        delete itr->second;
+
+    for (std::map<uint64, PreparedGridSpawns*>::iterator itr = m_readySpawns.begin(); itr != m_readySpawns.end(); ++itr)
+        delete itr->second;
+}
+
+bool TerrainPrefetcher::Activate()
+{
+    if (m_active)
+        return false;
+
+    // single thread, tiles are disk bound
+    if (m_executor.activate(1) == -1)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: TerrainPrefetcher: cannot start I/O thread, terrain is loaded on demand only");
+        return false;
+    }
+
+    m_active = true;
+    return true;
+}
+
+void TerrainPrefetcher::Deactivate()
+{
+    if (!m_active)
+        return;
+
+    m_active = false;
+    m_executor.deactivate();
+}
+
+void TerrainPrefetcher::PrefetchFor(Player& player, TerrainInfo const& terrain)
+{
+    if (!m_active)
+        return;
+
+    Map const& map = *player.GetMap();
+    float lookAhead = float(sWorld.getConfig(CONFIG_GRID_PREFETCH_LOOKAHEAD));
+
+    // grids get loaded when they come into visibility range, not when we step in
+    float reach = map.GetVisibilityDistance() + World::GetVisibleObjectGreyDistance();
+
+    if (player.IsTaxiFlying() && player.GetMotionMaster()->GetCurrentMovementGeneratorType() == FLIGHT_MOTION_TYPE)
+    {
+        FlightPathMovementGenerator* flight = (FlightPathMovementGenerator*)(player.GetMotionMaster()->top());
+        TaxiPathNodeList const& path = flight->GetPath();
+
+        float maxDistance = TERRAIN_PREFETCH_TAXI_SPEED * lookAhead;
+        float distance = 0.0f;
+        float prevX = player.GetPositionX();
+        float prevY = player.GetPositionY();
+
+        // nodes are dense enough on flight paths, no need to walk between them
+        for (uint32 i = flight->GetCurrentNode(); i < path.size() && distance < maxDistance; ++i)
+        {
+            if (path[i].mapid != terrain.GetMapId())
+                break;
+
+            distance += sqrt((path[i].x - prevX) * (path[i].x - prevX) + (path[i].y - prevY) * (path[i].y - prevY));
+            prevX = path[i].x;
+            prevY = path[i].y;
+
+            // cover visibility range around the node on both sides of the path
+            QueuePosition(map, terrain, prevX, prevY);
+            QueuePosition(map, terrain, prevX + reach, prevY);
+            QueuePosition(map, terrain, prevX - reach, prevY);
+            QueuePosition(map, terrain, prevX, prevY + reach);
+            QueuePosition(map, terrain, prevX, prevY - reach);
+        }
+
+        return;
+    }
+
+    if (!player.IsMoving())
+        return;
+
+    float angle = player.GetOrientation();
+    if (player.HasUnitMovementFlag(MOVEFLAG_BACKWARD))
+        angle += M_PI_F;
+
+    if (player.HasUnitMovementFlag(MOVEFLAG_STRAFE_LEFT))
+        angle += player.HasUnitMovementFlag(MOVEFLAG_FORWARD) ? M_PI_F / 4 : (player.HasUnitMovementFlag(MOVEFLAG_BACKWARD) ? -M_PI_F / 4 : M_PI_F / 2);
+    else if (player.HasUnitMovementFlag(MOVEFLAG_STRAFE_RIGHT))
+        angle -= player.HasUnitMovementFlag(MOVEFLAG_FORWARD) ? M_PI_F / 4 : (player.HasUnitMovementFlag(MOVEFLAG_BACKWARD) ? -M_PI_F / 4 : M_PI_F / 2);
+
+    UnitMoveType moveType = player.IsFlying() ? MOVE_FLIGHT : (player.IsWalking() ? MOVE_WALK : MOVE_RUN);
+    float maxDistance = reach + player.GetSpeed(moveType) * lookAhead;
+
+    float dx = cos(angle);
+    float dy = sin(angle);
+    for (float distance = SIZE_OF_GRIDS / 2; distance <= maxDistance; distance += SIZE_OF_GRIDS / 2)
+        QueuePosition(map, terrain, player.GetPositionX() + dx * distance, player.GetPositionY() + dy * distance);
+}
+
+void TerrainPrefetcher::QueuePosition(Map const& map, TerrainInfo const& terrain, float x, float y)
+{
+    if (!MaNGOS::IsValidMapCoord(x, y))
+        return;
+
+    // terrain is shared by instances and kept longer than objects, check both
+    QueueSpawns(map, x, y);
+
+    // same as TerrainInfo::GetGrid
+    uint32 gx = uint32(32 - x / SIZE_OF_GRIDS);
+    uint32 gy = uint32(32 - y / SIZE_OF_GRIDS);
+    if (gx >= MAX_NUMBER_OF_GRIDS || gy >= MAX_NUMBER_OF_GRIDS)
+        return;
+
+    if (terrain.IsGridLoaded(gx, gy))
+        return;
+
+    uint32 key = MakeKey(terrain.GetMapId(), gx, gy);
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        if (!m_requested.insert(key).second)
+            return;
+    }
+
+    if (m_executor.execute(new TilePrefetchRequest(terrain.GetMapId(), gx, gy)) == -1)
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        m_requested.erase(key);
+        return;
+    }
+
+    m_requestedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TerrainPrefetcher::QueueSpawns(Map const& map, float x, float y)
+{
+    if (map.IsLoaded(x, y))
+        return;
+
+    GridPair p = MaNGOS::ComputeGridPair(x, y);
+    if (p.x_coord >= MAX_NUMBER_OF_GRIDS || p.y_coord >= MAX_NUMBER_OF_GRIDS)
+        return;
+
+    uint64 key = MakeSpawnsKey(map.GetId(), map.GetInstanceId(), p.x_coord, p.y_coord);
+    uint32 requestId;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        if (m_requestedSpawns.find(key) != m_requestedSpawns.end())
+            return;
+
+        requestId = ++m_spawnsRequestId;
+        m_requestedSpawns[key] = requestId;
+    }
+
+    if (m_executor.execute(new SpawnsPrefetchRequest(map.GetId(), map.GetInstanceId(), map.GetSpawnMode(), p.x_coord, p.y_coord, requestId)) == -1)
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        m_requestedSpawns.erase(key);
+    }
+}
+
+void TerrainPrefetcher::Process(uint32 mapId, uint32 x, uint32 y)
+{
+    ProfileZone zone("TerrainPrefetcher::Process");
+    uint64 start = WorldTimer::getUSTime();
+
+    PrefetchedTile* tile = new PrefetchedTile();
+
+    int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+    char* fileName = new char[len];
+    snprintf(fileName, len, (sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), mapId, x, y);
+
+    tile->gridMap = new GridMap();
+    if (!tile->gridMap->loadData(fileName))
+    {
+        // let map thread load it again and report the error
+        delete tile->gridMap;
+        tile->gridMap = NULL;
+    }
+
+    delete [] fileName;
+
+    if (sWorld.getConfig(CONFIG_MMAP_ENABLED))
+        MMAP::MMapManager::readTile(mapId, x, y, tile->mmap);
+
+    // only warm up page cache, VMapManager2 is not safe to load from here
+    std::string vmapFile = sWorld.GetDataPath() + "vmaps/" + VMAP::StaticMapTree::getTileFileName(mapId, x, y);
+    if (FILE* file = fopen(vmapFile.c_str(), "rb"))
+    {
+        char buffer[64 * 1024];
+        while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer));
+        fclose(file);
+    }
+
+    tile->loadTime = uint32(WorldTimer::getUSTime() - start);
+    tile->readyTime = WorldTimer::getMSTime();
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+    m_ready[MakeKey(mapId, x, y)] = tile;
+}
+
+void TerrainPrefetcher::ProcessSpawns(uint32 mapId, uint32 instanceId, uint8 spawnMode, uint32 x, uint32 y, uint32 requestId)
+{
+    ProfileZone zone("TerrainPrefetcher::ProcessSpawns");
+
+    PreparedGridSpawns* spawns = new PreparedGridSpawns();
+    ObjectGridLoader::PrepareSpawns(mapId, instanceId, spawnMode, x, y, *spawns, true);
+    spawns->readyTime = WorldTimer::getMSTime();
+
+    uint64 key = MakeSpawnsKey(mapId, instanceId, x, y);
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    // grid was loaded meanwhile, respawn times may be outdated
+    std::map<uint64, uint32>::const_iterator itr = m_requestedSpawns.find(key);
+    if (itr == m_requestedSpawns.end() || itr->second != requestId)
+    {
+        delete spawns;
+        return;
+    }
+
+    m_readySpawns[key] = spawns;
+}
+
+PrefetchedTile* TerrainPrefetcher::Take(uint32 mapId, uint32 x, uint32 y)
+{
+    if (!m_active)
+        return NULL;
+
+    uint32 key = MakeKey(mapId, x, y);
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, NULL);
+
+    std::map<uint32, PrefetchedTile*>::iterator itr = m_ready.find(key);
+    if (itr == m_ready.end())
+        return NULL;
+
+    PrefetchedTile* tile = itr->second;
+    m_ready.erase(itr);
+    m_requested.erase(key);
+    return tile;
+}
+
+PreparedGridSpawns* TerrainPrefetcher::TakeSpawns(uint32 mapId, uint32 instanceId, uint32 x, uint32 y)
+{
+    if (!m_active)
+        return NULL;
+
+    uint64 key = MakeSpawnsKey(mapId, instanceId, x, y);
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, NULL);
+
+    // not ready ones are dropped by ProcessSpawns
+    m_requestedSpawns.erase(key);
+
+    std::map<uint64, PreparedGridSpawns*>::iterator itr = m_readySpawns.find(key);
+    if (itr == m_readySpawns.end())
+        return NULL;
+
+    PreparedGridSpawns* spawns = itr->second;
+    m_readySpawns.erase(itr);
+    return spawns;
+}
+
+void TerrainPrefetcher::Update()
+{
+    if (!m_active)
+        return;
+
+    uint32 now = WorldTimer::getMSTime();
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    for (std::map<uint32, PrefetchedTile*>::iterator itr = m_ready.begin(); itr != m_ready.end();)
+    {
+        // came too late or player turned away
+        if (WorldTimer::getMSTimeDiff(itr->second->readyTime, now) > TERRAIN_PREFETCH_EXPIRE)
+        {
+            m_expired.fetch_add(1, std::memory_order_relaxed);
+            m_requested.erase(itr->first);
+            delete itr->second;
+            m_ready.erase(itr++);
+        }
+        else
+            ++itr;
+    }
+
+    for (std::map<uint64, PreparedGridSpawns*>::iterator itr = m_readySpawns.begin(); itr != m_readySpawns.end();)
+    {
+        if (WorldTimer::getMSTimeDiff(itr->second->readyTime, now) > TERRAIN_PREFETCH_EXPIRE)
+        {
+            m_requestedSpawns.erase(itr->first);
+            delete itr->second;
+            m_readySpawns.erase(itr++);
+        }
+        else
+            ++itr;
+    }
+}
+
+uint32 TerrainPrefetcher::GetQueued()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, 0);
+    return m_requested.size() - m_ready.size();
+}
+
+void TerrainPrefetcher::RecordHit(uint32 linkTime, uint32 savedTime)
+{
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    m_linkTime.fetch_add(linkTime, std::memory_order_relaxed);
+    m_savedTime.fetch_add(savedTime, std::memory_order_relaxed);
+}
+
+void TerrainPrefetcher::RecordMiss(uint32 loadTime)
+{
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    m_stallTime.fetch_add(loadTime, std::memory_order_relaxed);
+
+    uint32 current = m_stallTimeMax.load(std::memory_order_relaxed);
+    while (current < loadTime && !m_stallTimeMax.compare_exchange_weak(current, loadTime, std::memory_order_relaxed));
+}
+
+void TerrainPrefetcher::ResetStats()
+{
+    m_requestedCount.store(0, std::memory_order_relaxed);
+    m_hits.store(0, std::memory_order_relaxed);
+    m_misses.store(0, std::memory_order_relaxed);
+    m_expired.store(0, std::memory_order_relaxed);
+    m_linkTime.store(0, std::memory_order_relaxed);
+    m_savedTime.store(0, std::memory_order_relaxed);
+    m_stallTime.store(0, std::memory_order_relaxed);
+    m_stallTimeMax.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _TERRAIN_PREFETCHER_H
+#define _TERRAIN_PREFETCHER_H
+
+#include "Common.h"
+#include "DelayExecutor.h"
+#include "MoveMap.h"
+
+#include <ace/Singleton.h>
+#include <ace/Thread_Mutex.h>
+#include <atomic>
+#include <map>
+#include <set>
+
+class GridMap;
+class Map;
+class Player;
+class TerrainInfo;
+struct PreparedGridSpawns;
+
+// how often map threads look ahead of their players
+#define TERRAIN_PREFETCH_INTERVAL   1000
+
+// unused prefetched tiles are dropped after
+#define TERRAIN_PREFETCH_EXPIRE     (2*MINUTE*IN_MILISECONDS)
+
+struct PrefetchedTile
+{
+    PrefetchedTile() : gridMap(NULL), loadTime(0), readyTime(0) {}
+    ~PrefetchedTile();
+
+    GridMap* gridMap;                                       // decoded .map, NULL once taken
+    MMAP::MMapTileData mmap;                                // .mmtile read but not linked into navmesh
+    uint32 loadTime;                                        // microseconds spent on I/O thread
+    uint32 readyTime;
+};
+
+/**
+ * Reads terrain tiles on a background I/O thread before a grid needs them.
+ *
+ * Map threads queue tiles ahead of players along their movement vector or
+ * taxi path. .map grids are decoded into GridMap objects and .mmtile files
+ * read into navmesh tile buffers, so TerrainInfo::LoadMapAndVMap only links
+ * them. vmap tiles share a model cache in VMapManager2 that is not thread
+ * safe, for them the I/O thread only reads the file into the page cache.
+ *
+ * For object grids not loaded in the map instance yet, spawns of the grid
+ * are prepared as well, see ObjectGridLoader::PrepareSpawns. Their respawn
+ * times are a snapshot: prepared spawns are dropped when taken by the grid
+ * load, so a grid unloaded later is prepared again with times saved at the
+ * unload, and a load that came before the I/O thread finished invalidates
+ * the request. ObjectGridLoader::LoadN checks spawn data and respawn time
+ * versions for changes made meanwhile.
+ */
+class TerrainPrefetcher
+{
+    friend class ACE_Singleton<TerrainPrefetcher, ACE_Thread_Mutex>;
+
+    public:
+        bool Activate();
+        void Deactivate();
+        bool IsActive() const { return m_active; }
+
+        // map thread, queue tiles player is going to need
+        void PrefetchFor(Player& player, TerrainInfo const& terrain);
+
+        // TerrainInfo::LoadMapAndVMap, caller owns returned tile
+        PrefetchedTile* Take(uint32 mapId, uint32 x, uint32 y);
+        // ObjectGridLoader::LoadN, x and y of object grid, caller owns returned spawns
+        PreparedGridSpawns* TakeSpawns(uint32 mapId, uint32 instanceId, uint32 x, uint32 y);
+
+        // I/O thread only
+        void Process(uint32 mapId, uint32 x, uint32 y);
+        void ProcessSpawns(uint32 mapId, uint32 instanceId, uint8 spawnMode, uint32 x, uint32 y, uint32 requestId);
+
+        // world thread, drops tiles nobody took
+        void Update();
+
+        void RecordHit(uint32 linkTime, uint32 savedTime);
+        void RecordMiss(uint32 loadTime);
+        void ResetStats();
+
+        uint64 GetRequested() const { return m_requestedCount.load(std::memory_order_relaxed); }
+        uint64 GetHits() const { return m_hits.load(std::memory_order_relaxed); }
+        uint64 GetMisses() const { return m_misses.load(std::memory_order_relaxed); }
+        uint64 GetExpired() const { return m_expired.load(std::memory_order_relaxed); }
+        uint64 GetLinkTime() const { return m_linkTime.load(std::memory_order_relaxed); }
+        uint64 GetSavedTime() const { return m_savedTime.load(std::memory_order_relaxed); }
+        uint64 GetStallTime() const { return m_stallTime.load(std::memory_order_relaxed); }
+        uint32 GetStallTimeMax() const { return m_stallTimeMax.load(std::memory_order_relaxed); }
+        uint32 GetQueued();
+
+    private:
+        TerrainPrefetcher();
+        ~TerrainPrefetcher();
+
+        static uint32 MakeKey(uint32 mapId, uint32 x, uint32 y) { return (mapId << 12) | (x << 6) | y; }
+        static uint64 MakeSpawnsKey(uint32 mapId, uint32 instanceId, uint32 x, uint32 y) { return (uint64(instanceId) << 32) | MakeKey(mapId, x, y); }
+
+        void QueuePosition(Map const& map, TerrainInfo const& terrain, float x, float y);
+        void QueueSpawns(Map const& map, float x, float y);
+
+        DelayExecutor m_executor;
+        bool m_active;
+
+        ACE_Thread_Mutex m_lock;
+        std::set<uint32> m_requested;                       // queued, loading or ready
+        std::map<uint32, PrefetchedTile*> m_ready;
+        std::map<uint64, uint32> m_requestedSpawns;         // request id, queued, loading or ready
+        std::map<uint64, PreparedGridSpawns*> m_readySpawns;
+        uint32 m_spawnsRequestId;
+
+        std::atomic<uint64> m_requestedCount;
+        std::atomic<uint64> m_hits;
+        std::atomic<uint64> m_misses;
+        std::atomic<uint64> m_expired;
+        std::atomic<uint64> m_linkTime;                     // microseconds, linking prefetched tiles
+        std::atomic<uint64> m_savedTime;                    // microseconds, I/O done ahead for hits
+        std::atomic<uint64> m_stallTime;                    // microseconds, synchronous loads on misses
+        std::atomic<uint32> m_stallTimeMax;
+};
+
+#define sTerrainPrefetcher (*ACE_Singleton<TerrainPrefetcher, ACE_Thread_Mutex>::instance())
+
+#endif
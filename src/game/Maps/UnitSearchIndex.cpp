@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "UnitSearchIndex.h"
+#include "Map.h"
+#include "Player.h"
+#include "Creature.h"
+#include "CellImpl.h"
+
+namespace MaNGOS
+{
+    struct UnitCollector
+    {
+        std::vector<Unit*>& i_units;
+
+        explicit UnitCollector(std::vector<Unit*>& units) : i_units(units) {}
+
+        void Visit(PlayerMapType& m)
+        {
+            for (PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+                i_units.push_back(iter->getSource());
+        }
+
+        void Visit(CreatureMapType& m)
+        {
+            for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+                i_units.push_back(iter->getSource());
+        }
+
+        template<class NOT_INTERESTED>
+        void Visit(GridRefManager<NOT_INTERESTED>&) {}
+    };
+}
+
+void UnitSearchIndex::Query(Map& map, float x, float y, float radius, std::vector<Unit*>& units)
+{
+    if (radius > MAX_VISIBILITY_DISTANCE)
+        radius = MAX_VISIBILITY_DISTANCE;
+
+    CellArea area = Cell::CalculateCellArea(x, y, radius);
+    for (uint32 cellX = area.low_bound.x_coord; cellX <= area.high_bound.x_coord; ++cellX)
+    {
+        for (uint32 cellY = area.low_bound.y_coord; cellY <= area.high_bound.y_coord; ++cellY)
+        {
+            CellPair cellPair(cellX, cellY);
+            Cell cell(cellPair);
+            NGridType* grid = map.getNGrid(cell.GridX(), cell.GridY());
+            if (!grid || !grid->isGridObjectDataLoaded())
+                continue;
+
+            uint32 version = (*grid)(cell.CellX(), cell.CellY()).GetVersion();
+
+            std::pair<CellMap::iterator, bool> cached = m_cells.insert(std::make_pair(cellY * TOTAL_NUMBER_OF_CELLS_PER_MAP + cellX, CellUnits()));
+            CellUnits& cellUnits = cached.first->second;
+            if (cached.second || cellUnits.version != version)
+            {
+                cellUnits.version = version;
+                cellUnits.units.clear();
+
+                MaNGOS::UnitCollector collector(cellUnits.units);
+                TypeContainerVisitor<MaNGOS::UnitCollector, GridTypeMapContainer> gridVisitor(collector);
+                TypeContainerVisitor<MaNGOS::UnitCollector, WorldTypeMapContainer> worldVisitor(collector);
+                grid->Visit(cell.CellX(), cell.CellY(), gridVisitor);
+                grid->Visit(cell.CellX(), cell.CellY(), worldVisitor);
+            }
+
+            units.insert(units.end(), cellUnits.units.begin(), cellUnits.units.end());
+        }
+    }
+}
+
+void UnitSearchIndex::ClearGrid(uint32 gridX, uint32 gridY)
+{
+    for (uint32 x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
+        for (uint32 y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
+            m_cells.erase((gridY * MAX_NUMBER_OF_CELLS + y) * TOTAL_NUMBER_OF_CELLS_PER_MAP + gridX * MAX_NUMBER_OF_CELLS + x);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _UNIT_SEARCH_INDEX_H
+#define _UNIT_SEARCH_INDEX_H
+
+#include "Common.h"
+
+class Map;
+class Unit;
+
+/**
+ * Players and creatures of map grid cells as flat arrays, for area searches.
+ *
+ * Units of a cell are collected from its grid containers on first search
+ * touching the cell and reused until any object enters or leaves the cell
+ * (Grid::GetVersion() changes), so overlapping AoE searches of the same
+ * tick walk the cell lists once. Positions are not cached, membership only;
+ * callers check distance with current positions. Map thread only.
+ */
+class UnitSearchIndex
+{
+    friend class UnitSearchResult;
+
+    public:
+        // appends units of loaded cells within radius of x,y, never loads grids
+        void Query(Map& map, float x, float y, float radius, std::vector<Unit*>& units);
+
+        // grid is being unloaded, its units will be deleted
+        void ClearGrid(uint32 gridX, uint32 gridY);
+
+    private:
+        struct CellUnits
+        {
+            uint32 version;                                 // Grid::GetVersion() when collected
+            std::vector<Unit*> units;
+        };
+
+        typedef UNORDERED_MAP<uint32, CellUnits> CellMap;
+        CellMap m_cells;                                    // by cell id, y * TOTAL_NUMBER_OF_CELLS_PER_MAP + x
+
+        std::vector<Unit*> m_spare;                         // result buffer kept between searches
+};
+
+// search result borrowing result buffer of the index, nested searches get their own
+class UnitSearchResult
+{
+    public:
+        explicit UnitSearchResult(UnitSearchIndex& index) : m_index(index)
+        {
+            m_units.swap(index.m_spare);
+            m_units.clear();
+        }
+
+        ~UnitSearchResult() { m_units.swap(m_index.m_spare); }
+
+        std::vector<Unit*>& Units() { return m_units; }
+
+    private:
+        UnitSearchResult(const UnitSearchResult&);
+        UnitSearchResult& operator=(const UnitSearchResult&);
+
+        UnitSearchIndex& m_index;
+        std::vector<Unit*> m_units;
+};
+
+#endif
@@ -56,6 +56,7 @@ void TargetedMovementGeneratorMedium<T,D>::_setTargetLocation(T &owner)
             if (!owner.IsStopped())
                 owner.StopMoving();
 
+            _pathRequest.reset();
             return;
         }
 
@@ -73,6 +74,7 @@ void TargetedMovementGeneratorMedium<T,D>::_setTargetLocation(T &owner)
             if (!owner.IsStopped())
                 owner.StopMoving();
 
+            _pathRequest.reset();
             return;
         }
 
@@ -86,22 +88,41 @@ void TargetedMovementGeneratorMedium<T,D>::_setTargetLocation(T &owner)
     if (!_offset && targetIsVictim && (!owner.CanReachWithMeleeAutoAttackAtPosition(_target.getTarget(), x, y, z) || !_target->IsWithinLOS(x, y, z)))
         _target->GetPosition(x, y, z);
 
+    // previous search did not finish yet, Update() launches it first
+    if (_pathRequest)
+        return;
+
     if (!_path)
         _path = new PathFinder(&owner);
 
     // allow pets following their master to cheat while generating paths
     bool forceDest = (owner.GetObjectGuid().IsPet() && owner.HasUnitState(UNIT_STAT_FOLLOW));
-    bool result = _path->calculate(x, y, z, forceDest);
-    //if (!result || _path->getPathType() & PATHFIND_NOPATH)
-    //    return;
-    if (!forceDest && _path->getPathType() & PATHFIND_NOPATH)
-        result = _path->calculate(x, y, z, true);
-    if (!result)
+    PathPrepareResult result = _path->prepare(x, y, z, forceDest);
+    if (result == PATH_PREPARE_UNCHANGED)
         return;
 
+    _target->GetPosition(m_fTargetLastX, m_fTargetLastY, m_fTargetLastZ);
+
+    if (result == PATH_PREPARE_SEARCH)
+    {
+        // when there is no path at all retry with forced destination
+        _pathRequest = sPathFinderQueue.Schedule(*_path, !forceDest);
+        if (_pathRequest)
+            return;
+
+        _path->search(NULL, !forceDest);
+    }
+
+    _launchPath(owner);
+}
+
+template<class T, typename D>
+void TargetedMovementGeneratorMedium<T,D>::_launchPath(T &owner)
+{
+    _path->finalize();
+
     _targetReached = false;
     static_cast<MovementGenerator*>(this)->_recalculateTravel = false;
-    _target->GetPosition(m_fTargetLastX, m_fTargetLastY, m_fTargetLastZ);
 
     Movement::MoveSplineInit init(owner);
     init.MovebyPath(_path->getPath());
@@ -148,6 +169,20 @@ bool TargetedMovementGeneratorMedium<T,D>::Update(T &owner, const uint32 & time_
     if (static_cast<D*>(this)->_lostTarget(owner))
         return true;
 
+    if (_pathRequest && _pathRequest->GetState() != PATH_REQUEST_QUEUED)
+    {
+        PathRequestPtr request = _pathRequest;
+        _pathRequest.reset();
+
+        // on failure keep old path, next recheck asks again
+        if (request->GetState() == PATH_REQUEST_DONE && request->GetPath().getMapId() == owner.GetMapId())
+        {
+            delete _path;
+            _path = new PathFinder(request->GetPath());
+            _launchPath(owner);
+        }
+    }
+
     _recheckDistance.Update(time_diff);
     if (_recheckDistance.Passed())
     {
@@ -187,7 +222,7 @@ bool TargetedMovementGeneratorMedium<T,D>::Update(T &owner, const uint32 & time_
             }  
         }
 
-        if (!_targetReached)
+        if (!_targetReached && !_pathRequest)
         {
             _targetReached = true;
             static_cast<D*>(this)->_reachTarget(owner);
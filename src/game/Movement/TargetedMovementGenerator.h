@@ -28,6 +28,7 @@
 #include "Unit.h"
 
 #include "PathFinder.h"
+#include "PathFinderQueue.h"
 
 class TargetedMovementGeneratorBase
 {
@@ -66,6 +67,7 @@ class TargetedMovementGeneratorMedium
 
     protected:
         void _setTargetLocation(T &);
+        void _launchPath(T &);
 
         TimeTracker _recheckDistance;
         float _offset;
@@ -73,6 +75,7 @@ class TargetedMovementGeneratorMedium
         bool _targetReached : 1;
 
         PathFinder* _path;
+        PathRequestPtr _pathRequest;                        // search running on path finder queue
         float m_fTargetLastX;
         float m_fTargetLastY;
         float m_fTargetLastZ;
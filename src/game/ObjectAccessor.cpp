@@ -323,6 +323,10 @@ void ObjectAccessor::RemoveOldCorpses()
         if (!itr->second->IsExpired(now))
             continue;
 
+        // converted by next pass, decoupled instance still updates
+        if (itr->second->IsInWorld() && itr->second->GetMap()->IsDecoupledUpdating())
+            continue;
+
         ConvertCorpseForPlayer(itr->first);
     }
 }
@@ -29,6 +29,8 @@
 #include "CellImpl.h"
 #include "CreatureAI.h"
 #include "GridDefines.h"
+#include "GridMap.h"
+#include "TerrainPrefetcher.h"
 
 class ObjectGridRespawnMover
 {
@@ -109,32 +111,102 @@ template<> void addUnitState(Creature *obj, CellPair const& cell_pair)
         obj->setDeathState(DEAD);
 }
 
-template <class T>
-void LoadHelper(CellGuidSet const& guid_set, CellPair &cell, GridRefManager<T> &m, uint32 &count, Map* map, GridType& grid)
+void ObjectGridLoader::PrepareSpawns(uint32 mapId, uint32 instanceId, uint8 spawnMode, uint32 gridX, uint32 gridY, PreparedGridSpawns& spawns, bool heights)
 {
-    for (CellGuidSet::const_iterator i_guid = guid_set.begin(); i_guid != guid_set.end(); ++i_guid)
+    uint64 start = WorldTimer::getUSTime();
+
+    spawns.instanceId = instanceId;
+    // before collecting, cells changed meanwhile make spawns outdated
+    spawns.spawnDataVersion = sObjectMgr.GetSpawnDataVersion(mapId);
+
+    for (unsigned int x=0; x < MAX_NUMBER_OF_CELLS; ++x)
+    {
+        for (unsigned int y=0; y < MAX_NUMBER_OF_CELLS; ++y)
+        {
+            CellPair cell_pair(gridX*MAX_NUMBER_OF_CELLS + x, gridY*MAX_NUMBER_OF_CELLS + y);
+            uint32 cell_id = (cell_pair.y_coord*TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
+
+            sObjectMgr.CollectCellSpawns(mapId, spawnMode, cell_id, x, y, spawns);
+        }
+    }
+
+    sObjectMgr.ReadRespawnTimes(spawns);
+
+    // dead flying creatures are put on ground, see Creature::LoadFromSpawn
+    GridMap* gridMap = NULL;
+    bool gridMapRead = false;
+    for (std::vector<PreparedCreatureSpawn>::iterator itr = spawns.creatures.begin(); heights && itr != spawns.creatures.end(); ++itr)
+    {
+        if (!itr->respawnTime || !itr->info || !(itr->info->InhabitType & INHABIT_AIR))
+            continue;
+
+        if (!gridMapRead)
+        {
+            gridMapRead = true;
+
+            // grid x of map is tile 63 - x of terrain, see Map::EnsureGridCreated
+            int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+            char* fileName = new char[len];
+            snprintf(fileName, len, (sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), mapId, (MAX_NUMBER_OF_GRIDS - 1) - gridX, (MAX_NUMBER_OF_GRIDS - 1) - gridY);
+
+            gridMap = new GridMap();
+            if (!gridMap->loadData(fileName))
+            {
+                delete gridMap;
+                gridMap = NULL;
+            }
+
+            delete [] fileName;
+        }
+
+        // map thread looks them up itself
+        if (!gridMap)
+            break;
+
+        itr->groundZ = gridMap->getHeight(itr->data->posX, itr->data->posY);
+        itr->groundKnown = true;
+    }
+
+    delete gridMap;
+
+    spawns.prepareTime = uint32(WorldTimer::getUSTime() - start);
+}
+
+template<class T, class S>
+void ObjectGridLoader::Create(std::vector<S> const& spawns, std::vector<PreparedObject<T> >& objects)
+{
+    for (typename std::vector<S>::const_iterator itr = spawns.begin(); itr != spawns.end(); ++itr)
     {
         T* obj = new T;
-        uint32 guid = *i_guid;
-        //sLog.outString("DEBUG: LoadHelper from table: %s for (guid: %u) Loading",table,guid);
-        if (!obj->LoadFromDB(guid, map))
+        if (!obj->LoadFromSpawn(*itr, i_map))
         {
             delete obj;
             continue;
         }
 
+        objects.push_back(PreparedObject<T>(obj, itr->cellX, itr->cellY));
+    }
+}
+
+template<class T>
+void ObjectGridLoader::Link(std::vector<PreparedObject<T> > const& objects, uint32& count)
+{
+    for (typename std::vector<PreparedObject<T> >::const_iterator itr = objects.begin(); itr != objects.end(); ++itr)
+    {
+        T* obj = itr->obj;
+        GridType& grid = i_grid(itr->cellX, itr->cellY);
+
         grid.AddGridObject(obj);
 
-        addUnitState(obj,cell);
+        addUnitState(obj, CellPair(i_cell.GridX()*MAX_NUMBER_OF_CELLS + itr->cellX, i_cell.GridY()*MAX_NUMBER_OF_CELLS + itr->cellY));
         obj->AddToWorld();
 
         if (obj->isActiveObject())
-            map->AddToActive(obj);
+            i_map->AddToActive(obj);
 
         obj->GetViewPoint().Event_AddedToWorld(&grid);
 
         ++count;
-
     }
 }
 
@@ -166,31 +238,6 @@ void LoadHelper(CellCorpseSet const& cell_corpses, CellPair &cell, CorpseMapType
     }
 }
 
-void ObjectGridLoader::Visit(GameObjectMapType &m)
-{
-    uint32 x = (i_cell.GridX()*MAX_NUMBER_OF_CELLS) + i_cell.CellX();
-    uint32 y = (i_cell.GridY()*MAX_NUMBER_OF_CELLS) + i_cell.CellY();
-    CellPair cell_pair(x,y);
-    uint32 cell_id = (cell_pair.y_coord*TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
-
-    CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cell_id);
-
-    GridType& grid = (*i_map->getNGrid(i_cell.GridX(),i_cell.GridY())) (i_cell.CellX(),i_cell.CellY());
-    LoadHelper(cell_guids.gameobjects, cell_pair, m, i_gameObjects, i_map, grid);
-}
-
-void ObjectGridLoader::Visit(CreatureMapType &m)
-{
-    uint32 x = (i_cell.GridX()*MAX_NUMBER_OF_CELLS) + i_cell.CellX();
-    uint32 y = (i_cell.GridY()*MAX_NUMBER_OF_CELLS) + i_cell.CellY();
-    CellPair cell_pair(x,y);
-    uint32 cell_id = (cell_pair.y_coord*TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
-
-    CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cell_id);
-    GridType& grid = (*i_map->getNGrid(i_cell.GridX(),i_cell.GridY())) (i_cell.CellX(),i_cell.CellY());
-    LoadHelper(cell_guids.creatures, cell_pair, m, i_creatures, i_map, grid);
-}
-
 void ObjectWorldLoader::Visit(CorpseMapType &m)
 {
     uint32 x = (i_cell.GridX()*MAX_NUMBER_OF_CELLS) + i_cell.CellX();
@@ -204,38 +251,85 @@ void ObjectWorldLoader::Visit(CorpseMapType &m)
     LoadHelper(cell_guids.corpses, cell_pair, m, i_corpses, i_map, grid);
 }
 
-void ObjectGridLoader::Load(GridType &grid)
+void ObjectGridLoader::LoadN(void)
 {
-    {
-        TypeContainerVisitor<ObjectGridLoader, GridTypeMapContainer > loader(*this);
-        grid.Visit(loader);
-    }
+    uint64 start = WorldTimer::getUSTime();
+
+    i_gameObjects = 0; i_creatures = 0; i_corpses = 0;
 
+    PreparedGridSpawns spawns;
+    bool prefetched = false;
+    if (PreparedGridSpawns* ready = sTerrainPrefetcher.TakeSpawns(i_map->GetId(), i_map->GetInstanceId(), i_cell.GridX(), i_cell.GridY()))
     {
-        ObjectWorldLoader wloader(*this);
-        TypeContainerVisitor<ObjectWorldLoader, WorldTypeMapContainer > loader(wloader);
-        grid.Visit(loader);
-        i_corpses = wloader.i_corpses;
+        // spawns were added to or removed from cells meanwhile
+        if (ready->spawnDataVersion == sObjectMgr.GetSpawnDataVersion(i_map->GetId()))
+        {
+            std::swap(spawns, *ready);
+            prefetched = true;
+        }
+
+        delete ready;
     }
-}
 
-void ObjectGridLoader::LoadN(void)
-{
-    i_gameObjects = 0; i_creatures = 0; i_corpses = 0;
-    i_cell.data.Part.cell_y = 0;
+    if (!prefetched)
+        PrepareSpawns(i_map->GetId(), i_map->GetInstanceId(), i_map->GetSpawnMode(), i_cell.GridX(), i_cell.GridY(), spawns, false);
+    else if (spawns.respawnTimesVersion != sObjectMgr.GetRespawnTimesVersion())
+        sObjectMgr.ReadRespawnTimes(spawns);
+
+    // stage one, nothing is in grid or world yet
+    std::vector<PreparedObject<GameObject> > gameObjects;
+    std::vector<PreparedObject<Creature> > creatures;
+    gameObjects.reserve(spawns.gameObjects.size());
+    creatures.reserve(spawns.creatures.size());
+    Create(spawns.gameObjects, gameObjects);
+    Create(spawns.creatures, creatures);
+
+    uint64 prepared = WorldTimer::getUSTime();
+
+    // stage two
+    Link(gameObjects, i_gameObjects);
+    Link(creatures, i_creatures);
+
     for (unsigned int x=0; x < MAX_NUMBER_OF_CELLS; ++x)
     {
         i_cell.data.Part.cell_x = x;
         for (unsigned int y=0; y < MAX_NUMBER_OF_CELLS; ++y)
         {
             i_cell.data.Part.cell_y = y;
-            GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes> loader;
-            loader.Load(i_grid(x, y), *this);
+            ObjectWorldLoader wloader(*this);
+            TypeContainerVisitor<ObjectWorldLoader, WorldTypeMapContainer > loader(wloader);
+            i_grid(x, y).Visit(loader);
+            i_corpses += wloader.i_corpses;
         }
     }
+
+    uint64 linked = WorldTimer::getUSTime();
+    i_map->AddGridLoad(i_gameObjects + i_creatures + i_corpses, uint32(prepared - start), uint32(linked - prepared), prefetched);
+
     sLog.outDebug("%u GameObjects, %u Creatures, and %u Corpses/Bones loaded for grid %u on map %u", i_gameObjects, i_creatures, i_corpses,i_grid.GetGridId(), i_map->GetId());
 }
 
+uint32 const GridLoadStats::BucketLimits[GRID_LOAD_HISTOGRAM_BUCKETS - 1] = { 1, 2, 5, 10, 20, 50, 100 };
+
+void GridLoadStats::Add(uint32 objectCount, uint32 prepare, uint32 link, bool wasPrefetched)
+{
+    uint32 total = prepare + link;
+
+    ++loads;
+    if (wasPrefetched)
+        ++prefetched;
+    objects += objectCount;
+    prepareTime += prepare;
+    linkTime += link;
+    maxTime = std::max(maxTime, total);
+
+    uint32 bucket = 0;
+    while (bucket < GRID_LOAD_HISTOGRAM_BUCKETS - 1 && total > BucketLimits[bucket] * 1000)
+        ++bucket;
+
+    ++histogram[bucket];
+}
+
 void ObjectGridUnloader::MoveToRespawnN()
 {
     for (unsigned int x=0; x < MAX_NUMBER_OF_CELLS; ++x)
@@ -28,7 +28,87 @@
 #include "Cell.h"
 
 class ObjectWorldLoader;
+struct CreatureData;
+struct CreatureInfo;
+struct GameObjectData;
 
+#define GRID_LOAD_HISTOGRAM_BUCKETS 8                       // up to 1, 2, 5, 10, 20, 50, 100 ms, more
+
+// grid loads of one map, written by map thread, others read Map::GetGridLoadStats snapshot
+struct GridLoadStats
+{
+    GridLoadStats() : loads(0), prefetched(0), objects(0), prepareTime(0), linkTime(0), maxTime(0)
+    {
+        memset(histogram, 0, sizeof(histogram));
+    }
+
+    void Add(uint32 objectCount, uint32 prepare, uint32 link, bool wasPrefetched);  // microseconds
+
+    static uint32 const BucketLimits[GRID_LOAD_HISTOGRAM_BUCKETS - 1];  // milliseconds
+
+    uint32 loads;
+    uint32 prefetched;                                      // loads with spawns prepared by TerrainPrefetcher
+    uint64 objects;
+    uint64 prepareTime;                                     // microseconds, creating and loading objects
+    uint64 linkTime;                                        // microseconds, adding them to grid and world
+    uint32 maxTime;
+    uint32 histogram[GRID_LOAD_HISTOGRAM_BUCKETS];          // loads by total time
+};
+
+// creature spawn with its data resolved, Creature::LoadFromSpawn
+struct PreparedCreatureSpawn
+{
+    PreparedCreatureSpawn(uint32 _guid, CreatureData const* _data, CreatureInfo const* _info)
+        : guid(_guid), data(_data), info(_info), respawnTime(0), groundKnown(false), groundZ(0.0f), cellX(0), cellY(0) {}
+
+    uint32 guid;                                            // in `creature` table
+    CreatureData const* data;
+    CreatureInfo const* info;
+    time_t respawnTime;
+    bool groundKnown;                                       // only for dead flying creatures
+    float groundZ;
+    uint8 cellX;                                            // in grid
+    uint8 cellY;
+};
+
+// gameobject spawn with its data resolved, GameObject::LoadFromSpawn
+struct PreparedGameObjectSpawn
+{
+    PreparedGameObjectSpawn(uint32 _guid, GameObjectData const* _data)
+        : guid(_guid), data(_data), respawnTime(0), cellX(0), cellY(0) {}
+
+    uint32 guid;                                            // in `gameobject` table
+    GameObjectData const* data;
+    time_t respawnTime;
+    uint8 cellX;                                            // in grid
+    uint8 cellY;
+};
+
+// all spawns of one grid of one map instance
+struct PreparedGridSpawns
+{
+    PreparedGridSpawns() : instanceId(0), spawnDataVersion(0), respawnTimesVersion(0), readyTime(0), prepareTime(0) {}
+
+    uint32 instanceId;
+    uint32 spawnDataVersion;                                // ObjectMgr::GetSpawnDataVersion when collected
+    uint32 respawnTimesVersion;                             // ObjectMgr::GetRespawnTimesVersion when read
+    uint32 readyTime;
+    uint32 prepareTime;                                     // microseconds
+    std::vector<PreparedCreatureSpawn> creatures;
+    std::vector<PreparedGameObjectSpawn> gameObjects;
+};
+
+/**
+ * Loads creatures, gameobjects and corpses of all cells of one grid.
+ *
+ * Runs in two stages. Spawns of the grid are prepared first: guids collected
+ * from cells, their data and templates resolved and respawn times read. This
+ * is done by TerrainPrefetcher on its I/O thread when a player approaches the
+ * grid, the map thread prepares them itself only if nothing was prefetched.
+ * Then on the map thread objects are created from prepared spawns and the
+ * whole grid is linked at once, objects are added to their cells, to world
+ * and to active objects. Time spent on map thread is added to GridLoadStats.
+ */
 class ObjectGridLoader
 {
     friend class ObjectWorldLoader;
@@ -38,16 +118,27 @@ class ObjectGridLoader
             : i_cell(cell), i_grid(grid), i_map(map), i_gameObjects(0), i_creatures(0), i_corpses (0)
             {}
 
-        void Load(GridType &grid);
-        void Visit(GameObjectMapType &m);
-        void Visit(CreatureMapType &m);
-        void Visit(CorpseMapType &) {}
-
-        void Visit(DynamicObjectMapType&) { }
-
         void LoadN(void);
 
+        // any thread, heights are looked up only when terrain of grid may be read from disk
+        static void PrepareSpawns(uint32 mapId, uint32 instanceId, uint8 spawnMode, uint32 gridX, uint32 gridY, PreparedGridSpawns& spawns, bool heights);
+
     private:
+        template<class T>
+        struct PreparedObject
+        {
+            PreparedObject(T* o, uint32 x, uint32 y) : obj(o), cellX(x), cellY(y) {}
+
+            T* obj;
+            uint32 cellX;                                   // in grid
+            uint32 cellY;
+        };
+
+        template<class T, class S>
+        void Create(std::vector<S> const& spawns, std::vector<PreparedObject<T> >& objects);
+        template<class T>
+        void Link(std::vector<PreparedObject<T> > const& objects, uint32& count);
+
         Cell i_cell;
         NGridType &i_grid;
         Map* i_map;
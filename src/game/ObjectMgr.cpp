@@ -46,6 +46,7 @@
 #include "Util.h"
 #include "WaypointMgr.h"
 #include "InstanceData.h" //for condition_instance_data
+#include "ObjectGridLoader.h"
 
 bool normalizePlayerName(std::string& name)
 {
@@ -116,6 +117,7 @@ ObjectMgr::ObjectMgr()
     m_mailid            = 1;
     m_arenaTeamId       = 1;
     m_auctionid         = 1;
+    m_respawnTimesVersion = 0;
 
     // Only zero condition left, others will be added while loading DB tables
     mConditions.resize(1);
@@ -840,8 +842,10 @@ void ObjectMgr::AddCreatureToGrid(uint32 guid, CreatureData const* data)
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord*TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_spawnDataLock);
             CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid,i)][cell_id];
             cell_guids.creatures.insert(guid);
+            ++m_spawnDataVersions[data->mapid];
         }
     }
 }
@@ -856,8 +860,10 @@ void ObjectMgr::RemoveCreatureFromGrid(uint32 guid, CreatureData const* data)
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord*TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_spawnDataLock);
             CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid,i)][cell_id];
             cell_guids.creatures.erase(guid);
+            ++m_spawnDataVersions[data->mapid];
         }
     }
 }
@@ -1014,8 +1020,10 @@ void ObjectMgr::AddGameobjectToGrid(uint32 guid, GameObjectData const* data)
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord*TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_spawnDataLock);
             CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid,i)][cell_id];
             cell_guids.gameobjects.insert(guid);
+            ++m_spawnDataVersions[data->mapid];
         }
     }
 }
@@ -1030,8 +1038,10 @@ void ObjectMgr::RemoveGameobjectFromGrid(uint32 guid, GameObjectData const* data
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord*TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_spawnDataLock);
             CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid,i)][cell_id];
             cell_guids.gameobjects.erase(guid);
+            ++m_spawnDataVersions[data->mapid];
         }
     }
 }
@@ -4790,7 +4800,12 @@ void ObjectMgr::LoadWeatherZoneChances()
 
 void ObjectMgr::SaveCreatureRespawnTime(uint32 loguid, uint32 instance, time_t t)
 {
-    mCreatureRespawnTimes[MAKE_PAIR64(loguid,instance)] = t;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_respawnTimesLock);
+        mCreatureRespawnTimes[MAKE_PAIR64(loguid,instance)] = t;
+        ++m_respawnTimesVersion;
+    }
+
     RealmDataDatabase.BeginTransaction();
     RealmDataDatabase.PExecute("DELETE FROM creature_respawn WHERE guid = '%u' AND instance = '%u'", loguid, instance);
     if (t)
@@ -4805,12 +4820,24 @@ void ObjectMgr::DeleteCreatureData(uint32 guid)
     if (data)
         RemoveCreatureFromGrid(guid, data);
 
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_spawnDataLock);
     mCreatureDataMap.erase(guid);
 }
 
+CreatureData& ObjectMgr::NewOrExistCreatureData(uint32 guid)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_spawnDataLock, mCreatureDataMap[guid]);
+    return mCreatureDataMap[guid];
+}
+
 void ObjectMgr::SaveGORespawnTime(uint32 loguid, uint32 instance, time_t t)
 {
-    mGORespawnTimes[MAKE_PAIR64(loguid,instance)] = t;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_respawnTimesLock);
+        mGORespawnTimes[MAKE_PAIR64(loguid,instance)] = t;
+        ++m_respawnTimesVersion;
+    }
+
     RealmDataDatabase.BeginTransaction();
     RealmDataDatabase.PExecute("DELETE FROM gameobject_respawn WHERE guid = '%u' AND instance = '%u'", loguid, instance);
     if (t)
@@ -4820,24 +4847,30 @@ void ObjectMgr::SaveGORespawnTime(uint32 loguid, uint32 instance, time_t t)
 
 void ObjectMgr::DeleteRespawnTimeForInstance(uint32 instance)
 {
-    RespawnTimes::iterator next;
-
-    for (RespawnTimes::iterator itr = mGORespawnTimes.begin(); itr != mGORespawnTimes.end(); itr = next)
     {
-        next = itr;
-        ++next;
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_respawnTimesLock);
 
-        if (GUID_HIPART(itr->first)==instance)
-            mGORespawnTimes.erase(itr);
-    }
+        RespawnTimes::iterator next;
 
-    for (RespawnTimes::iterator itr = mCreatureRespawnTimes.begin(); itr != mCreatureRespawnTimes.end(); itr = next)
-    {
-        next = itr;
-        ++next;
+        for (RespawnTimes::iterator itr = mGORespawnTimes.begin(); itr != mGORespawnTimes.end(); itr = next)
+        {
+            next = itr;
+            ++next;
+
+            if (GUID_HIPART(itr->first)==instance)
+                mGORespawnTimes.erase(itr);
+        }
+
+        for (RespawnTimes::iterator itr = mCreatureRespawnTimes.begin(); itr != mCreatureRespawnTimes.end(); itr = next)
+        {
+            next = itr;
+            ++next;
+
+            if (GUID_HIPART(itr->first)==instance)
+                mCreatureRespawnTimes.erase(itr);
+        }
 
-        if (GUID_HIPART(itr->first)==instance)
-            mCreatureRespawnTimes.erase(itr);
+        ++m_respawnTimesVersion;
     }
 
     if (instance != 0)
@@ -4856,12 +4889,99 @@ void ObjectMgr::DeleteGOData(uint32 guid)
     if (data)
         RemoveGameobjectFromGrid(guid, data);
 
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_spawnDataLock);
     mGameObjectDataMap.erase(guid);
 }
 
+GameObjectData& ObjectMgr::NewGOData(uint32 guid)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_spawnDataLock, mGameObjectDataMap[guid]);
+    return mGameObjectDataMap[guid];
+}
+
+CellObjectGuids const& ObjectMgr::GetCellObjectGuids(uint16 mapid, uint8 spawnMode, uint32 cell_id)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_spawnDataLock, mMapObjectGuids[MAKE_PAIR32(mapid,spawnMode)][cell_id]);
+    return mMapObjectGuids[MAKE_PAIR32(mapid,spawnMode)][cell_id];
+}
+
+void ObjectMgr::CollectCellSpawns(uint32 mapid, uint8 spawnMode, uint32 cell_id, uint8 cellX, uint8 cellY, PreparedGridSpawns& spawns)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_spawnDataLock);
+
+    MapObjectGuids::const_iterator map = mMapObjectGuids.find(MAKE_PAIR32(mapid,spawnMode));
+    if (map == mMapObjectGuids.end())
+        return;
+
+    CellObjectGuidsMap::const_iterator cell = map->second.find(cell_id);
+    if (cell == map->second.end())
+        return;
+
+    for (CellGuidSet::const_iterator itr = cell->second.gameobjects.begin(); itr != cell->second.gameobjects.end(); ++itr)
+    {
+        spawns.gameObjects.push_back(PreparedGameObjectSpawn(*itr, GetGOData(*itr)));
+        spawns.gameObjects.back().cellX = cellX;
+        spawns.gameObjects.back().cellY = cellY;
+    }
+
+    for (CellGuidSet::const_iterator itr = cell->second.creatures.begin(); itr != cell->second.creatures.end(); ++itr)
+    {
+        CreatureData const* data = GetCreatureData(*itr);
+        spawns.creatures.push_back(PreparedCreatureSpawn(*itr, data, data ? GetCreatureTemplate(data->id) : NULL));
+        spawns.creatures.back().cellX = cellX;
+        spawns.creatures.back().cellY = cellY;
+    }
+}
+
+uint32 ObjectMgr::GetSpawnDataVersion(uint32 mapid)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_spawnDataLock, 0);
+    return m_spawnDataVersions[mapid];
+}
+
+time_t ObjectMgr::GetCreatureRespawnTime(uint32 loguid, uint32 instance)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_respawnTimesLock, 0);
+    RespawnTimes::const_iterator itr = mCreatureRespawnTimes.find(MAKE_PAIR64(loguid,instance));
+    return itr != mCreatureRespawnTimes.end() ? itr->second : 0;
+}
+
+time_t ObjectMgr::GetGORespawnTime(uint32 loguid, uint32 instance)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_respawnTimesLock, 0);
+    RespawnTimes::const_iterator itr = mGORespawnTimes.find(MAKE_PAIR64(loguid,instance));
+    return itr != mGORespawnTimes.end() ? itr->second : 0;
+}
+
+void ObjectMgr::ReadRespawnTimes(PreparedGridSpawns& spawns)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_respawnTimesLock);
+
+    for (std::vector<PreparedCreatureSpawn>::iterator itr = spawns.creatures.begin(); itr != spawns.creatures.end(); ++itr)
+    {
+        RespawnTimes::const_iterator time = mCreatureRespawnTimes.find(MAKE_PAIR64(itr->guid,spawns.instanceId));
+        itr->respawnTime = time != mCreatureRespawnTimes.end() ? time->second : 0;
+    }
+
+    for (std::vector<PreparedGameObjectSpawn>::iterator itr = spawns.gameObjects.begin(); itr != spawns.gameObjects.end(); ++itr)
+    {
+        RespawnTimes::const_iterator time = mGORespawnTimes.find(MAKE_PAIR64(itr->guid,spawns.instanceId));
+        itr->respawnTime = time != mGORespawnTimes.end() ? time->second : 0;
+    }
+
+    spawns.respawnTimesVersion = m_respawnTimesVersion;
+}
+
+uint32 ObjectMgr::GetRespawnTimesVersion()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_respawnTimesLock, 0);
+    return m_respawnTimesVersion;
+}
+
 void ObjectMgr::AddCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_guid, uint32 instance)
 {
     // corpses are always added to spawn mode 0 and they are spawned by their instance id
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_spawnDataLock);
     CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(mapid,0)][cellid];
     cell_guids.corpses[player_guid] = instance;
 }
@@ -4869,6 +4989,7 @@ void ObjectMgr::AddCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_gui
 void ObjectMgr::DeleteCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_guid)
 {
     // corpses are always added to spawn mode 0 and they are spawned by their instance id
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_spawnDataLock);
     CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(mapid,0)][cellid];
     cell_guids.corpses.erase(player_guid);
 }
@@ -6251,6 +6372,13 @@ void ObjectMgr::UpdateRolls(uint32 diff)
     {
         if ((*itr)->rollTimer <= diff)
         {
+            // winner and loot may be on decoupled instance, count the roll once it finished its update
+            if ((*itr)->IsInDecoupledUpdate())
+            {
+                ++itr;
+                continue;
+            }
+
             if ((*itr)->isValid())
                 (*itr)->CountTheRoll(); // good value?
 
@@ -58,6 +58,7 @@ extern SQLStorage sInstanceTemplate;
 class Group;
 class Guild;
 class ArenaTeam;
+struct PreparedGridSpawns;
 class Item;
 
 struct GameTele
@@ -577,10 +578,7 @@ class ObjectMgr
                 return NULL;
         }
 
-        CellObjectGuids const& GetCellObjectGuids(uint16 mapid, uint8 spawnMode, uint32 cell_id)
-        {
-            return mMapObjectGuids[MAKE_PAIR32(mapid,spawnMode)][cell_id];
-        }
+        CellObjectGuids const& GetCellObjectGuids(uint16 mapid, uint8 spawnMode, uint32 cell_id);
 
         CreatureData const* GetCreatureData(uint32 guid) const
         {
@@ -589,7 +587,7 @@ class ObjectMgr
             return &itr->second;
         }
 
-        CreatureData& NewOrExistCreatureData(uint32 guid) { return mCreatureDataMap[guid]; }
+        CreatureData& NewOrExistCreatureData(uint32 guid);
         void DeleteCreatureData(uint32 guid);
 
         uint32 GetLinkedRespawnGuid(uint32 guid) const
@@ -606,7 +604,7 @@ class ObjectMgr
             return &itr->second;
         }
 
-        GameObjectData& NewGOData(uint32 guid) { return mGameObjectDataMap[guid]; }
+        GameObjectData& NewGOData(uint32 guid);
         void DeleteGOData(uint32 guid);
 
         bool HasMangosString(int32 entry) const
@@ -621,11 +619,21 @@ class ObjectMgr
         void AddCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_guid, uint32 instance);
         void DeleteCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_guid);
 
-        time_t GetCreatureRespawnTime(uint32 loguid, uint32 instance) { return mCreatureRespawnTimes[MAKE_PAIR64(loguid,instance)]; }
+        // respawn times are read and saved by map threads, all access goes through m_respawnTimesLock
+        time_t GetCreatureRespawnTime(uint32 loguid, uint32 instance);
         void SaveCreatureRespawnTime(uint32 loguid, uint32 instance, time_t t);
-        time_t GetGORespawnTime(uint32 loguid, uint32 instance) { return mGORespawnTimes[MAKE_PAIR64(loguid,instance)]; }
+        time_t GetGORespawnTime(uint32 loguid, uint32 instance);
         void SaveGORespawnTime(uint32 loguid, uint32 instance, time_t t);
         void DeleteRespawnTimeForInstance(uint32 instance);
+        // respawn times of all prepared spawns under one lock
+        void ReadRespawnTimes(PreparedGridSpawns& spawns);
+        // changes whenever any respawn time is saved or deleted
+        uint32 GetRespawnTimesVersion();
+
+        // any thread, adds creatures and gameobjects of one cell with their data resolved
+        void CollectCellSpawns(uint32 mapid, uint8 spawnMode, uint32 cell_id, uint8 cellX, uint8 cellY, PreparedGridSpawns& spawns);
+        // changes whenever spawns of map are added to or removed from cells, prepared spawns are outdated then
+        uint32 GetSpawnDataVersion(uint32 mapid);
 
         // grid objects
         void AddCreatureToGrid(uint32 guid, CreatureData const* data);
@@ -808,13 +816,18 @@ class ObjectMgr
         HalfNameMap PetHalfName0;
         HalfNameMap PetHalfName1;
 
+        // guards layout of cell and spawn data maps, not the data itself, see CollectCellSpawns
+        ACE_Thread_Mutex m_spawnDataLock;
         MapObjectGuids mMapObjectGuids;
         CreatureDataMap mCreatureDataMap;
         CreatureLinkedRespawnMap mCreatureLinkedRespawnMap;
         GameObjectDataMap mGameObjectDataMap;
+        std::map<uint32, uint32> m_spawnDataVersions;       // by map id
         MangosStringMap mMangosStringMap;
+        ACE_Thread_Mutex m_respawnTimesLock;
         RespawnTimes mCreatureRespawnTimes;
         RespawnTimes mGORespawnTimes;
+        uint32 m_respawnTimesVersion;
 
         OpcodesCooldown _opcodesCooldown;
 
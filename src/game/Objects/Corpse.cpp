@@ -189,7 +189,7 @@ bool Corpse::LoadFromDB(uint32 guid, Field *fields)
     float ort       = fields[3].GetFloat();
     uint32 mapid    = fields[4].GetUInt32();
 
-    if (!LoadValues(fields[5].GetString()))
+    if (!LoadValues(fields[5].GetString(), fields[5].GetLength()))
     {
         sLog.outLog(LOG_DEFAULT, "ERROR: Corpse #%d have broken data in `data` field. Can't be loaded.",guid);
         return false;
@@ -33,6 +33,7 @@
 #include "PoolManager.h"
 #include "Opcodes.h"
 #include "Log.h"
+#include "Profiler.h"
 #include "LootMgr.h"
 #include "MapManager.h"
 #include "CreatureAI.h"
@@ -584,6 +585,7 @@ void Creature::Update(uint32 update_diff, uint32 diff)
             if (!IsInEvadeMode() && IsAIEnabled)
             {
                 // do not allow the AI to be changed during update
+                ProfileSumZone zone("Creature UpdateAI");
                 m_AI_locked = true;
                 i_AI->UpdateAI(update_diff);
                 m_AI_locked = false;
@@ -1507,6 +1509,18 @@ bool Creature::LoadFromDB(uint32 guid, Map *map)
 {
     CreatureData const* data = sObjectMgr.GetCreatureData(guid);
 
+    PreparedCreatureSpawn spawn(guid, data, data ? sObjectMgr.GetCreatureTemplate(data->id) : NULL);
+    if (data)
+        spawn.respawnTime = sObjectMgr.GetCreatureRespawnTime(guid, map->GetInstanceId());
+
+    return LoadFromSpawn(spawn, map);
+}
+
+bool Creature::LoadFromSpawn(PreparedCreatureSpawn const& spawn, Map *map)
+{
+    uint32 guid = spawn.guid;
+    CreatureData const* data = spawn.data;
+
     if (!data)
     {
         sLog.outLog(LOG_DB_ERR, "Creature (GUID: %u) not found in table `creature`, can't load. ",guid);
@@ -1530,7 +1544,7 @@ bool Creature::LoadFromDB(uint32 guid, Map *map)
     m_isDeadByDefault = data->is_dead;
     m_deathState = m_isDeadByDefault ? DEAD : ALIVE;
 
-    m_respawnTime = sObjectMgr.GetCreatureRespawnTime(m_DBTableGuid,GetInstanceId());
+    m_respawnTime = spawn.respawnTime;
     if (m_respawnTime)                          // respawn on Update
     {
         m_deathState = DEAD;
@@ -1539,7 +1553,7 @@ bool Creature::LoadFromDB(uint32 guid, Map *map)
 
         if (CanFly())
         {
-            float tz = GetTerrain()->GetHeight(data->posX,data->posY,data->posZ,false);
+            float tz = spawn.groundKnown ? spawn.groundZ : GetTerrain()->GetHeight(data->posX,data->posY,data->posZ,false);
             if (data->posZ - tz > 0.1)
                 Relocate(data->posX,data->posY,tz);
         }
@@ -1560,7 +1574,7 @@ bool Creature::LoadFromDB(uint32 guid, Map *map)
     m_defaultMovementType = MovementGeneratorType(data->movementType);
     
 
-    if (CreatureInfo const* info = sObjectMgr.GetCreatureTemplate(data->id))
+    if (CreatureInfo const* info = spawn.info)
         m_xpMod = info->xpMod;
     else
         m_xpMod = 0.0f;
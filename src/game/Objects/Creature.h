@@ -542,6 +542,7 @@ class Creature : public Unit
         void setDeathState(DeathState s);                   // overwrite virtual Unit::setDeathState
 
         bool LoadFromDB(uint32 guid, Map *map);
+        bool LoadFromSpawn(PreparedCreatureSpawn const& spawn, Map *map);
         virtual void SaveToDB();                            // overwrited in TemporarySummon (to do nothing)
                                                             // overwrited in Pet and TemporarySummon
         virtual void SaveToDB(uint32 mapid, uint8 spawnMask);
@@ -633,7 +633,17 @@ void GameObject::SaveToDB(uint32 mapid, uint8 spawnMask)
 
 bool GameObject::LoadFromDB(uint32 guid, Map *map)
 {
-    GameObjectData const* data = sObjectMgr.GetGOData(guid);
+    PreparedGameObjectSpawn spawn(guid, sObjectMgr.GetGOData(guid));
+    if (spawn.data)
+        spawn.respawnTime = sObjectMgr.GetGORespawnTime(guid, map->GetInstanceId());
+
+    return LoadFromSpawn(spawn, map);
+}
+
+bool GameObject::LoadFromSpawn(PreparedGameObjectSpawn const& spawn, Map *map)
+{
+    uint32 guid = spawn.guid;
+    GameObjectData const* data = spawn.data;
 
     if (!data)
     {
@@ -680,7 +690,7 @@ bool GameObject::LoadFromDB(uint32 guid, Map *map)
         {
             m_spawnedByDefault = true;
             m_respawnDelayTime = data->spawntimesecs;
-            m_respawnTime = sObjectMgr.GetGORespawnTime(m_DBTableGuid, map->GetInstanceId());
+            m_respawnTime = spawn.respawnTime;
 
             // ready to respawn
             if (m_respawnTime && m_respawnTime <= time(NULL))
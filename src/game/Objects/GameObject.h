@@ -487,6 +487,7 @@ class GameObject : public WorldObject
         void SaveToDB();
         void SaveToDB(uint32 mapid, uint8 spawnMask);
         bool LoadFromDB(uint32 guid, Map *map);
+        bool LoadFromSpawn(PreparedGameObjectSpawn const& spawn, Map *map);
         void DeleteFromDB();
 
         static uint32 GetLootId(GameObjectInfo const* info);
@@ -322,12 +322,10 @@ void Item::SaveToDB()
             stmt.PExecute(guid);
 
             stmt = RealmDataDatabase.CreateStatement(saveItem, "INSERT INTO item_instance (guid, owner_guid, data) VALUES (?, ?, ?)");
-
-            std::ostringstream ss;
-            for (uint16 i = 0; i < m_valuesCount; i++)
-                ss << GetUInt32Value(i) << " ";
-
-            stmt.PExecute(guid, GUID_LOPART(GetOwnerGUID()), ss.str().c_str());
+            stmt.addUInt32(guid);
+            stmt.addUInt32(GUID_LOPART(GetOwnerGUID()));
+            stmt.addBinary(GetUInt32ValuesBlob());
+            stmt.Execute();
         }
         break;
         case ITEM_CHANGED:
@@ -336,12 +334,10 @@ void Item::SaveToDB()
             static SqlStatementID updateGift;
 
             SqlStatement stmt = RealmDataDatabase.CreateStatement(updateItem, "UPDATE item_instance SET data = ?,  owner_guid = ? WHERE guid = ?");
-
-            std::ostringstream ss;
-            for (uint16 i = 0; i < m_valuesCount; i++)
-                ss << GetUInt32Value(i) << " ";
-
-            stmt.PExecute(ss.str().c_str(), GUID_LOPART(GetOwnerGUID()), guid);
+            stmt.addBinary(GetUInt32ValuesBlob());
+            stmt.addUInt32(GUID_LOPART(GetOwnerGUID()));
+            stmt.addUInt32(guid);
+            stmt.Execute();
 
             if (HasFlag(ITEM_FIELD_FLAGS, ITEM_FLAGS_WRAPPED))
             {
@@ -397,7 +393,7 @@ bool Item::LoadFromDB(uint32 guid, uint64 owner_guid, QueryResultAutoPtr result)
 
     Field *fields = result->Fetch();
 
-    if (!LoadValues(fields[0].GetString()))
+    if (!LoadValues(fields[0].GetString(), fields[0].GetLength()))
     {
         sLog.outLog(LOG_DEFAULT, "ERROR: Item #%d have broken data in `data` field. Can't be loaded.",guid);
         return false;
@@ -447,13 +443,13 @@ bool Item::LoadFromDB(uint32 guid, uint64 owner_guid, QueryResultAutoPtr result)
 
     if (need_save)                                           // normal item changed state set not work at loading
     {
-        std::ostringstream ss;
-        ss << "UPDATE item_instance SET data = '";
-        for (uint16 i = 0; i < m_valuesCount; i++)
-            ss << GetUInt32Value(i) << " ";
-        ss << "', owner_guid = '" << GUID_LOPART(GetOwnerGUID()) << "' WHERE guid = '" << guid << "'";
+        static SqlStatementID updateItem;
 
-        RealmDataDatabase.Execute(ss.str().c_str());
+        SqlStatement stmt = RealmDataDatabase.CreateStatement(updateItem, "UPDATE item_instance SET data = ?,  owner_guid = ? WHERE guid = ?");
+        stmt.addBinary(GetUInt32ValuesBlob());
+        stmt.addUInt32(GUID_LOPART(GetOwnerGUID()));
+        stmt.addUInt32(guid);
+        stmt.Execute();
     }
 
     return true;
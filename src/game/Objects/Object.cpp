@@ -75,7 +75,6 @@ Object::Object()
     m_objectType        = TYPEMASK_OBJECT;
 
     m_uint32Values      = 0;
-    m_uint32Values_mirror = 0;
     m_valuesCount       = 0;
 
     m_inWorld           = false;
@@ -98,10 +97,8 @@ Object::~Object()
         ASSERT(!m_objectUpdated);
 
         delete [] m_uint32Values;
-        delete [] m_uint32Values_mirror;
 
         m_uint32Values = NULL;
-        m_uint32Values_mirror = NULL;
     }
 }
 
@@ -110,8 +107,7 @@ void Object::_InitValues()
     m_uint32Values = new uint32[ m_valuesCount ];
     memset(m_uint32Values, 0, m_valuesCount*sizeof(uint32));
 
-    m_uint32Values_mirror = new uint32[ m_valuesCount ];
-    memset(m_uint32Values_mirror, 0, m_valuesCount*sizeof(uint32));
+    m_changedValues.SetCount(m_valuesCount);
 
     m_objectUpdated = false;
 }
@@ -411,176 +407,164 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer * data, UpdateMask *
     *data << (uint8)updateMask->GetBlockCount();
     data->append(updateMask->GetMask(), updateMask->GetLength());
 
-    // 2 specialized loops for speed optimization in non-unit case
+    // only set bits are visited, specialized loops skip index checks for other object types
     if (isType(TYPEMASK_UNIT))                               // unit (creature/player) case
     {
-        for (uint16 index = 0; index < m_valuesCount; index ++)
+        for (uint32 index = updateMask->GetNextBit(0); index < m_valuesCount; index = updateMask->GetNextBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            // remove custom flag before send
+            if (index == UNIT_NPC_FLAGS)
+                *data << uint32(m_uint32Values[ index ] & ~(UNIT_NPC_FLAG_GUARD | UNIT_NPC_FLAG_OUTDOORPVP));
+            // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+            else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
             {
-                // remove custom flag before send
-                if (index == UNIT_NPC_FLAGS)
-                    *data << uint32(m_uint32Values[ index ] & ~(UNIT_NPC_FLAG_GUARD | UNIT_NPC_FLAG_OUTDOORPVP));
-                // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-                else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
-                {
-                    // convert from float to uint32 and send
-                    *data << uint32(m_floatValues[ index ] < 0 ? 0 : m_floatValues[ index ]);
-                }
-                // there are some float values which may be negative or can't get negative due to other checks
-                else if (index >= UNIT_FIELD_NEGSTAT0   && index <= UNIT_FIELD_NEGSTAT4 ||
-                    index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6) ||
-                    index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6) ||
-                    index >= UNIT_FIELD_POSSTAT0   && index <= UNIT_FIELD_POSSTAT4)
-                {
-                    *data << uint32(m_floatValues[ index ]);
-                }
-                // Gamemasters should be always able to select units - remove not selectable flag
-                else if (index == UNIT_FIELD_FLAGS && target->IsGameMaster())
-                {
-                    *data << (m_uint32Values[ index ] & ~UNIT_FLAG_NOT_SELECTABLE);
-                }
-                // everything as % until in party
-                else if (index == UNIT_FIELD_MAXHEALTH && !target->IsInRaidWith((Unit*)this) && !target->IsInPartyWith((Unit*)this))
-                {
-                    *data << uint32(100);
-                }
-                else if (index == UNIT_FIELD_HEALTH && !target->IsInRaidWith((Unit*)this) && !target->IsInPartyWith((Unit*)this))
-                {
-                    *data << uint32(ceil(float(m_uint32Values[index])*100.f / float(m_uint32Values[index + 6])));
-                }
-                // use modelid_a if not gm, _h if gm for CREATURE_FLAG_EXTRA_TRIGGER creatures
-                else if (index == UNIT_FIELD_DISPLAYID && GetTypeId() == TYPEID_UNIT)
+                // convert from float to uint32 and send
+                *data << uint32(m_floatValues[ index ] < 0 ? 0 : m_floatValues[ index ]);
+            }
+            // there are some float values which may be negative or can't get negative due to other checks
+            else if (index >= UNIT_FIELD_NEGSTAT0   && index <= UNIT_FIELD_NEGSTAT4 ||
+                index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6) ||
+                index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6) ||
+                index >= UNIT_FIELD_POSSTAT0   && index <= UNIT_FIELD_POSSTAT4)
+            {
+                *data << uint32(m_floatValues[ index ]);
+            }
+            // Gamemasters should be always able to select units - remove not selectable flag
+            else if (index == UNIT_FIELD_FLAGS && target->IsGameMaster())
+            {
+                *data << (m_uint32Values[ index ] & ~UNIT_FLAG_NOT_SELECTABLE);
+            }
+            // everything as % until in party
+            else if (index == UNIT_FIELD_MAXHEALTH && !target->IsInRaidWith((Unit*)this) && !target->IsInPartyWith((Unit*)this))
+            {
+                *data << uint32(100);
+            }
+            else if (index == UNIT_FIELD_HEALTH && !target->IsInRaidWith((Unit*)this) && !target->IsInPartyWith((Unit*)this))
+            {
+                *data << uint32(ceil(float(m_uint32Values[index])*100.f / float(m_uint32Values[index + 6])));
+            }
+            // use modelid_a if not gm, _h if gm for CREATURE_FLAG_EXTRA_TRIGGER creatures
+            else if (index == UNIT_FIELD_DISPLAYID && GetTypeId() == TYPEID_UNIT)
+            {
+                const CreatureInfo* cinfo = ((Creature*)this)->GetCreatureInfo();
+                if (cinfo->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER)
                 {
-                    const CreatureInfo* cinfo = ((Creature*)this)->GetCreatureInfo();
-                    if (cinfo->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER)
+                    if (target->isGMTriggersVisible())
                     {
-                        if (target->isGMTriggersVisible())
-                        {
-                            if (cinfo->Modelid_A2)
-                                *data << cinfo->Modelid_A1;
-                            else
-                                *data << 17519; // world invisible trigger's model
-                        }
+                        if (cinfo->Modelid_A2)
+                            *data << cinfo->Modelid_A1;
                         else
-                        {
-                            if (cinfo->Modelid_A2)
-                                *data << cinfo->Modelid_A2;
-                            else
-                                *data << 11686; // world invisible trigger's model
-                        }
+                            *data << 17519; // world invisible trigger's model
                     }
                     else
-                        *data << m_uint32Values[ index ];
+                    {
+                        if (cinfo->Modelid_A2)
+                            *data << cinfo->Modelid_A2;
+                        else
+                            *data << 11686; // world invisible trigger's model
+                    }
                 }
-                // hide lootable animation for unallowed players
-                else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
+                else
+                    *data << m_uint32Values[ index ];
+            }
+            // hide lootable animation for unallowed players
+            else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
+            {
+                if (!target->isAllowedToLoot((Creature*)this))
+                    *data << (m_uint32Values[ index ] & ~UNIT_DYNFLAG_LOOTABLE);
+                else
+                    *data << (m_uint32Values[ index ] & ~UNIT_DYNFLAG_OTHER_TAGGER);
+            }
+            // FG: pretend that OTHER players in own group are friendly ("blue")
+            else if (index == UNIT_FIELD_BYTES_2 || index == UNIT_FIELD_FACTIONTEMPLATE)
+            {
+            bool ch = false;
+                if (target->GetTypeId() == TYPEID_PLAYER && GetTypeId() == TYPEID_PLAYER && target != this)
                 {
-                    if (!target->isAllowedToLoot((Creature*)this))
-                        *data << (m_uint32Values[ index ] & ~UNIT_DYNFLAG_LOOTABLE);
-                    else
-                        *data << (m_uint32Values[ index ] & ~UNIT_DYNFLAG_OTHER_TAGGER);
-                }
-                // FG: pretend that OTHER players in own group are friendly ("blue")
-                else if (index == UNIT_FIELD_BYTES_2 || index == UNIT_FIELD_FACTIONTEMPLATE)
+                if (target->IsInSameGroupWith((Player*)this) || target->IsInSameRaidWith((Player*)this))
                 {
-                bool ch = false;
-                    if (target->GetTypeId() == TYPEID_PLAYER && GetTypeId() == TYPEID_PLAYER && target != this)
+                    if (index == UNIT_FIELD_BYTES_2)
                     {
-                    if (target->IsInSameGroupWith((Player*)this) || target->IsInSameRaidWith((Player*)this))
+                        DEBUG_LOG("-- VALUES_UPDATE: Sending '%s' the blue-group-fix from '%s' (flag)", target->GetName(), ((Player*)this)->GetName());
+                        *data << (m_uint32Values[ index ] & ((UNIT_BYTE2_FLAG_SANCTUARY | UNIT_BYTE2_FLAG_AURAS | UNIT_BYTE2_FLAG_UNK5) << 8)); // this flag is at uint8 offset 1 !!
+
+                        ch = true;
+                    }
+                    else if (index == UNIT_FIELD_FACTIONTEMPLATE)
                     {
-                        if (index == UNIT_FIELD_BYTES_2)
+                        FactionTemplateEntry const *ft1, *ft2;
+                        ft1 = ((Player*)this)->getFactionTemplateEntry();
+                        ft2 = ((Player*)target)->getFactionTemplateEntry();
+                        if (ft1 && ft2 && !ft1->IsFriendlyTo(*ft2))
                         {
-                            DEBUG_LOG("-- VALUES_UPDATE: Sending '%s' the blue-group-fix from '%s' (flag)", target->GetName(), ((Player*)this)->GetName());
-                            *data << (m_uint32Values[ index ] & ((UNIT_BYTE2_FLAG_SANCTUARY | UNIT_BYTE2_FLAG_AURAS | UNIT_BYTE2_FLAG_UNK5) << 8)); // this flag is at uint8 offset 1 !!
-
+                            uint32 faction = ((Player*)target)->getFaction(); // pretend that all other HOSTILE players have own faction, to allow follow, heal, rezz (trade wont work)
+                            DEBUG_LOG("-- VALUES_UPDATE: Sending '%s' the blue-group-fix from '%s' (faction %u)", target->GetName(), ((Player*)this)->GetName(), faction);
+                            *data << uint32(faction);
                             ch = true;
                         }
-                        else if (index == UNIT_FIELD_FACTIONTEMPLATE)
-                        {
-                            FactionTemplateEntry const *ft1, *ft2;
-                            ft1 = ((Player*)this)->getFactionTemplateEntry();
-                            ft2 = ((Player*)target)->getFactionTemplateEntry();
-                            if (ft1 && ft2 && !ft1->IsFriendlyTo(*ft2))
-                            {
-                                uint32 faction = ((Player*)target)->getFaction(); // pretend that all other HOSTILE players have own faction, to allow follow, heal, rezz (trade wont work)
-                                DEBUG_LOG("-- VALUES_UPDATE: Sending '%s' the blue-group-fix from '%s' (faction %u)", target->GetName(), ((Player*)this)->GetName(), faction);
-                                *data << uint32(faction);
-                                ch = true;
-                            }
-                        }
-                    }
                     }
-                    if (!ch)
-                        *data << m_uint32Values[ index ];
                 }
-                else
-                {
-                    // send in current format (float as float, uint32 as uint32)
-                    *data << m_uint32Values[ index ];
                 }
+                if (!ch)
+                    *data << m_uint32Values[ index ];
+            }
+            else
+            {
+                // send in current format (float as float, uint32 as uint32)
+                *data << m_uint32Values[ index ];
             }
         }
     }
     else if (isType(TYPEMASK_GAMEOBJECT))                    // gameobject case
     {
-        for (uint16 index = 0; index < m_valuesCount; index ++)
+        for (uint32 index = updateMask->GetNextBit(0); index < m_valuesCount; index = updateMask->GetNextBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            // send in current format (float as float, uint32 as uint32)
+            if (index == GAMEOBJECT_DYN_FLAGS)
             {
-                // send in current format (float as float, uint32 as uint32)
-                if (index == GAMEOBJECT_DYN_FLAGS)
+                if (IsActivateToQuest)
                 {
-                    if (IsActivateToQuest)
+                    switch (((GameObject*)this)->GetGoType())
                     {
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_CHEST:
-                            case GAMEOBJECT_TYPE_GOOBER:
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
-                                *data << uint16(-1);
-                                break;
-                            default:
-                                *data << uint32(0);         // unknown. not happen.
-                                break;
-                        }
+                        case GAMEOBJECT_TYPE_CHEST:
+                        case GAMEOBJECT_TYPE_GOOBER:
+                            *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
+                            *data << uint16(-1);
+                            break;
+                        default:
+                            *data << uint32(0);         // unknown. not happen.
+                            break;
                     }
-                    else
-                        *data << uint32(0);                 // disable quest object
-                }
-                // hide RAF flag if need
-                else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_PLAYER)
-                {
-                    if (!((Player*)this)->IsReferAFriendLinked(target))
-                        *data << (m_uint32Values[index] & ~UNIT_DYNFLAG_REFER_A_FRIEND);
-                    else
-                        *data << m_uint32Values[index];
                 }
                 else
-                    *data << m_uint32Values[ index ];       // other cases
+                    *data << uint32(0);                 // disable quest object
+            }
+            // hide RAF flag if need
+            else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_PLAYER)
+            {
+                if (!((Player*)this)->IsReferAFriendLinked(target))
+                    *data << (m_uint32Values[index] & ~UNIT_DYNFLAG_REFER_A_FRIEND);
+                else
+                    *data << m_uint32Values[index];
             }
+            else
+                *data << m_uint32Values[ index ];       // other cases
         }
     }
     else                                                    // other objects case (no special index checks)
     {
-        for (uint16 index = 0; index < m_valuesCount; index ++)
+        for (uint32 index = updateMask->GetNextBit(0); index < m_valuesCount; index = updateMask->GetNextBit(index + 1))
         {
-            if (updateMask->GetBit(index))
-            {
-                // send in current format (float as float, uint32 as uint32)
-                *data << m_uint32Values[ index ];
-            }
+            // send in current format (float as float, uint32 as uint32)
+            *data << m_uint32Values[ index ];
         }
     }
 }
 
 void Object::ClearUpdateMask(bool remove)
 {
-    for (uint16 index = 0; index < m_valuesCount; index ++)
-    {
-        if (m_uint32Values_mirror[index]!= m_uint32Values[index])
-            m_uint32Values_mirror[index] = m_uint32Values[index];
-    }
+    m_changedValues.Clear();
+
     if (m_objectUpdated)
     {
         if (remove)
@@ -589,32 +573,85 @@ void Object::ClearUpdateMask(bool remove)
     }
 }
 
-bool Object::LoadValues(const char* data)
+bool Object::LoadValues(const char* data, uint32 length)
 {
     if (!m_uint32Values) _InitValues();
 
-    Tokens tokens = StrSplit(data, " ");
+    return DecodeValues(data, length, m_uint32Values, m_valuesCount);
+}
 
-    if (tokens.size() != m_valuesCount)
+bool Object::DecodeValues(const char* data, uint32 length, uint32* values, uint32 count)
+{
+    if (!data)
         return false;
 
-    Tokens::iterator iter;
-    int index;
-    for (iter = tokens.begin(), index = 0; index < m_valuesCount; ++iter, ++index)
+    if (length >= VALUES_BLOB_HEADER_SIZE && uint8(data[0]) == VALUES_BLOB_MAGIC)
     {
-        m_uint32Values[index] = atol((*iter).c_str());
+        if (uint8(data[1]) != VALUES_BLOB_VERSION)
+            return false;
+
+        uint32 stored = uint8(data[2]) | (uint8(data[3]) << 8);
+        if (stored != count || length != VALUES_BLOB_HEADER_SIZE + count * sizeof(uint32))
+            return false;
+
+        memcpy(values, data + VALUES_BLOB_HEADER_SIZE, count * sizeof(uint32));
+#if MANGOS_ENDIAN == MANGOS_BIGENDIAN
+        for (uint32 i = 0; i < count; ++i)
+            EndianConvert(values[i]);
+#endif
+        return true;
     }
 
-    return true;
+    // text row saved before blob format, values separated by spaces
+    // field values from db are always null terminated, strtoul can't run past the end
+    const char* end = data + length;
+    uint32 index = 0;
+    while (data < end)
+    {
+        while (data < end && *data == ' ')
+            ++data;
+
+        if (data >= end)
+            break;
+
+        if (index >= count)
+            return false;
+
+        char* next;
+        values[index++] = strtoul(data, &next, 10);
+        if (next == data)
+            return false;
+
+        data = next;
+    }
+
+    return index == count;
 }
 
-void Object::_SetUpdateBits(UpdateMask *updateMask, Player* /*target*/) const
+std::string Object::EncodeValues(uint32 const* values, uint32 count)
 {
-    for (uint16 index = 0; index < m_valuesCount; index ++)
+    std::string blob(VALUES_BLOB_HEADER_SIZE + count * sizeof(uint32), '\0');
+    blob[0] = char(VALUES_BLOB_MAGIC);
+    blob[1] = char(VALUES_BLOB_VERSION);
+    blob[2] = char(count & 0xFF);
+    blob[3] = char((count >> 8) & 0xFF);
+
+#if MANGOS_ENDIAN == MANGOS_BIGENDIAN
+    for (uint32 i = 0; i < count; ++i)
     {
-        if (m_uint32Values_mirror[index]!= m_uint32Values[index])
-            updateMask->SetBit(index);
+        uint32 value = values[i];
+        EndianConvert(value);
+        memcpy(&blob[VALUES_BLOB_HEADER_SIZE + i * sizeof(uint32)], &value, sizeof(uint32));
     }
+#else
+    memcpy(&blob[VALUES_BLOB_HEADER_SIZE], values, count * sizeof(uint32));
+#endif
+    return blob;
+}
+
+void Object::_SetUpdateBits(UpdateMask *updateMask, Player* /*target*/) const
+{
+    *updateMask = m_changedValues;
 
     if (GetTypeId() == TYPEID_PLAYER)
         updateMask->SetBit(UNIT_FIELD_BYTES_2);
@@ -637,14 +674,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
     {
         m_int32Values[ index ] = value;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                AddToClientUpdateList();
-                m_objectUpdated = true;
-            }
-        }
+        MarkValueChanged(index);
     }
 }
 
@@ -656,14 +686,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
     {
         m_uint32Values[ index ] = value;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                AddToClientUpdateList();
-                m_objectUpdated = true;
-            }
-        }
+        MarkValueChanged(index);
     }
 }
 
@@ -675,14 +698,8 @@ void Object::SetUInt64Value(uint16 index, const uint64 &value)
         m_uint32Values[ index ] = *((uint32*)&value);
         m_uint32Values[ index + 1 ] = *(((uint32*)&value) + 1);
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                AddToClientUpdateList();
-                m_objectUpdated = true;
-            }
-        }
+        MarkValueChanged(index);
+        MarkValueChanged(index + 1);
     }
 }
 
@@ -694,14 +711,7 @@ void Object::SetFloatValue(uint16 index, float value)
     {
         m_floatValues[ index ] = value;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                AddToClientUpdateList();
-                m_objectUpdated = true;
-            }
-        }
+        MarkValueChanged(index);
     }
 }
 
@@ -720,14 +730,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
         m_uint32Values[ index ] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[ index ] |= uint32(uint32(value) << (offset * 8));
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                AddToClientUpdateList();
-                m_objectUpdated = true;
-            }
-        }
+        MarkValueChanged(index);
     }
 }
 
@@ -746,14 +749,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
         m_uint32Values[ index ] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[ index ] |= uint32(uint32(value) << (offset * 16));
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                AddToClientUpdateList();
-                m_objectUpdated = true;
-            }
-        }
+        MarkValueChanged(index);
     }
 }
 
@@ -815,14 +811,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
     {
         m_uint32Values[ index ] = newval;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                AddToClientUpdateList();
-                m_objectUpdated = true;
-            }
-        }
+        MarkValueChanged(index);
     }
 }
 
@@ -836,14 +825,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
     {
         m_uint32Values[ index ] = newval;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                AddToClientUpdateList();
-                m_objectUpdated = true;
-            }
-        }
+        MarkValueChanged(index);
     }
 }
 
@@ -861,14 +843,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
     {
         m_uint32Values[ index ] |= uint32(uint32(newFlag) << (offset * 8));
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                AddToClientUpdateList();
-                m_objectUpdated = true;
-            }
-        }
+        MarkValueChanged(index);
     }
 }
 
@@ -886,14 +861,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
     {
         m_uint32Values[ index ] &= ~uint32(uint32(oldFlag) << (offset * 8));
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                AddToClientUpdateList();
-                m_objectUpdated = true;
-            }
-        }
+        MarkValueChanged(index);
     }
 }
 
@@ -1381,15 +1349,7 @@ void WorldObject::SendPlaySound(uint32 Sound, bool OnlySelf)
 
 void Object::ForceValuesUpdateAtIndex(uint32 i)
 {
-    m_uint32Values_mirror[i] = ~GetUInt32Value(i); // makes server think the field changed
-    if (m_inWorld)
-    {
-        if (!m_objectUpdated)
-        {
-            AddToClientUpdateList();
-            m_objectUpdated = true;
-        }
-    }
+    MarkValueChanged(i);                                    // makes server think the field changed
 }
 
 void WorldObject::MonsterSay(int32 textId, uint32 language, uint64 TargetGuid)
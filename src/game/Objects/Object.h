@@ -25,6 +25,7 @@
 #include "ByteBuffer.h"
 #include "UpdateFields.h"
 #include "UpdateData.h"
+#include "UpdateMask.h"
 #include "Camera.h"
 #include "ObjectGuid.h"
 #include "GridDefines.h"
@@ -57,6 +58,14 @@ enum TemporarySummonType
 };
 #define MAX_TYPEID         10
 
+// `data` columns of characters and item_instance: header (magic, version,
+// uint16 field count) followed by one little-endian uint32 per update field.
+// Text rows ("1 0 25 ...") from before are still read and get rewritten as
+// blob on next save
+#define VALUES_BLOB_MAGIC           0xFF
+#define VALUES_BLOB_VERSION         1
+#define VALUES_BLOB_HEADER_SIZE     4
+
 enum ActiveObject
 {
     ACTIVE_BY_NONE                  = 0x00,
@@ -75,7 +84,6 @@ class Creature;
 class Player;
 class Totem;
 class Pet;
-class UpdateMask;
 class InstanceData;
 class GameObject;
 class CreatureAI;
@@ -176,7 +184,7 @@ class Object
 
             m_inWorld = true;
 
-            // synchronize values mirror with values array (changes will send in updatecreate opcode any way
+            // forget changes made so far (they will be sent in updatecreate opcode any way)
             ClearUpdateMask(false);
         }
         virtual void RemoveFromWorld()
@@ -244,6 +252,11 @@ class Object
         }
 
         std::string GetUInt32ValuesString() const;
+        std::string GetUInt32ValuesBlob() const { return EncodeValues(m_uint32Values, m_valuesCount); }
+
+        // values must hold count fields, false when data has different number of fields
+        static bool DecodeValues(const char* data, uint32 length, uint32* values, uint32 count);
+        static std::string EncodeValues(uint32 const* values, uint32 count);
 
         inline const uint64& GetUInt64Value(uint16 index) const
         {
@@ -368,7 +381,7 @@ class Object
 
         void ClearUpdateMask(bool remove);
 
-        bool LoadValues(const char* data);
+        bool LoadValues(const char* data, uint32 length);
 
         uint16 GetValuesCount() const { return m_valuesCount; }
 
@@ -398,6 +411,18 @@ class Object
         void BuildMovementUpdate(ByteBuffer * data, uint8 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer *data, UpdateMask *updateMask, Player *target) const;
 
+        // remember the changed field and queue object for next client update
+        void MarkValueChanged(uint16 index)
+        {
+            m_changedValues.SetBit(index);
+
+            if (m_inWorld && !m_objectUpdated)
+            {
+                AddToClientUpdateList();
+                m_objectUpdated = true;
+            }
+        }
+
         uint16 m_objectType;
 
         uint8 m_objectTypeId;
@@ -410,7 +435,8 @@ class Object
             float  *m_floatValues;
         };
 
-        uint32 *m_uint32Values_mirror;
+        // fields changed since last client update
+        UpdateMask m_changedValues;
 
         uint16 m_valuesCount;
 
@@ -22,6 +22,7 @@
 #include "Language.h"
 #include "Database/DatabaseEnv.h"
 #include "Log.h"
+#include "Profiler.h"
 #include "Opcodes.h"
 #include "SpellMgr.h"
 #include "World.h"
@@ -1333,6 +1334,7 @@ void Player::Update(uint32 update_diff, uint32 p_time)
     // do not allow the AI to be changed during update
     if (IsAIEnabled)
     {
+        ProfileSumZone zone("Player UpdateAI");
         m_AI_locked = true;
         i_AI->UpdateAI(update_diff);
         m_AI_locked = false;
@@ -1707,7 +1709,8 @@ bool Player::BuildEnumData(QueryResultAutoPtr result, WorldPacket * p_data)
         *p_data << uint32(petLevel);
         *p_data << uint32(petFamily);
     }
-    Tokens data = StrSplit(fields[19].GetCppString(), " ");
+    PlayerValuesArray data;
+    LoadValuesArray(fields[19], data);
     for (uint8 slot = 0; slot < EQUIPMENT_SLOT_END; ++slot)
     {
         uint32 visualbase = PLAYER_VISIBLE_ITEM_1_0 + (slot * MAX_VISIBLE_ITEM_OFFSET);
@@ -1784,8 +1787,35 @@ uint8 Player::chatTag() const
         return 0;
 }
 
+// teleport requested from outside of decoupled instance, done in its update
+class PlayerTeleportCommand : public MapCommand
+{
+    public:
+        PlayerTeleportCommand(uint64 guid, uint32 mapid, float x, float y, float z, float orientation, uint32 options)
+            : m_guid(guid), m_mapId(mapid), m_x(x), m_y(y), m_z(z), m_orientation(orientation), m_options(options) {}
+
+        void Execute(Map& map)
+        {
+            Player* player = ObjectAccessor::GetPlayer(m_guid);
+            if (player && player->IsInWorld() && player->GetMap() == &map)
+                player->TeleportTo(m_mapId, m_x, m_y, m_z, m_orientation, m_options);
+        }
+
+    private:
+        uint64 m_guid;
+        uint32 m_mapId;
+        float m_x, m_y, m_z, m_orientation;
+        uint32 m_options;
+};
+
 bool Player::TeleportTo(uint32 mapid, float x, float y, float z, float orientation, uint32 options)
 {
+    if (IsInWorld() && GetMap()->IsDecoupled() && !GetMap()->IsUpdateThread())
+    {
+        GetMap()->QueueCommand(new PlayerTeleportCommand(GetGUID(), mapid, x, y, z, orientation, options));
+        return true;
+    }
+
     if (!MapManager::IsValidMapCoord(mapid, x, y, z, orientation))
     {
         sLog.outLog(LOG_DEFAULT, "ERROR: TeleportTo: invalid map %d or absent instance template.", mapid);
@@ -4251,7 +4281,8 @@ void Player::DeleteFromDB(uint64 playerguid, uint32 accountId, bool updateRealmC
         {
             Field *fields = result->Fetch();
 
-            Tokens data = StrSplit(fields[0].GetCppString(), " ");
+            PlayerValuesArray data;
+            LoadValuesArray(fields[0], data);
             uint32 plLevel = Player::GetUInt32ValueFromArray(data,UNIT_FIELD_LEVEL);
 
             if (plLevel >= sWorld.getConfig(CONFIG_DONT_DELETE_CHARS_LVL))
@@ -4842,6 +4873,12 @@ void Player::CleanupChannels()
     sLog.outDebug("Player: channels cleaned up!");
 }
 
+void Player::ChannelIgnoreChanged(uint32 ignored, bool ignore)
+{
+    for (JoinedChannelsList::iterator itr = m_channels.begin(); itr != m_channels.end(); ++itr)
+        (*itr)->SetIgnore(GetGUID(), ignored, ignore);
+}
+
 void Player::UpdateLocalChannels(uint32 newZone)
 {
     if (m_channels.empty())
@@ -14470,7 +14507,7 @@ bool Player::MinimalLoadFromDB(QueryResultAutoPtr result, uint32 guid)
 
     Field *fields = result->Fetch();
 
-    if (!LoadValues(fields[1].GetString()))
+    if (!LoadValues(fields[1].GetString(), fields[1].GetLength()))
     {
         sLog.outLog(LOG_DEFAULT, "ERROR: Player #%d have broken data in data field. Can't be loaded for character list.",GUID_LOPART(guid));
         return false;
@@ -14570,7 +14607,7 @@ bool Player::LoadPositionFromDB(uint32& mapid, float& x,float& y,float& z,float&
     return true;
 }
 
-bool Player::LoadValuesArrayFromDB(Tokens& data, uint64 guid)
+bool Player::LoadValuesArrayFromDB(PlayerValuesArray& data, uint64 guid)
 {
     QueryResultAutoPtr result = RealmDataDatabase.PQuery("SELECT data FROM characters WHERE guid='%u'",GUID_LOPART(guid));
     if (!result)
@@ -14578,20 +14615,29 @@ bool Player::LoadValuesArrayFromDB(Tokens& data, uint64 guid)
 
     Field *fields = result->Fetch();
 
-    data = StrSplit(fields[0].GetCppString(), " ");
+    return LoadValuesArray(fields[0], data);
+}
 
-    return true;
+bool Player::LoadValuesArray(Field const& field, PlayerValuesArray& data)
+{
+    data.resize(PLAYER_END);
+    if (DecodeValues(field.GetString(), field.GetLength(), &data[0], PLAYER_END))
+        return true;
+
+    // broken data, every value reads as 0
+    data.clear();
+    return false;
 }
 
-uint32 Player::GetUInt32ValueFromArray(Tokens const& data, uint16 index)
+uint32 Player::GetUInt32ValueFromArray(PlayerValuesArray const& data, uint16 index)
 {
     if (index >= data.size())
         return 0;
 
-    return (uint32)atoi(data[index].c_str());
+    return data[index];
 }
 
-float Player::GetFloatValueFromArray(Tokens const& data, uint16 index)
+float Player::GetFloatValueFromArray(PlayerValuesArray const& data, uint16 index)
 {
     float result;
     uint32 temp = Player::GetUInt32ValueFromArray(data,index);
@@ -14602,7 +14648,7 @@ float Player::GetFloatValueFromArray(Tokens const& data, uint16 index)
 
 uint32 Player::GetUInt32ValueFromDB(uint16 index, uint64 guid)
 {
-    Tokens data;
+    PlayerValuesArray data;
     if (!LoadValuesArrayFromDB(data,guid))
         return 0;
 
@@ -14651,7 +14697,7 @@ bool Player::LoadFromDB(uint32 guid, SqlQueryHolder *holder)
         return false;
     }
 
-    if (!LoadValues(fields[2].GetString()))
+    if (!LoadValues(fields[2].GetString(), fields[2].GetLength()))
     {
         sLog.outLog(LOG_DEFAULT, "ERROR: Player #%d have broken data in `data` field. Can't be loaded.",GUID_LOPART(guid));
         return false;
@@ -16455,11 +16501,9 @@ void Player::SaveToDB()
         stmt.addFloat(finiteAlways(GetTeleportDest().orientation));", '";
     }
 
-    std::string tmpStr = GetUInt32ValuesString();
+    stmt.addBinary(GetUInt32ValuesBlob());
 
-    stmt.addString(tmpStr);
-
-    tmpStr = m_taxi.GetTaxiMaskString();
+    std::string tmpStr = m_taxi.GetTaxiMaskString();
     stmt.addString(tmpStr);
     stmt.addBool(inworld ? true : false);
     stmt.addBool(m_cinematic);
@@ -16544,45 +16588,24 @@ void Player::SaveGoldToDB()
 
 void Player::_SaveActions()
 {
-    static SqlStatementID insertCharacterAction;
-    static SqlStatementID updateCharacterAction;
     static SqlStatementID deleteCharacterAction;
 
+    // REPLACE also covers rows left behind with the same key ('primary-key already exists' errors)
+    SqlInsertBatch batch(RealmDataDatabase, "REPLACE INTO character_action (guid, button, action, type, misc) VALUES ");
+
     for (ActionButtonList::iterator itr = m_actionButtons.begin(); itr != m_actionButtons.end();)
     {
         switch (itr->second.uState)
         {
             case ACTIONBUTTON_NEW:
-            {
-                //for 'primary-key already exists' errors, they find a way.. :P
-                {
-                    SqlStatement stmt = RealmDataDatabase.CreateStatement(deleteCharacterAction, "DELETE FROM character_action where guid= ? AND button= ? ");
-                    stmt.addUInt32(GetGUIDLow());
-                    stmt.addUInt32(uint32(itr->first));
-                    stmt.Execute();
-                }
-
-                SqlStatement stmt = RealmDataDatabase.CreateStatement(insertCharacterAction, "INSERT INTO character_action (guid, button, action, type, misc) VALUES (?, ?, ?, ?, ?)");
-                stmt.addUInt32(GetGUIDLow());
-                stmt.addUInt32(uint32(itr->first));
-                stmt.addUInt32(uint32(itr->second.action));
-                stmt.addUInt32(uint32(itr->second.type));
-                stmt.addUInt32(uint32(itr->second.misc));
-                stmt.Execute();
-
-                itr->second.uState = ACTIONBUTTON_UNCHANGED;
-                ++itr;
-                break;
-            }
             case ACTIONBUTTON_CHANGED:
             {
-                SqlStatement stmt = RealmDataDatabase.CreateStatement(updateCharacterAction, "UPDATE character_action  SET action = ?, type = ?, misc = ? WHERE guid = ? AND button = ?");
-                stmt.addUInt32(uint32(itr->second.action));
-                stmt.addUInt32(uint32(itr->second.type));
-                stmt.addUInt32(uint32(itr->second.misc));
-                stmt.addUInt32(GetGUIDLow());
-                stmt.addUInt32(uint32(itr->first));
-                stmt.Execute();
+                batch.NewRow();
+                batch.addUInt32(GetGUIDLow());
+                batch.addUInt32(uint32(itr->first));
+                batch.addUInt32(uint32(itr->second.action));
+                batch.addUInt32(uint32(itr->second.type));
+                batch.addUInt32(uint32(itr->second.misc));
 
                 itr->second.uState = ACTIONBUTTON_UNCHANGED;
                 ++itr;
@@ -16606,7 +16629,6 @@ void Player::_SaveActions()
 void Player::_SaveAuras()
 {
     static SqlStatementID deleteAuras;
-    static SqlStatementID insertAura;
 
     SqlStatement stmt = RealmDataDatabase.CreateStatement(deleteAuras, "DELETE FROM character_aura WHERE guid = ?");
     stmt.PExecute(GetGUIDLow());
@@ -16616,6 +16638,8 @@ void Player::_SaveAuras()
     if (auras.empty())
         return;
 
+    SqlInsertBatch batch(RealmDataDatabase, "INSERT INTO character_aura (guid, caster_guid, spell, effect_index, stackcount, amount, maxduration, remaintime, remaincharges) VALUES ");
+
     spellEffectPair lastEffectPair = auras.begin()->first;
     uint32 stackCounter = 1;
 
@@ -16643,18 +16667,16 @@ void Player::_SaveAuras()
 
                     if (i == 3)
                     {
-                        stmt = RealmDataDatabase.CreateStatement(insertAura, "INSERT INTO character_aura (guid, caster_guid, spell, effect_index, stackcount, amount, maxduration, remaintime, remaincharges) "
-                                                                    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)");
-                        stmt.addUInt32(GetGUIDLow());
-                        stmt.addUInt64(itr2->second->GetCasterGUID());
-                        stmt.addUInt32(uint32(itr2->second->GetId()));
-                        stmt.addUInt32(uint32(itr2->second->GetEffIndex()));
-                        stmt.addUInt32(uint32(itr2->second->GetStackAmount()));
-                        stmt.addInt32(itr2->second->GetModifier()->m_amount);
-                        stmt.addInt32(itr2->second->GetAuraMaxDuration());
-                        stmt.addInt32(itr2->second->GetAuraDuration());
-                        stmt.addInt32(itr2->second->m_procCharges);
-                        stmt.Execute();
+                        batch.NewRow();
+                        batch.addUInt32(GetGUIDLow());
+                        batch.addUInt64(itr2->second->GetCasterGUID());
+                        batch.addUInt32(uint32(itr2->second->GetId()));
+                        batch.addUInt32(uint32(itr2->second->GetEffIndex()));
+                        batch.addUInt32(uint32(itr2->second->GetStackAmount()));
+                        batch.addInt32(itr2->second->GetModifier()->m_amount);
+                        batch.addInt32(itr2->second->GetAuraMaxDuration());
+                        batch.addInt32(itr2->second->GetAuraDuration());
+                        batch.addInt32(itr2->second->m_procCharges);
                     }
                 }
             }
@@ -16705,8 +16727,6 @@ void Player::_SaveInventory()
     static SqlStatementID deleteItemInstance;
     static SqlStatementID deleteCharInvByPlace;
     static SqlStatementID insertBan;
-    static SqlStatementID insertCharInv;
-    static SqlStatementID updateCharInv;
 
     // force items in buyback slots to new state
     // and remove those that aren't already
@@ -16733,6 +16753,9 @@ void Player::_SaveInventory()
     if (m_itemUpdateQueue.empty())
         return;
 
+    // new and moved items, keyed by item guid
+    SqlInsertBatch batch(RealmDataDatabase, "REPLACE INTO character_inventory (guid, bag, slot, item, item_template) VALUES ");
+
     // do not save if the update queue is corrupt
     uint32 lowGuid = GetGUIDLow();
     for (size_t i = 0; i < m_itemUpdateQueue.size(); ++i)
@@ -16757,6 +16780,8 @@ void Player::_SaveInventory()
                 sLog.outLog(LOG_DEFAULT, "ERROR: Player(GUID: %u Name: %s)::_SaveInventory - the bag(%u) and slot(%u) values for the item with guid %u (state %d) are incorrect, the player doesn't have an item at that position!", lowGuid, GetName(), item->GetBagSlot(), item->GetSlot(), item->GetGUIDLow(), (int32)item->GetState());
 
                 // according to the test that was just performed nothing should be in this slot, delete
+                // rows queued so far must land before it, as they did when saved one by one
+                batch.Flush();
                 SqlStatement stmt = RealmDataDatabase.CreateStatement(deleteCharInvByPlace, "DELETE FROM character_inventory WHERE bag = ? AND slot = ?");
                 stmt.PExecute(bagTestGUID, item->GetSlot());
 
@@ -16798,25 +16823,14 @@ void Player::_SaveInventory()
         switch (item->GetState())
         {
             case ITEM_NEW:
-            {
-                SqlStatement stmt = RealmDataDatabase.CreateStatement(insertCharInv, "INSERT INTO character_inventory (guid, bag, slot, item, item_template) VALUES (?, ?, ?, ?, ?)");
-                stmt.addUInt32(lowGuid);
-                stmt.addUInt32(bag_guid);
-                stmt.addUInt32(item->GetSlot());
-                stmt.addUInt32(item->GetGUIDLow());
-                stmt.addUInt32(item->GetEntry());
-                stmt.Execute();
-                break;
-            }
             case ITEM_CHANGED:
             {
-                SqlStatement stmt = RealmDataDatabase.CreateStatement(updateCharInv, "UPDATE character_inventory SET guid = ?, bag = ?, slot = ?, item_template = ? WHERE item = ?");
-                stmt.addUInt32(lowGuid);
-                stmt.addUInt32(bag_guid);
-                stmt.addUInt32(item->GetSlot());
-                stmt.addUInt32(item->GetEntry());
-                stmt.addUInt32(item->GetGUIDLow());
-                stmt.Execute();
+                batch.NewRow();
+                batch.addUInt32(lowGuid);
+                batch.addUInt32(bag_guid);
+                batch.addUInt32(item->GetSlot());
+                batch.addUInt32(item->GetGUIDLow());
+                batch.addUInt32(item->GetEntry());
                 break;
             }
             case ITEM_REMOVED:
@@ -16914,55 +16928,31 @@ void Player::_SaveMail()
 
 void Player::_SaveQuestStatus()
 {
-    static SqlStatementID insertQuestStatus;
-    static SqlStatementID updateQuestStatus;
+    // rows are written whole, so new and changed quests share one REPLACE
+    SqlInsertBatch batch(RealmDataDatabase, "REPLACE INTO character_queststatus (guid, quest, status, rewarded, explored, timer, mobcount1, mobcount2, mobcount3, mobcount4, itemcount1, itemcount2, itemcount3, itemcount4) VALUES ");
 
     for (QuestStatusMap::iterator i = mQuestStatus.begin(); i != mQuestStatus.end(); ++i)
     {
         switch (i->second.uState)
         {
             case QUEST_NEW:
-            {
-                SqlStatement stmt = RealmDataDatabase.CreateStatement(insertQuestStatus, "INSERT INTO character_queststatus (guid, quest, status, rewarded, explored, timer, mobcount1, mobcount2, mobcount3, mobcount4, itemcount1, itemcount2, itemcount3, itemcount4) "
-                    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
-
-                stmt.addUInt32(GetGUIDLow());
-                stmt.addUInt32(i->first);
-                stmt.addUInt8(i->second.m_status);
-                stmt.addBool(i->second.m_rewarded);
-                stmt.addBool(i->second.m_explored);
-                stmt.addUInt64(uint64(i->second.m_timer / 1000 + sWorld.GetGameTime()));
-                stmt.addUInt32(i->second.m_creatureOrGOcount[0]);
-                stmt.addUInt32(i->second.m_creatureOrGOcount[1]);
-                stmt.addUInt32(i->second.m_creatureOrGOcount[2]);
-                stmt.addUInt32(i->second.m_creatureOrGOcount[3]);
-                stmt.addUInt32(i->second.m_itemcount[0]);
-                stmt.addUInt32(i->second.m_itemcount[1]);
-                stmt.addUInt32(i->second.m_itemcount[2]);
-                stmt.addUInt32(i->second.m_itemcount[3]);
-                stmt.Execute();
-
-                break;
-            }
             case QUEST_CHANGED:
             {
-                SqlStatement stmt = RealmDataDatabase.CreateStatement(updateQuestStatus, "UPDATE character_queststatus SET status = ?, rewarded = ?, explored = ?, timer = ?, mobcount1 = ?, mobcount2 = ?, mobcount3 = ?, mobcount4 = ?, itemcount1 = ?, itemcount2 = ?, itemcount3 = ?, itemcount4 = ? WHERE guid = ? AND quest = ?");
-                stmt.addUInt8(i->second.m_status);
-                stmt.addBool(i->second.m_rewarded);
-                stmt.addBool(i->second.m_explored);
-                stmt.addUInt64(uint64(i->second.m_timer / 1000 + sWorld.GetGameTime()));
-                stmt.addUInt32(i->second.m_creatureOrGOcount[0]);
-                stmt.addUInt32(i->second.m_creatureOrGOcount[1]);
-                stmt.addUInt32(i->second.m_creatureOrGOcount[2]);
-                stmt.addUInt32(i->second.m_creatureOrGOcount[3]);
-                stmt.addUInt32(i->second.m_itemcount[0]);
-                stmt.addUInt32(i->second.m_itemcount[1]);
-                stmt.addUInt32(i->second.m_itemcount[2]);
-                stmt.addUInt32(i->second.m_itemcount[3]);
-                stmt.addUInt32(GetGUIDLow());
-                stmt.addUInt32(i->first);
-                stmt.Execute();
-
+                batch.NewRow();
+                batch.addUInt32(GetGUIDLow());
+                batch.addUInt32(i->first);
+                batch.addUInt8(i->second.m_status);
+                batch.addBool(i->second.m_rewarded);
+                batch.addBool(i->second.m_explored);
+                batch.addUInt64(uint64(i->second.m_timer / 1000 + sWorld.GetGameTime()));
+                batch.addUInt32(i->second.m_creatureOrGOcount[0]);
+                batch.addUInt32(i->second.m_creatureOrGOcount[1]);
+                batch.addUInt32(i->second.m_creatureOrGOcount[2]);
+                batch.addUInt32(i->second.m_creatureOrGOcount[3]);
+                batch.addUInt32(i->second.m_itemcount[0]);
+                batch.addUInt32(i->second.m_itemcount[1]);
+                batch.addUInt32(i->second.m_itemcount[2]);
+                batch.addUInt32(i->second.m_itemcount[3]);
                 break;
             }
             case QUEST_UNCHANGED:
@@ -17004,13 +16994,16 @@ void Player::_SaveDailyQuestStatus()
 void Player::_SaveSpells()
 {
     static SqlStatementID deleteSpell;
-    static SqlStatementID insertSpell;
+
+    //in some way we have primary-key insert errors, due to what characters are not saved (!!!)
+    //REPLACE drops such rows the same way the delete before each insert did
+    SqlInsertBatch batch(RealmDataDatabase, "REPLACE INTO character_spell (guid, spell, slot, active, disabled) VALUES ");
 
     for (PlayerSpellMap::iterator itr = m_spells.begin(), next = m_spells.begin(); itr != m_spells.end(); itr = next)
     {
         ++next;
 
-        if (itr->second.state == PLAYERSPELL_REMOVED || itr->second.state == PLAYERSPELL_CHANGED)
+        if (itr->second.state == PLAYERSPELL_REMOVED)
         {
             SqlStatement stmt = RealmDataDatabase.CreateStatement(deleteSpell, "DELETE FROM character_spell WHERE guid = ? and spell = ?");
             stmt.PExecute(GetGUIDLow(), itr->first);
@@ -17018,19 +17011,12 @@ void Player::_SaveSpells()
 
         if (itr->second.state == PLAYERSPELL_NEW || itr->second.state == PLAYERSPELL_CHANGED)
         {
-            {
-                //in some way we have primary-key insert errors, due to what characters are not saved (!!!)
-                SqlStatement stmt = RealmDataDatabase.CreateStatement(deleteSpell, "DELETE FROM character_spell WHERE guid = ? and spell = ?");
-                stmt.PExecute(GetGUIDLow(), itr->first);
-            }
-
-            SqlStatement stmt = RealmDataDatabase.CreateStatement(insertSpell, "INSERT INTO character_spell (guid, spell, slot, active, disabled) VALUES (?, ?, ?, ?, ?)");
-            stmt.addUInt32(GetGUIDLow());
-            stmt.addUInt32(itr->first);
-            stmt.addUInt32(itr->second.slotId);
-            stmt.addBool(itr->second.active);
-            stmt.addBool(itr->second.disabled);
-            stmt.Execute();
+            batch.NewRow();
+            batch.addUInt32(GetGUIDLow());
+            batch.addUInt32(itr->first);
+            batch.addUInt32(itr->second.slotId);
+            batch.addBool(itr->second.active);
+            batch.addBool(itr->second.disabled);
         }
 
         if (itr->second.state == PLAYERSPELL_REMOVED)
@@ -17184,52 +17170,45 @@ void Player::SaveDataFieldToDB()
 {
     static SqlStatementID updateCharData;
     SqlStatement stmt = RealmDataDatabase.CreateStatement(updateCharData, "UPDATE characters SET data = ?  WHERE guid = ?");
-    stmt.addString(GetUInt32ValuesString());
+    stmt.addBinary(GetUInt32ValuesBlob());
     stmt.addUInt32(GetGUIDLow());
     stmt.Execute();
 }
 
-bool Player::SaveValuesArrayInDB(Tokens const& tokens, uint64 guid)
+bool Player::SaveValuesArrayInDB(PlayerValuesArray const& data, uint64 guid)
 {
     static SqlStatementID updateCharData;
 
-    int cnt = tokens.size();
-    std::ostringstream ss;
-    for (int i = 0; i < cnt; ++i)
-        ss << tokens[i] << " ";
+    if (data.empty())
+        return false;
 
     SqlStatement stmt = RealmDataDatabase.CreateStatement(updateCharData, "UPDATE characters SET data = ?  WHERE guid = ?");
-    stmt.addString(ss);
+    stmt.addBinary(EncodeValues(&data[0], data.size()));
     stmt.addUInt32(GUID_LOPART(guid));
 
     return stmt.Execute();
 }
 
-void Player::SetUInt32ValueInArray(Tokens& tokens,uint16 index, uint32 value)
+void Player::SetUInt32ValueInArray(PlayerValuesArray& data,uint16 index, uint32 value)
 {
-    char buf[11];
-    snprintf(buf,11,"%u",value);
-
-    if (index >= tokens.size())
+    if (index >= data.size())
         return;
 
-    tokens[index] = buf;
+    data[index] = value;
 }
 
 void Player::SetUInt32ValueInDB(uint16 index, uint32 value, uint64 guid)
 {
-    Tokens tokens;
-    if (!LoadValuesArrayFromDB(tokens,guid))
+    PlayerValuesArray data;
+    if (!LoadValuesArrayFromDB(data,guid))
         return;
 
-    if (index >= tokens.size())
+    if (index >= data.size())
         return;
 
-    char buf[11];
-    snprintf(buf,11,"%u",value);
-    tokens[index] = buf;
+    data[index] = value;
 
-    SaveValuesArrayInDB(tokens,guid);
+    SaveValuesArrayInDB(data,guid);
 }
 
 void Player::SetFloatValueInDB(uint16 index, float value, uint64 guid)
@@ -59,6 +59,9 @@ struct PlayerAI;
 
 typedef std::deque<Mail*> PlayerMails;
 
+// update fields of offline character, decoded `characters`.`data`
+typedef std::vector<uint32> PlayerValuesArray;
+
 #define PLAYER_MAX_SKILLS       127
 
 enum AnticheatChecks
@@ -1369,9 +1372,10 @@ class Player : public Unit
 
         bool LoadFromDB(uint32 guid, SqlQueryHolder *holder);
         bool MinimalLoadFromDB(QueryResultAutoPtr result, uint32 guid);
-        static bool   LoadValuesArrayFromDB(Tokens& data,uint64 guid);
-        static uint32 GetUInt32ValueFromArray(Tokens const& data, uint16 index);
-        static float  GetFloatValueFromArray(Tokens const& data, uint16 index);
+        static bool   LoadValuesArrayFromDB(PlayerValuesArray& data,uint64 guid);
+        static bool   LoadValuesArray(Field const& field, PlayerValuesArray& data);
+        static uint32 GetUInt32ValueFromArray(PlayerValuesArray const& data, uint16 index);
+        static float  GetFloatValueFromArray(PlayerValuesArray const& data, uint16 index);
         static uint32 GetUInt32ValueFromDB(uint16 index, uint64 guid);
         static float  GetFloatValueFromDB(uint16 index, uint64 guid);
         static uint32 GetZoneIdFromDB(uint64 guid);
@@ -1386,9 +1390,9 @@ class Player : public Unit
         void SaveInventoryAndGoldToDB();                    // fast save function for item/money cheating preventing
         void SaveGoldToDB();
         void SaveDataFieldToDB();
-        static bool SaveValuesArrayInDB(Tokens const& data,uint64 guid);
-        static void SetUInt32ValueInArray(Tokens& data,uint16 index, uint32 value);
-        static void SetFloatValueInArray(Tokens& data,uint16 index, float value);
+        static bool SaveValuesArrayInDB(PlayerValuesArray const& data,uint64 guid);
+        static void SetUInt32ValueInArray(PlayerValuesArray& data,uint16 index, uint32 value);
+        static void SetFloatValueInArray(PlayerValuesArray& data,uint16 index, float value);
         static void SetUInt32ValueInDB(uint16 index, uint32 value, uint64 guid);
         static void SetFloatValueInDB(uint16 index, float value, uint64 guid);
         static void SavePositionInDB(uint32 mapid, float x,float y,float z,float o,uint32 zone,uint64 guid);
@@ -1773,6 +1777,8 @@ class Player : public Unit
         void JoinedChannel(Channel *c);
         void LeftChannel(Channel *c);
         void CleanupChannels();
+        // keeps ignore exclusions of joined channels in sync with social list
+        void ChannelIgnoreChanged(uint32 ignored, bool ignore);
         void UpdateLocalChannels(uint32 newZone);
         void LeaveLFGChannel();
         void JoinLFGChannel();
@@ -2237,6 +2243,8 @@ class Player : public Unit
         /*********************************************************/
 
         Group * GetGroupInvite() { return m_groupInvite; }
+        // on decoupled instance that is still updating, world thread must not touch the player
+        bool IsInDecoupledUpdate() const { return IsInWorld() && GetMap()->IsDecoupledUpdating(); }
         void SetGroupInvite(Group *group) { m_groupInvite = group; }
         Group * GetGroup() { return m_group.getTarget(); }
         const Group * GetGroup() const { return (const Group*)m_group.getTarget(); }
@@ -20,6 +20,7 @@
 
 #include "Common.h"
 #include "Log.h"
+#include "Profiler.h"
 #include "Opcodes.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
@@ -262,7 +263,7 @@ Unit::Unit() :
     WorldObject(), i_motionMaster(this), movespline(new Movement::MoveSpline()),
     _threatManager(this), _hostileRefManager(this), m_stateMgr(this),
     IsAIEnabled(false), NeedChangeAI(false), i_AI(NULL), i_disabledAI(NULL),
-    m_procDeep(0), m_AI_locked(false), m_removedAurasCount(0)
+    m_procDeep(0), m_AI_locked(false), m_removedAurasCount(0), m_auraClock(0), m_tickingAurasNext(NULL)
 {
     m_modAuras = new AuraList[TOTAL_AURAS];
     m_objectType |= TYPEMASK_UNIT;
@@ -295,7 +296,6 @@ Unit::Unit() :
 
     m_ObjectSlot[0] = m_ObjectSlot[1] = m_ObjectSlot[2] = m_ObjectSlot[3] = 0;
 
-    m_AurasUpdateIterator = m_Auras.end();
     m_Visibility = VISIBILITY_ON;
 
     m_interruptMask = 0;
@@ -363,6 +363,7 @@ Unit::Unit() :
     m_CombatStatsFlag = 0;
 
     _AINotifyScheduled = false;
+    _AINotifyIndex = AI_NOTIFY_NOT_QUEUED;
 
     WorthHonor = false;
 }
@@ -425,6 +426,7 @@ void Unit::Update(uint32 update_diff, uint32 /*p_time*/)
     // WARNING! Order of execution here is important, do not change.
     // Spells must be processed with event system BEFORE they go to _UpdateSpells.
     // Or else we may have some SPELL_STATE_FINISHED spells stalled in pointers, that is bad.
+    ProfileSumZone zone("Unit::Update");
     uint32 startTime = WorldTimer::getMSTime();
     uint32 count = GetEvents()->Update(update_diff);
     
@@ -3350,31 +3352,56 @@ void Unit::_UpdateSpells(uint32 time)
         }
     }
 
-    // m_AurasUpdateIterator can be updated in inderect called code at aura remove to skip next planned to update but removed auras
-    AuraMap::iterator eraseIter;
-    for (m_AurasUpdateIterator = m_Auras.begin(); m_AurasUpdateIterator != m_Auras.end();)
+    ProfileSumZone zone("Unit::_UpdateSpells");
+    uint32 touched = 0;
+
+    m_auraClock += time;
+
+    // m_tickingAurasNext can be updated in inderect called code at aura remove to skip next planned to update but removed auras
+    for (AuraTimerNode* node = m_tickingAuras.front(); node != m_tickingAuras.end(); node = m_tickingAurasNext)
     {
-        Aura* i_aura = m_AurasUpdateIterator->second;
-        eraseIter = m_AurasUpdateIterator;
-        ++m_AurasUpdateIterator;                            // need shift to next for allow update if need into aura update
+        m_tickingAurasNext = node->next;                    // need shift to next for allow update if need into aura update
+        node->aura->Update(time);
+        ++touched;
+    }
 
-        if (i_aura)
-            i_aura->Update(time);
-        else
-            m_Auras.erase(eraseIter);
+    // timed auras whose periodic tick or expiry came, their timers are brought up to our clock first
+    // the wheel may wake them early when we were not updated for a while (inactive grid), nothing happens then
+    AuraTimerList processed;
+    while (!m_dueAuras.empty())
+    {
+        AuraTimerNode* node = m_dueAuras.front();
+        processed.push_back(node, AURA_TIMER_PROCESSING);
+        node->aura->SyncTimers();
+        node->aura->Update(0);
+        ++touched;
     }
 
     // remove expired auras
-    for (AuraMap::iterator i = m_Auras.begin(); i != m_Auras.end();)
+    for (AuraTimerNode* node = m_tickingAuras.front(); node != m_tickingAuras.end(); node = m_tickingAurasNext)
     {
-        if (i->second->IsExpired())
-            RemoveAura(i, AURA_REMOVE_BY_EXPIRE);
-        else
-             ++i;
+        m_tickingAurasNext = node->next;
+        if (node->aura->IsExpired())
+            _RemoveExpiredAura(node->aura);
+    }
+    m_tickingAurasNext = NULL;
+
+    while (!processed.empty())
+    {
+        Aura* aura = processed.front()->aura;
+        aura->GetTimerNode().Unlink();
+
+        if (aura->IsExpired())
+            _RemoveExpiredAura(aura);
+
+        // no-op if removed, back to wheel otherwise
+        aura->Reschedule();
     }
 
     _DeleteAuras();
 
+    GetMap()->GetAuraTimerWheel().RecordUpdate(m_Auras.size(), touched);
+
     if (!m_gameObj.empty())
     {
         std::list<GameObject*>::iterator itr;
@@ -3393,6 +3420,27 @@ void Unit::_UpdateSpells(uint32 time)
     }
 }
 
+void Unit::_RegisterAuraTimer(Aura* aura)
+{
+    if (sWorld.getConfig(CONFIG_AURA_TIMER_WHEEL) && aura->CanUseTimerWheel())
+        aura->SetTimed(true);
+    else
+        m_tickingAuras.push_back(&aura->GetTimerNode(), AURA_TIMER_TICKING);
+}
+
+void Unit::_RemoveExpiredAura(Aura* aura)
+{
+    spellEffectPair spair = spellEffectPair(aura->GetId(), aura->GetEffIndex());
+    for (AuraMap::iterator itr = m_Auras.lower_bound(spair); itr != m_Auras.upper_bound(spair); ++itr)
+    {
+        if (itr->second == aura)
+        {
+            RemoveAura(itr, AURA_REMOVE_BY_EXPIRE);
+            return;
+        }
+    }
+}
+
 void Unit::_UpdateAutoRepeatSpell()
 {
     //check "realtime" interrupts
@@ -4041,6 +4089,7 @@ bool Unit::AddAura(Aura *Aur)
     // add aura, register in lists and arrays
     Aur->_AddAura();
     m_Auras.insert(AuraMap::value_type(spellEffectPair(Aur->GetId(), Aur->GetEffIndex()), Aur));
+    _RegisterAuraTimer(Aur);
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
         m_modAuras[Aur->GetModifier()->m_auraname].push_back(Aur);
@@ -4681,8 +4730,12 @@ void Unit::RemoveAura(AuraMap::iterator &i, AuraRemoveMode mode)
         ((Creature *)this)->AI()->OnAuraRemove(Aur, false);
 
     // if unit currently update aura list then make safe update iterator shift to next
-    if (m_AurasUpdateIterator == i)
-        ++m_AurasUpdateIterator;
+    if (m_tickingAurasNext == &Aur->GetTimerNode())
+        m_tickingAurasNext = m_tickingAurasNext->next;
+
+    // timers are kept as they are now, nothing wakes or updates the aura anymore
+    Aur->SetTimed(false);
+    Aur->GetTimerNode().Unlink();
 
     // some ShapeshiftBoosts at remove trigger removing other auras including parent Shapeshift aura
     // remove aura from list before to prevent deleting it before
@@ -11153,7 +11206,13 @@ uint32 Unit::GetCreatePowers(Powers power) const
 void Unit::AddToWorld()
 {
     if (!IsInWorld())
+    {
         WorldObject::AddToWorld();
+
+        // timed auras wait in wheel of the map we are in now
+        for (AuraMap::iterator itr = m_Auras.begin(); itr != m_Auras.end(); ++itr)
+            itr->second->Reschedule();
+    }
 }
 
 void Unit::setHover(bool val)
@@ -11181,6 +11240,12 @@ void Unit::RemoveFromWorld()
         RemoveNotOwnSingleTargetAuras();
         GetViewPoint().Event_RemovedFromWorld();
 
+        for (AuraMap::iterator itr = m_Auras.begin(); itr != m_Auras.end(); ++itr)
+            if (itr->second->IsTimed())
+                itr->second->GetTimerNode().Unlink();
+
+        GetMap()->GetRelocationNotifyPass().Remove(this);
+
         WorldObject::RemoveFromWorld();
     }
 }
@@ -12503,10 +12568,10 @@ bool Unit::preventApplyPersistentAA(SpellEntry const *spellInfo, uint8 eff_index
     return false;
 }
 
-class RelocationNotifyEvent : public BasicEvent
+class RelocationNotifyEvent : public PooledEvent<RelocationNotifyEvent>
 {
     public:
-        RelocationNotifyEvent(Unit& owner) : BasicEvent(), _owner(owner)
+        RelocationNotifyEvent(Unit& owner) : _owner(owner)
         {
             _owner._SetAINotifyScheduled(true);
         }
@@ -12543,7 +12608,12 @@ class RelocationNotifyEvent : public BasicEvent
 
 void Unit::ScheduleAINotify(uint32 delay)
 {
-    if (!IsAINotifyScheduled())
+    if (IsAINotifyScheduled())
+        return;
+
+    if (IsInWorld() && sWorld.getConfig(CONFIG_AI_NOTIFY_BATCHED))
+        GetMap()->GetRelocationNotifyPass().Schedule(this, delay);
+    else
         AddEvent(new RelocationNotifyEvent(*this), delay);
 }
 
@@ -25,6 +25,7 @@
 #include "Object.h"
 #include "Opcodes.h"
 #include "SpellAuraDefines.h"
+#include "AuraTimerWheel.h"
 #include "UpdateFields.h"
 #include "SharedDefines.h"
 #include "ThreatManager.h"
@@ -1420,6 +1421,9 @@ class Unit : public WorldObject
         void ScheduleAINotify(uint32 delay);
         bool IsAINotifyScheduled() const { return _AINotifyScheduled;}
         void _SetAINotifyScheduled(bool on) { _AINotifyScheduled = on;}
+        // position in map's RelocationNotifyPass queue
+        uint32 _GetAINotifyIndex() const { return _AINotifyIndex; }
+        void _SetAINotifyIndex(uint32 index) { _AINotifyIndex = index; }
 
         Position _notifiedPosition;
 
@@ -1427,6 +1431,7 @@ class Unit : public WorldObject
 
     private:
         bool _AINotifyScheduled;
+        uint32 _AINotifyIndex;
 
 #pragma endregion VisibilityRelocation
 
@@ -1452,6 +1457,10 @@ class Unit : public WorldObject
         Aura* GetAura(uint32 spellId, uint32 effindex);
         AuraMap      & GetAuras()       { return m_Auras; }
         AuraMap const& GetAuras() const { return m_Auras; }
+
+        // advances with unit updates only, timed auras count their durations by it
+        uint32 GetAuraClock() const { return m_auraClock; }
+        AuraTimerList& GetDueAuras() { return m_dueAuras; }
         AuraList const& GetAurasByType(AuraType type) const { return m_modAuras[type]; }
         void ApplyAuraProcTriggerDamage(Aura* aura, bool apply);
 
@@ -1658,6 +1667,8 @@ class Unit : public WorldObject
 
         void _UpdateSpells(uint32 time);
         void _DeleteAuras();
+        void _RegisterAuraTimer(Aura* aura);
+        void _RemoveExpiredAura(Aura* aura);
 
         void _UpdateAutoRepeatSpell();
         bool m_AutoRepeatFirstCast;
@@ -1672,9 +1683,13 @@ class Unit : public WorldObject
         DeathState m_deathState;
 
         AuraMap m_Auras;
-        AuraMap::iterator m_AurasUpdateIterator;
         uint32 m_removedAurasCount;
 
+        uint32 m_auraClock;
+        AuraTimerList m_tickingAuras;                       // auras updated every tick
+        AuraTimerList m_dueAuras;                           // timed auras moved here by map's AuraTimerWheel
+        AuraTimerNode* m_tickingAurasNext;                  // next to visit in m_tickingAuras, shifted when removed
+
         typedef std::list<uint64> DynObjectGUIDs;
         DynObjectGUIDs m_dynObjGUIDs;
 
@@ -24,6 +24,11 @@
 #include "UpdateFields.h"
 #include "Log.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// bits are kept in little endian uint32 blocks, the layout sent to the client
 class UpdateMask
 {
     public:
@@ -38,17 +43,35 @@ class UpdateMask
 
         void SetBit (uint32 index)
         {
-            ((uint8 *)mUpdateMask)[ index >> 3 ] |= 1 << (index & 0x7);
+            mUpdateMask[ index >> 5 ] |= 1U << (index & 0x1F);
         }
 
         void UnsetBit (uint32 index)
         {
-            ((uint8 *)mUpdateMask)[ index >> 3 ] &= (0xff ^ (1 <<  (index & 0x7)));
+            mUpdateMask[ index >> 5 ] &= ~(1U << (index & 0x1F));
+        }
+
+        bool GetBit (uint32 index) const
+        {
+            return (mUpdateMask[ index >> 5 ] & (1U << (index & 0x1F))) != 0;
         }
 
-        bool GetBit (uint32 index)
+        // first set bit at or after index, GetCount() if there is none
+        uint32 GetNextBit (uint32 index) const
         {
-            return (((uint8 *)mUpdateMask)[ index >> 3 ] & (1 << (index & 0x7))) != 0;
+            uint32 block = index >> 5;
+            if (block >= mBlocks)
+                return mCount;
+
+            uint32 bits = mUpdateMask[block] & (~0U << (index & 0x1F));
+            while (!bits)
+            {
+                if (++block >= mBlocks)
+                    return mCount;
+                bits = mUpdateMask[block];
+            }
+
+            return (block << 5) + CountTrailingZeros(bits);
         }
 
         uint32 GetBlockCount() { return mBlocks; }
@@ -76,7 +99,12 @@ class UpdateMask
 
         UpdateMask& operator = (const UpdateMask& mask)
         {
-            SetCount(mask.mCount);
+            if (this == &mask)
+                return *this;
+
+            // reuse the buffer, masks are copied for every update receiver
+            if (!mUpdateMask || mCount != mask.mCount)
+                SetCount(mask.mCount);
             memcpy(mUpdateMask, mask.mUpdateMask, mBlocks << 2);
 
             return *this;
@@ -119,6 +147,25 @@ class UpdateMask
         }
 
     private:
+        static uint32 CountTrailingZeros(uint32 bits)
+        {
+#if defined(__GNUC__)
+            return __builtin_ctz(bits);
+#elif defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, bits);
+            return index;
+#else
+            uint32 index = 0;
+            while (!(bits & 1))
+            {
+                bits >>= 1;
+                ++index;
+            }
+            return index;
+#endif
+        }
+
         uint32 mCount;
         uint32 mBlocks;
         uint32 *mUpdateMask;
@@ -0,0 +1,461 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "PlayerBotBenchmark.h"
+#include "PlayerBotMicroBenchmark.h"
+#include "PlayerBotMgr.h"
+#include "Player.h"
+#include "Creature.h"
+#include "MapManager.h"
+#include "MotionMaster.h"
+#include "MoveSpline.h"
+#include "ObjectAccessor.h"
+#include "World.h"
+#include "Config/Config.h"
+#include "Database/DatabaseEnv.h"
+#include "AuraTimerWheel.h"
+#include "Chat/Channel.h"
+#include "Chat/ChannelMgr.h"
+
+#include <algorithm>
+#include <sstream>
+
+// how long to wait for all bots to enter world before measuring anyway
+#define BENCHMARK_MAX_WARMUP    (2 * MINUTE * IN_MILISECONDS)
+// every channel of idle scenario gets one message this often
+#define BENCHMARK_CHANNEL_INTERVAL  IN_MILISECONDS
+
+static BenchmarkScenarioInfo const benchmarkScenarios[MAX_BENCHMARK_SCENARIO] =
+{
+    { "idle",     1,   1568.0f,  -4405.87f,  8.13f,  80.0f, 70 },  // Orgrimmar
+    { "questing", 1,   -618.5f,  -4251.67f, 38.72f, 120.0f,  3 },  // Valley of Trials
+    { "raid",     1,   1017.0f,  -4450.0f,  12.0f,   15.0f, 70 },  // Durotar, outside Orgrimmar
+    { "pvp",      0, -13204.0f,    275.0f,  21.86f,  30.0f, 70 },  // Gurubashi Arena
+};
+
+bool BenchmarkBotAI::OnSessionLoaded(PlayerBotEntry* /*entry*/, WorldSession* sess)
+{
+    BenchmarkScenarioInfo const* info = PlayerBotBenchmark::GetScenarioInfo(m_scenario);
+
+    float x = info->x;
+    float y = info->y;
+    float z = info->z;
+    if (Map* map = sMapMgr.FindMap(info->mapId))
+        map->GetReachableRandomPointOnGround(x, y, z, info->radius);
+
+    return SpawnNewPlayer(sess, m_class, m_race, info->mapId, 0, x, y, z, frand(0.0f, 2 * M_PI_F));
+}
+
+void BenchmarkBotAI::OnPlayerLogin()
+{
+    BenchmarkScenarioInfo const* info = PlayerBotBenchmark::GetScenarioInfo(m_scenario);
+    if (me->GetLevel() != info->level)
+    {
+        me->GiveLevel(info->level);
+        me->InitTalentForLevel();
+        me->SetUInt32Value(PLAYER_XP, 0);
+    }
+}
+
+void BenchmarkBotAI::UpdateAI(uint32 const diff)
+{
+    PlayerBotAI::UpdateAI(diff);
+
+    m_updateTimer.Update(diff);
+    if (!m_updateTimer.Passed())
+        return;
+
+    m_updateTimer.Reset(1000);
+
+    if (!me->IsInWorld() || me->IsBeingTeleported())
+        return;
+
+    if (!me->IsAlive())
+    {
+        me->ResurrectPlayer(1.0f);
+        me->SpawnCorpseBones();
+        return;
+    }
+
+    if (m_scenario == BENCHMARK_IDLE)
+    {
+        if (me->movespline->Finalized() && !urand(0, 2))
+            MoveToRandomPoint();
+        return;
+    }
+
+    Unit* victim = me->GetVictim();
+    if (!victim || !victim->IsAlive())
+        victim = SelectTarget();
+
+    if (victim)
+    {
+        if (me->GetVictim() != victim && me->Attack(victim, true))
+            me->GetMotionMaster()->MoveChase(victim);
+        return;
+    }
+
+    if (me->movespline->Finalized())
+        MoveToRandomPoint();
+}
+
+void BenchmarkBotAI::MoveToRandomPoint()
+{
+    BenchmarkScenarioInfo const* info = PlayerBotBenchmark::GetScenarioInfo(m_scenario);
+
+    float x = info->x;
+    float y = info->y;
+    float z = info->z;
+    if (me->GetMap()->GetReachableRandomPointOnGround(x, y, z, info->radius))
+        me->GetMotionMaster()->MovePoint(0, x, y, z, true);
+}
+
+Unit* BenchmarkBotAI::SelectTarget()
+{
+    if (m_scenario != BENCHMARK_RAID)
+        return me->SelectNearbyTarget(30.0f);
+
+    PlayerBotBenchmark& benchmark = sPlayerBotMgr.GetBenchmark();
+    if (Creature* boss = me->GetMap()->GetCreature(benchmark.GetRaidTarget()))
+        if (boss->IsAlive())
+            return boss;
+
+    if (!benchmark.IsRunning())
+        return nullptr;
+
+    BenchmarkScenarioInfo const* info = PlayerBotBenchmark::GetScenarioInfo(m_scenario);
+    uint32 entry = sConfig.GetIntDefault("PlayerBot.Benchmark.RaidBoss", 18728);
+
+    Creature* boss = me->SummonCreature(entry, info->x, info->y, info->z, 0.0f, TEMPSUMMON_TIMED_OR_DEAD_DESPAWN, 30 * MINUTE * IN_MILISECONDS);
+    if (!boss)
+        return nullptr;
+
+    benchmark.SetRaidTarget(boss->GetGUID());
+    return boss;
+}
+
+BenchmarkScenarioInfo const* PlayerBotBenchmark::GetScenarioInfo(BenchmarkScenario scenario)
+{
+    return &benchmarkScenarios[scenario < MAX_BENCHMARK_SCENARIO ? scenario : BENCHMARK_IDLE];
+}
+
+bool PlayerBotBenchmark::ParseScenario(char const* name, BenchmarkScenario& scenario)
+{
+    for (uint32 i = 0; i < MAX_BENCHMARK_SCENARIO; ++i)
+    {
+        if (strcmp(benchmarkScenarios[i].name, name) == 0)
+        {
+            scenario = BenchmarkScenario(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool PlayerBotBenchmark::Start(BenchmarkScenario scenario, uint32 count, uint32 seconds, bool shutdownWhenDone)
+{
+    if (m_running || m_micro || !count || !seconds)
+        return false;
+
+    // all scenarios are on continents, make sure the map exists before bots log in
+    BenchmarkScenarioInfo const* info = GetScenarioInfo(scenario);
+    if (!sMapMgr.CreateMap(info->mapId, nullptr))
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: PlayerBotBenchmark: can't create map %u of scenario '%s'.", info->mapId, info->name);
+        return false;
+    }
+
+    m_scenario = scenario;
+    m_duration = seconds * IN_MILISECONDS;
+    m_shutdownWhenDone = shutdownWhenDone;
+    m_runMicro = sConfig.GetBoolDefault("PlayerBot.Benchmark.Micro", false);
+    m_elapsed = 0;
+    m_measuring = false;
+    m_raidTarget = 0;
+    m_bots.clear();
+    m_tickDiffs.clear();
+    m_channels.clear();
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        // pvp scenario needs both factions
+        bool alliance = scenario == BENCHMARK_PVP && (i & 1);
+
+        BenchmarkBotAI* ai = new BenchmarkBotAI(scenario, alliance ? RACE_HUMAN : RACE_ORC, CLASS_WARRIOR);
+        if (sPlayerBotMgr.AddBot(ai))
+            m_bots.push_back(ai->botEntry->playerGUID);
+    }
+
+    m_running = !m_bots.empty();
+
+    sLog.outString("[Benchmark] Scenario '%s': %u of %u bots spawning, measuring %u seconds once they are in world.",
+        info->name, uint32(m_bots.size()), count, seconds);
+
+    return m_running;
+}
+
+void PlayerBotBenchmark::Stop()
+{
+    if (!m_running)
+        return;
+
+    for (std::vector<uint32>::const_iterator itr = m_bots.begin(); itr != m_bots.end(); ++itr)
+        sPlayerBotMgr.RequestBotRemoval(*itr);
+
+    m_bots.clear();
+    m_tickDiffs.clear();
+    m_running = false;
+    m_measuring = false;
+}
+
+void PlayerBotBenchmark::Update(uint32 diff)
+{
+    if (m_micro)
+    {
+        // joined only once finished, world thread never waits for it
+        if (!m_micro->IsDone())
+            return;
+
+        StopMicro();
+
+        if (m_shutdownWhenDone)
+            sWorld.ShutdownServ(0, 0, SHUTDOWN_EXIT_CODE, "benchmark finished");
+        return;
+    }
+
+    if (!m_running)
+        return;
+
+    m_elapsed += diff;
+
+    if (!m_measuring)
+    {
+        uint32 inWorld = 0;
+        for (std::vector<uint32>::const_iterator itr = m_bots.begin(); itr != m_bots.end(); ++itr)
+            if (Player* bot = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(*itr, 0, HIGHGUID_PLAYER)))
+                if (bot->IsInWorld())
+                    ++inWorld;
+
+        if (inWorld < m_bots.size() && m_elapsed < BENCHMARK_MAX_WARMUP)
+            return;
+
+        if (inWorld < m_bots.size())
+            sLog.outString("[Benchmark] Only %u of %u bots entered world, measuring anyway.", inWorld, uint32(m_bots.size()));
+
+        BeginMeasure();
+        return;
+    }
+
+    m_tickDiffs.push_back(diff);
+
+    if (m_scenario == BENCHMARK_IDLE)
+        UpdateChannels(diff);
+
+    if (m_elapsed < m_duration)
+        return;
+
+    Report();
+    Stop();
+
+    if (m_runMicro)
+    {
+        StartMicro();
+        return;
+    }
+
+    if (m_shutdownWhenDone)
+        sWorld.ShutdownServ(0, 0, SHUTDOWN_EXIT_CODE, "benchmark finished");
+}
+
+void PlayerBotBenchmark::SnapshotMapTimes(MapTimes& times)
+{
+    times.clear();
+
+    MapUpdateTimes mapTimes;
+    MapManager::MapMapType const& maps = sMapMgr.Maps();
+    for (MapManager::MapMapType::const_iterator itr = maps.begin(); itr != maps.end(); ++itr)
+    {
+        itr->second->GetUpdateTimes(mapTimes);
+        times[std::make_pair(itr->first.nMapId, itr->first.nInstanceId)] = std::make_pair(mapTimes.total, mapTimes.count);
+    }
+}
+
+// 1%, 10% and all bots, members leave the channels when bots log out
+void PlayerBotBenchmark::JoinChannels()
+{
+    m_channels.clear();
+    m_channelTimer.Reset(BENCHMARK_CHANNEL_INTERVAL);
+
+    uint32 sizes[3] = { uint32(m_bots.size() / 100), uint32(m_bots.size() / 10), uint32(m_bots.size()) };
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        uint32 size = std::max(sizes[i], 1u);
+        if (!m_channels.empty() && m_channels.back().size == size)
+            continue;
+
+        std::ostringstream name;
+        name << "Benchmark" << size;
+        m_channels.push_back(BenchmarkChannel(name.str(), size));
+
+        Channel* channel = channelMgr(HORDE)->GetJoinChannel(name.str());
+        for (uint32 j = 0; j < size; ++j)
+            if (Player* bot = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(m_bots[j], 0, HIGHGUID_PLAYER)))
+                if (bot->IsInWorld())
+                    channel->Join(bot->GetGUID(), "");
+    }
+}
+
+// first bot speaks in every channel, times the whole broadcast to members
+void PlayerBotBenchmark::UpdateChannels(uint32 diff)
+{
+    m_channelTimer.Update(diff);
+    if (!m_channelTimer.Passed())
+        return;
+
+    m_channelTimer.Reset(BENCHMARK_CHANNEL_INTERVAL);
+
+    Player* sender = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(m_bots[0], 0, HIGHGUID_PLAYER));
+    if (!sender || !sender->IsInWorld())
+        return;
+
+    for (std::vector<BenchmarkChannel>::iterator itr = m_channels.begin(); itr != m_channels.end(); ++itr)
+    {
+        Channel* channel = channelMgr(HORDE)->GetJoinChannel(itr->name);
+
+        uint64 start = WorldTimer::getUSTime();
+        channel->Say(sender->GetGUID(), "benchmark", LANG_UNIVERSAL);
+        itr->time += WorldTimer::getUSTime() - start;
+
+        ++itr->messages;
+        itr->deliveries += channel->GetNumPlayers();
+    }
+}
+
+void PlayerBotBenchmark::StartMicro()
+{
+    m_micro = new PlayerBotMicroBenchmark();
+    m_micro->incReference();                                // keep it readable after the thread releases it
+    m_microThread = new ACE_Based::Thread(m_micro);
+}
+
+void PlayerBotBenchmark::StopMicro()
+{
+    if (!m_micro)
+        return;
+
+    m_microThread->wait();
+    delete m_microThread;
+    m_microThread = nullptr;
+
+    m_micro->decReference();
+    m_micro = nullptr;
+}
+
+void PlayerBotBenchmark::BeginMeasure()
+{
+    m_measuring = true;
+    m_elapsed = 0;
+    m_tickDiffs.reserve(m_duration / 50);
+
+    // before the snapshots, every join is announced to all members
+    if (m_scenario == BENCHMARK_IDLE)
+        JoinChannels();
+
+    SnapshotMapTimes(m_startMapTimes);
+    m_startPackets = WorldSession::GetSentPacketCount();
+    m_startBytes = WorldSession::GetSentPacketBytes();
+    m_startDbOps[0] = AccountsDatabase.GetOperationCount();
+    m_startDbOps[1] = GameDataDatabase.GetOperationCount();
+    m_startDbOps[2] = RealmDataDatabase.GetOperationCount();
+
+    AuraTimerWheel::ResetStats();
+}
+
+void PlayerBotBenchmark::Report()
+{
+    BenchmarkScenarioInfo const* info = GetScenarioInfo(m_scenario);
+    float seconds = m_elapsed / 1000.0f;
+
+    sLog.outString("[Benchmark] ===== Scenario '%s', %u bots, %.1f seconds =====", info->name, uint32(m_bots.size()), seconds);
+
+    if (!m_tickDiffs.empty())
+    {
+        std::vector<uint32> diffs = m_tickDiffs;
+        std::sort(diffs.begin(), diffs.end());
+
+        uint64 sum = 0;
+        for (std::vector<uint32>::const_iterator itr = diffs.begin(); itr != diffs.end(); ++itr)
+            sum += *itr;
+
+        size_t last = diffs.size() - 1;
+        sLog.outString("[Benchmark] World ticks: %u, diff avg %.2f ms, p50 %u ms, p95 %u ms, p99 %u ms, max %u ms",
+            uint32(diffs.size()), float(sum) / diffs.size(), diffs[last * 50 / 100], diffs[last * 95 / 100], diffs[last * 99 / 100], diffs[last]);
+    }
+
+    MapTimes endMapTimes;
+    SnapshotMapTimes(endMapTimes);
+
+    for (MapTimes::const_iterator itr = endMapTimes.begin(); itr != endMapTimes.end(); ++itr)
+    {
+        uint64 total = itr->second.first;
+        uint32 count = itr->second.second;
+
+        MapTimes::const_iterator start = m_startMapTimes.find(itr->first);
+        if (start != m_startMapTimes.end())
+        {
+            total -= start->second.first;
+            count -= start->second.second;
+        }
+
+        if (!count)
+            continue;
+
+        sLog.outString("[Benchmark] Map %u instance %u: %u updates, avg %.3f ms, total %.1f ms",
+            itr->first.first, itr->first.second, count, total / 1000.0f / count, total / 1000.0f);
+    }
+
+    uint64 packets = WorldSession::GetSentPacketCount() - m_startPackets;
+    uint64 bytes = WorldSession::GetSentPacketBytes() - m_startBytes;
+    sLog.outString("[Benchmark] Packets sent: " UI64FMTD " (%.0f/s), bytes sent: " UI64FMTD " (%.0f/s)",
+        packets, packets / seconds, bytes, bytes / seconds);
+
+    long dbOps[3] =
+    {
+        AccountsDatabase.GetOperationCount() - m_startDbOps[0],
+        GameDataDatabase.GetOperationCount() - m_startDbOps[1],
+        RealmDataDatabase.GetOperationCount() - m_startDbOps[2]
+    };
+    sLog.outString("[Benchmark] DB statements: accounts %ld, game data %ld, realm data %ld (%.1f/s total)",
+        dbOps[0], dbOps[1], dbOps[2], (dbOps[0] + dbOps[1] + dbOps[2]) / seconds);
+
+    for (std::vector<BenchmarkChannel>::const_iterator itr = m_channels.begin(); itr != m_channels.end(); ++itr)
+    {
+        if (!itr->messages)
+            continue;
+
+        uint32 members = uint32(itr->deliveries / itr->messages);
+        sLog.outString("[Benchmark] Channel of %u members (%u asked): %u messages, avg %.1f us per message, %.3f us per member",
+            members, itr->size, itr->messages, float(itr->time) / itr->messages, itr->deliveries ? float(itr->time) / itr->deliveries : 0.0f);
+    }
+
+    AuraUpdateStats auras = AuraTimerWheel::GetTotalStats();
+    sLog.outString("[Benchmark] Auras (timer wheel %s): " UI64FMTD " of " UI64FMTD " updated (%.1f%%) in " UI64FMTD " unit updates",
+        sWorld.getConfig(CONFIG_AURA_TIMER_WHEEL) ? "on" : "off", auras.touched, auras.present,
+        auras.present ? auras.touched * 100.0f / auras.present : 0.0f, auras.updates);
+}
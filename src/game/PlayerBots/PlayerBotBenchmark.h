@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef MANGOS_PLAYERBOTBENCHMARK_H
+#define MANGOS_PLAYERBOTBENCHMARK_H
+
+#include "PlayerBotAI.h"
+#include "Timer.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+class PlayerBotMicroBenchmark;
+namespace ACE_Based { class Thread; }
+
+enum BenchmarkScenario
+{
+    BENCHMARK_IDLE      = 0,                                // capital city, bots wander around and chat in channels
+    BENCHMARK_QUESTING  = 1,                                // starting zone, bots hunt nearby creatures
+    BENCHMARK_RAID      = 2,                                // bots fight a single summoned boss
+    BENCHMARK_PVP       = 3,                                // both factions fight in free for all area
+
+    MAX_BENCHMARK_SCENARIO
+};
+
+struct BenchmarkScenarioInfo
+{
+    char const* name;
+    uint32 mapId;
+    float x, y, z;
+    float radius;
+    uint8 level;
+};
+
+// idle scenario, one member broadcasts to a custom channel of given size
+struct BenchmarkChannel
+{
+    BenchmarkChannel(std::string const& name_, uint32 size_) : name(name_), size(size_), messages(0), deliveries(0), time(0) {}
+
+    std::string name;
+    uint32 size;                                            // bots asked to join
+    uint32 messages;
+    uint64 deliveries;                                      // sum of members at time of each message
+    uint64 time;                                            // microseconds spent in Channel::Say
+};
+
+class BenchmarkBotAI : public PlayerBotAI
+{
+    public:
+        BenchmarkBotAI(BenchmarkScenario scenario, uint8 race, uint8 class_) : PlayerBotAI(nullptr), m_scenario(scenario), m_race(race), m_class(class_)
+        {
+            m_updateTimer.Reset(urand(500, 1500));
+        }
+
+        bool OnSessionLoaded(PlayerBotEntry* entry, WorldSession* sess) override;
+        void OnPlayerLogin() override;
+        void UpdateAI(uint32 const diff) override;
+
+    private:
+        void MoveToRandomPoint();
+        Unit* SelectTarget();
+
+        BenchmarkScenario m_scenario;
+        uint8 m_race;
+        uint8 m_class;
+        ShortTimeTracker m_updateTimer;
+};
+
+/**
+ * Load generator built on top of PlayerBotMgr.
+ *
+ * Spawns bots into one of the scripted scenarios, waits until all of them are
+ * in world (or the warmup runs out), measures for the requested duration and
+ * writes a report with world tick percentiles, per-map update times, packets
+ * sent, database statements executed, aura update cost and, in idle scenario,
+ * channel broadcast cost by member count. Micro benchmarks
+ * (PlayerBot.Benchmark.Micro) follow on own thread once bots are removed.
+ */
+class PlayerBotBenchmark
+{
+    public:
+        PlayerBotBenchmark() : m_running(false), m_measuring(false), m_shutdownWhenDone(false), m_scenario(BENCHMARK_IDLE),
+            m_elapsed(0), m_duration(0), m_startPackets(0), m_startBytes(0), m_raidTarget(0), m_runMicro(false), m_micro(nullptr), m_microThread(nullptr) {}
+        ~PlayerBotBenchmark() { StopMicro(); }
+
+        static BenchmarkScenarioInfo const* GetScenarioInfo(BenchmarkScenario scenario);
+        static bool ParseScenario(char const* name, BenchmarkScenario& scenario);
+
+        bool Start(BenchmarkScenario scenario, uint32 count, uint32 seconds, bool shutdownWhenDone = false);
+        void Stop();
+        void Update(uint32 diff);
+
+        bool IsRunning() const { return m_running || m_micro; }
+
+        // raid scenario boss, summoned by first bot that needs it
+        uint64 GetRaidTarget() const { return m_raidTarget; }
+        void SetRaidTarget(uint64 guid) { m_raidTarget = guid; }
+
+    private:
+        typedef std::map<std::pair<uint32, uint32>, std::pair<uint64, uint32> > MapTimes;
+
+        void BeginMeasure();
+        void Report();
+        static void SnapshotMapTimes(MapTimes& times);
+        void JoinChannels();
+        void UpdateChannels(uint32 diff);
+        void StartMicro();
+        void StopMicro();
+
+        bool m_running;
+        bool m_measuring;
+        bool m_shutdownWhenDone;
+        BenchmarkScenario m_scenario;
+        uint32 m_elapsed;
+        uint32 m_duration;
+
+        std::vector<uint32> m_bots;
+        std::vector<uint32> m_tickDiffs;
+
+        MapTimes m_startMapTimes;
+        uint64 m_startPackets;
+        uint64 m_startBytes;
+        long m_startDbOps[3];
+
+        uint64 m_raidTarget;
+
+        std::vector<BenchmarkChannel> m_channels;
+        ShortTimeTracker m_channelTimer;
+
+        bool m_runMicro;
+        PlayerBotMicroBenchmark* m_micro;
+        ACE_Based::Thread* m_microThread;
+};
+
+#endif
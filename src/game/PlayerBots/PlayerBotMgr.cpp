@@ -30,6 +30,9 @@ PlayerBotMgr::PlayerBotMgr()
     m_confUpdateDiff            = 10000;
     m_confEnableRandomBots      = false;
     m_confDebug                 = false;
+    m_confBenchmarkBots         = 0;
+    m_confBenchmarkDuration     = 0;
+    m_confBenchmarkShutdown     = false;
 
     // Time
     m_elapsedTime = 0;
@@ -51,6 +54,10 @@ void PlayerBotMgr::LoadConfig()
     m_confAllowSaving = sConfig.GetBoolDefault("PlayerBot.AllowSaving", false);
     m_confDebug = sConfig.GetBoolDefault("PlayerBot.Debug", false);
     m_confUpdateDiff = sConfig.GetIntDefault("PlayerBot.UpdateMs", 10000);
+    m_confBenchmarkScenario = sConfig.GetStringDefault("PlayerBot.Benchmark.Scenario", "");
+    m_confBenchmarkBots = sConfig.GetIntDefault("PlayerBot.Benchmark.Bots", 100);
+    m_confBenchmarkDuration = sConfig.GetIntDefault("PlayerBot.Benchmark.Duration", 60);
+    m_confBenchmarkShutdown = sConfig.GetBoolDefault("PlayerBot.Benchmark.Shutdown", false);
     m_tempBots.clear();
 }
 
@@ -183,6 +190,19 @@ void PlayerBotMgr::OnPlayerInWorld(Player* player)
 
 void PlayerBotMgr::Update(uint32 diff)
 {
+    if (!m_confBenchmarkScenario.empty())
+    {
+        BenchmarkScenario scenario;
+        if (!PlayerBotBenchmark::ParseScenario(m_confBenchmarkScenario.c_str(), scenario))
+            sLog.outLog(LOG_DEFAULT, "ERROR: PlayerBot.Benchmark.Scenario '%s' is unknown.", m_confBenchmarkScenario.c_str());
+        else
+            m_benchmark.Start(scenario, m_confBenchmarkBots, m_confBenchmarkDuration, m_confBenchmarkShutdown);
+
+        m_confBenchmarkScenario.clear();
+    }
+
+    m_benchmark.Update(diff);
+
     // Temporary bots.
     std::map<uint32, uint32>::iterator it;
     for (it = m_tempBots.begin(); it != m_tempBots.end(); ++it)
@@ -464,6 +484,13 @@ bool PlayerBotMgr::DeleteBot(std::map<uint32, std::shared_ptr<PlayerBotEntry>>::
     return true;
 }
 
+void PlayerBotMgr::RequestBotRemoval(uint32 playerGUID)
+{
+    auto iter = m_bots.find(playerGUID);
+    if (iter != m_bots.end())
+        iter->second->requestRemoval = true;
+}
+
 bool PlayerBotMgr::DeleteRandomBot()
 {
     if (m_stats.onlineCount < 1)
@@ -626,6 +653,56 @@ bool ChatHandler::HandleBotStartCommand(const char * args)
     return true;
 }
 
+bool ChatHandler::HandleBotBenchmarkCommand(const char * args)
+{
+    PlayerBotBenchmark& benchmark = sPlayerBotMgr.GetBenchmark();
+
+    char* sScenario = strtok((char*)args, " ");
+    if (!sScenario)
+    {
+        SendSysMessage("Syntax: .bot benchmark idle|questing|raid|pvp [bots] [seconds] or .bot benchmark stop");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    if (strcmp(sScenario, "stop") == 0)
+    {
+        benchmark.Stop();
+        SendSysMessage("Benchmark stopped.");
+        return true;
+    }
+
+    BenchmarkScenario scenario;
+    if (!PlayerBotBenchmark::ParseScenario(sScenario, scenario))
+    {
+        PSendSysMessage("Unknown benchmark scenario: '%s'", sScenario);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    char* sCount = strtok(NULL, " ");
+    char* sSeconds = strtok(NULL, " ");
+    uint32 count = sCount ? uint32(atoi(sCount)) : 100;
+    uint32 seconds = sSeconds ? uint32(atoi(sSeconds)) : 60;
+
+    if (benchmark.IsRunning())
+    {
+        SendSysMessage("Benchmark is already running.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    if (!benchmark.Start(scenario, count, seconds))
+    {
+        SendSysMessage("Unable to start benchmark.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Benchmark started with %u bots for %u seconds, report will be written to server log.", count, seconds);
+    return true;
+}
+
 uint8 SelectRandomRaceForClass(uint8 playerClass, Team playerTeam)
 {
     switch (playerClass)
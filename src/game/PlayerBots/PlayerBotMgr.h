@@ -5,6 +5,7 @@
 #include "Policies/Singleton.h"
 #include "Database/DatabaseEnv.h"
 #include "PlayerBotAI.h"
+#include "PlayerBotBenchmark.h"
 
 #include <vector>
 #include <memory>
@@ -83,6 +84,7 @@ class PlayerBotMgr
         bool AddBot(uint32 playerGuid, bool chatBot = false, PlayerBotAI* pAI = nullptr);
         bool DeleteBot(std::map<uint32, std::shared_ptr<PlayerBotEntry>>::iterator iter);
         bool DeleteBot(uint32 playerGuid);
+        void RequestBotRemoval(uint32 playerGuid);
 
         bool AddRandomBot();
         bool DeleteRandomBot();
@@ -104,6 +106,7 @@ class PlayerBotMgr
         uint32 GenBotAccountId() { return ++m_maxAccountId; }
         PlayerBotStats& GetStats(){ return m_stats; }
         void Start() { m_confEnableRandomBots = true; }
+        PlayerBotBenchmark& GetBenchmark() { return m_benchmark; }
     protected:
         // How long since last update?
         uint32 m_elapsedTime;
@@ -115,6 +118,7 @@ class PlayerBotMgr
         std::map<uint32 /*pl guid*/, std::shared_ptr<PlayerBotEntry>> m_bots;
         std::map<uint32 /*account*/, uint32> m_tempBots;
         PlayerBotStats m_stats;
+        PlayerBotBenchmark m_benchmark;
 
         uint32 m_confMinRandomBots;
         uint32 m_confMaxRandomBots;
@@ -123,6 +127,12 @@ class PlayerBotMgr
         bool m_confAllowSaving;
         bool m_confDebug;
         bool m_confEnableRandomBots;
+
+        // headless benchmark started on first update
+        std::string m_confBenchmarkScenario;
+        uint32 m_confBenchmarkBots;
+        uint32 m_confBenchmarkDuration;
+        bool m_confBenchmarkShutdown;
 };
 
 #define sPlayerBotMgr MaNGOS::Singleton<PlayerBotMgr>::Instance()
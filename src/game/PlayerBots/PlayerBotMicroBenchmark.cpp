@@ -0,0 +1,470 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "PlayerBotMicroBenchmark.h"
+#include "Object.h"
+#include "UpdateFields.h"
+#include "Timer.h"
+#include "Util.h"
+#include "Log.h"
+#include "World.h"
+#include "WorldPacket.h"
+#include "LockedQueue.h"
+#include "MPSCRing.h"
+#include "Utilities/EventProcessor.h"
+#include "Database/DatabaseEnv.h"
+
+#include <map>
+#include <sstream>
+#include <vector>
+
+#define VALUES_BENCH_ROWS       1000                        // characters, items take 50 times more
+#define VALUES_BENCH_PASSES     10
+#define VALUES_BENCH_LOGIN_ITEMS 100                        // items decoded by average login
+
+#define QUEUE_BENCH_PRODUCERS   8                           // reactor threads
+#define QUEUE_BENCH_PACKETS     200000                      // per producer
+#define QUEUE_BENCH_SPILL_RING  16                          // cells of ring that spills almost always
+
+#define EVENT_BENCH_EVENTS      10000
+#define EVENT_BENCH_STEP        50                          // ms per Update(), like a busy map
+#define EVENT_BENCH_DURATION    60000
+#define EVENT_BENCH_REPEATS     20
+#define EVENT_BENCH_UNITS       10000                       // fresh processors getting their first event
+
+struct ValuesBenchResult
+{
+    ValuesBenchResult() : rows(0), blobRows(0), brokenRows(0), textBytes(0), blobBytes(0), queryTime(0), legacyTime(0), textTime(0), blobTime(0) {}
+
+    uint32 rows;
+    uint32 blobRows;                                        // rows already migrated to blob
+    uint32 brokenRows;
+    uint64 textBytes;
+    uint64 blobBytes;
+    uint64 queryTime;                                       // microseconds
+    uint64 legacyTime;                                      // StrSplit + atol, as before blob format
+    uint64 textTime;
+    uint64 blobTime;
+};
+
+// decodes `data` of up to rows rows in old and new ways, every row is converted to both formats
+static void BenchValuesTable(char const* table, uint32 minCount, uint32 maxCount, uint32 rows, ValuesBenchResult& bench)
+{
+    uint64 start = WorldTimer::getUSTime();
+    QueryResultAutoPtr result = RealmDataDatabase.PQuery("SELECT data FROM %s LIMIT %u", table, rows);
+    bench.queryTime = WorldTimer::getUSTime() - start;
+    if (!result)
+        return;
+
+    std::vector<uint32> values(maxCount);
+    std::vector<std::pair<std::string, uint32> > texts;
+    std::vector<std::pair<std::string, uint32> > blobs;
+    do
+    {
+        Field* fields = result->Fetch();
+
+        // items and bags have different number of fields
+        uint32 count = minCount;
+        if (!Object::DecodeValues(fields[0].GetString(), fields[0].GetLength(), &values[0], count))
+        {
+            count = maxCount;
+            if (minCount == maxCount || !Object::DecodeValues(fields[0].GetString(), fields[0].GetLength(), &values[0], count))
+            {
+                ++bench.brokenRows;
+                continue;
+            }
+        }
+
+        if (fields[0].GetLength() && uint8(fields[0].GetString()[0]) == VALUES_BLOB_MAGIC)
+            ++bench.blobRows;
+
+        std::ostringstream ss;
+        for (uint32 i = 0; i < count; ++i)
+            ss << values[i] << " ";
+
+        texts.push_back(std::make_pair(ss.str(), count));
+        blobs.push_back(std::make_pair(Object::EncodeValues(&values[0], count), count));
+        bench.textBytes += texts.back().first.size();
+        bench.blobBytes += blobs.back().first.size();
+    }
+    while (result->NextRow());
+
+    bench.rows = texts.size();
+
+    start = WorldTimer::getUSTime();
+    for (uint32 pass = 0; pass < VALUES_BENCH_PASSES; ++pass)
+    {
+        for (uint32 i = 0; i < texts.size(); ++i)
+        {
+            Tokens tokens = StrSplit(texts[i].first, " ");
+            for (uint32 j = 0; j < texts[i].second && j < tokens.size(); ++j)
+                values[j] = atol(tokens[j].c_str());
+        }
+    }
+    bench.legacyTime = WorldTimer::getUSTime() - start;
+
+    start = WorldTimer::getUSTime();
+    for (uint32 pass = 0; pass < VALUES_BENCH_PASSES; ++pass)
+        for (uint32 i = 0; i < texts.size(); ++i)
+            Object::DecodeValues(texts[i].first.c_str(), texts[i].first.size(), &values[0], texts[i].second);
+    bench.textTime = WorldTimer::getUSTime() - start;
+
+    start = WorldTimer::getUSTime();
+    for (uint32 pass = 0; pass < VALUES_BENCH_PASSES; ++pass)
+        for (uint32 i = 0; i < blobs.size(); ++i)
+            Object::DecodeValues(blobs[i].first.data(), blobs[i].first.size(), &values[0], blobs[i].second);
+    bench.blobTime = WorldTimer::getUSTime() - start;
+}
+
+// accepts everything, stands in for session's PacketFilter
+struct QueueBenchFilter
+{
+    bool Process(WorldPacket* /*packet*/) { return true; }
+};
+
+static bool QueueBenchAdd(ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex>& queue, WorldPacket* packet)
+{
+    queue.add(packet);
+    return true;
+}
+
+static bool QueueBenchAdd(ACE_Based::MPSCRing<WorldPacket*>& queue, WorldPacket* packet)
+{
+    return queue.add(packet);
+}
+
+// plays a reactor thread pushing packets of its sockets
+template<class Queue>
+class QueueBenchProducer : public ACE_Based::Runnable
+{
+    public:
+        QueueBenchProducer(Queue& queue, uint32 count, std::atomic<bool>& start) : m_queue(queue), m_count(count), m_start(start) {}
+
+        void run() override
+        {
+            while (!m_start.load(std::memory_order_acquire))
+                ACE_Thread::yield();
+
+            // queue at its limit would disconnect the client, here we wait for consumer
+            // packets are never touched, any non null pointer will do
+            for (uint32 i = 0; i < m_count; ++i)
+                while (!QueueBenchAdd(m_queue, (WorldPacket*)&m_queue))
+                    ACE_Thread::yield();
+        }
+
+    private:
+        Queue& m_queue;
+        uint32 m_count;
+        std::atomic<bool>& m_start;
+};
+
+// returns microseconds needed to pass producers * count packets from producer threads to this one
+template<class Queue>
+static uint64 BenchRecvQueue(Queue& queue, uint32 producers, uint32 count)
+{
+    std::atomic<bool> start(false);
+    std::vector<ACE_Based::Thread*> threads;
+    for (uint32 i = 0; i < producers; ++i)
+        threads.push_back(new ACE_Based::Thread(new QueueBenchProducer<Queue>(queue, count, start)));
+
+    QueueBenchFilter filter;
+    uint64 total = uint64(producers) * count;
+    uint64 received = 0;
+    WorldPacket* packet;
+
+    uint64 begin = WorldTimer::getUSTime();
+    start.store(true, std::memory_order_release);
+
+    while (received < total)
+    {
+        if (queue.next(packet, filter))
+            ++received;
+        else
+            ACE_Thread::yield();
+    }
+
+    uint64 time = WorldTimer::getUSTime() - begin;
+
+    for (uint32 i = 0; i < producers; ++i)
+    {
+        threads[i]->wait();
+        delete threads[i];
+    }
+
+    return time;
+}
+
+// EventProcessor before the timing wheel, kept to compare with
+class MultimapEventProcessor
+{
+    public:
+        typedef std::multimap<uint64, BasicEvent*> EventList;
+
+        MultimapEventProcessor() : m_time(0) {}
+        ~MultimapEventProcessor()
+        {
+            for (EventList::iterator i = m_events.begin(); i != m_events.end(); ++i)
+                delete i->second;
+        }
+
+        uint32 Update(uint32 p_time)
+        {
+            uint32 count = 0;
+            m_time += p_time;
+
+            EventList::iterator i;
+            while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+            {
+                count++;
+                BasicEvent* Event = i->second;
+                m_events.erase(i);
+
+                if (!Event->to_Abort)
+                {
+                    if (Event->Execute(m_time, p_time))
+                        delete Event;
+                }
+                else
+                {
+                    Event->Abort(m_time);
+                    delete Event;
+                }
+            }
+            return count;
+        }
+
+        void AddEvent(BasicEvent* Event, uint64 e_time)
+        {
+            Event->m_execTime = m_time + e_time;
+            m_events.insert(std::pair<uint64, BasicEvent*>(Event->m_execTime, Event));
+        }
+
+        void CancelEvent(BasicEvent* Event)
+        {
+            std::pair<EventList::iterator, EventList::iterator> range = m_events.equal_range(Event->m_execTime);
+            for (EventList::iterator i = range.first; i != range.second; ++i)
+            {
+                if (i->second == Event)
+                {
+                    m_events.erase(i);
+                    Event->Abort(m_time);
+                    delete Event;
+                    return;
+                }
+            }
+        }
+
+    private:
+        uint64 m_time;
+        EventList m_events;
+};
+
+template<class Processor> class EventBenchEvent;
+
+// multimap version allocated every event by global new, the wheel one uses the pool
+template<class Processor> struct EventBenchBase { typedef BasicEvent Type; };
+template<> struct EventBenchBase<EventProcessor> { typedef PooledEvent<EventBenchEvent<EventProcessor> > Type; };
+
+// plays AI notify and spell events, adds itself again a few times and then ends
+template<class Processor>
+class EventBenchEvent : public EventBenchBase<Processor>::Type
+{
+    public:
+        EventBenchEvent(Processor& processor, std::vector<uint32> const& delays, uint32 index, uint32 repeats)
+            : m_processor(processor), m_delays(delays), m_index(index), m_repeats(repeats) {}
+
+        bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+        {
+            if (!m_repeats)
+                return true;
+
+            --m_repeats;
+            m_processor.AddEvent(this, m_delays[++m_index % m_delays.size()]);
+            return false;
+        }
+
+    private:
+        Processor& m_processor;
+        std::vector<uint32> const& m_delays;
+        uint32 m_index;
+        uint32 m_repeats;
+};
+
+struct EventBenchResult
+{
+    EventBenchResult() : addTime(0), updateTime(0), cancelTime(0), executed(0), firstAddTime(0) {}
+
+    uint64 addTime;
+    uint64 updateTime;
+    uint64 cancelTime;
+    uint64 executed;
+    uint64 firstAddTime;                                    // EVENT_BENCH_UNITS new processors, one event each
+};
+
+template<class Processor>
+static void BenchEventProcessor(std::vector<uint32> const& delays, EventBenchResult& result)
+{
+    {
+        Processor processor;
+
+        uint64 start = WorldTimer::getUSTime();
+        for (uint32 i = 0; i < EVENT_BENCH_EVENTS; ++i)
+            processor.AddEvent(new EventBenchEvent<Processor>(processor, delays, i, EVENT_BENCH_REPEATS), delays[i % delays.size()]);
+        result.addTime = WorldTimer::getUSTime() - start;
+
+        start = WorldTimer::getUSTime();
+        for (uint32 time = 0; time < EVENT_BENCH_DURATION; time += EVENT_BENCH_STEP)
+            result.executed += processor.Update(EVENT_BENCH_STEP);
+        result.updateTime = WorldTimer::getUSTime() - start;
+
+        std::vector<BasicEvent*> cancelled;
+        cancelled.reserve(EVENT_BENCH_EVENTS);
+        for (uint32 i = 0; i < EVENT_BENCH_EVENTS; ++i)
+        {
+            BasicEvent* event = new EventBenchEvent<Processor>(processor, delays, i, 0);
+            processor.AddEvent(event, delays[(i * 7) % delays.size()]);
+            cancelled.push_back(event);
+        }
+
+        start = WorldTimer::getUSTime();
+        for (uint32 i = 0; i < EVENT_BENCH_EVENTS; ++i)
+            processor.CancelEvent(cancelled[i]);
+        result.cancelTime = WorldTimer::getUSTime() - start;
+    }
+
+    // every unit owns a processor, most get their first event long after spawn
+    std::vector<Processor*> units(EVENT_BENCH_UNITS);
+    uint64 start = WorldTimer::getUSTime();
+    for (uint32 i = 0; i < EVENT_BENCH_UNITS; ++i)
+    {
+        units[i] = new Processor();
+        units[i]->AddEvent(new EventBenchEvent<Processor>(*units[i], delays, i, 0), delays[i % delays.size()]);
+    }
+    result.firstAddTime = WorldTimer::getUSTime() - start;
+
+    for (uint32 i = 0; i < EVENT_BENCH_UNITS; ++i)
+        delete units[i];
+}
+
+void PlayerBotMicroBenchmark::run()
+{
+    sLog.outString("[Benchmark] ===== Micro benchmarks =====");
+
+    BenchValuesDecode();
+    BenchRecvQueues();
+    BenchEventProcessors();
+
+    m_done = true;
+}
+
+// `data` of characters and items as loaded on login, legacy text parsing vs text and blob DecodeValues
+void PlayerBotMicroBenchmark::BenchValuesDecode()
+{
+    RealmDataDatabase.ThreadStart();
+
+    ValuesBenchResult chars;
+    ValuesBenchResult items;
+    BenchValuesTable("characters", PLAYER_END, PLAYER_END, VALUES_BENCH_ROWS, chars);
+    BenchValuesTable("item_instance", ITEM_END, CONTAINER_END, VALUES_BENCH_ROWS * 50, items);
+
+    RealmDataDatabase.ThreadEnd();
+
+    ValuesBenchResult* results[2] = { &chars, &items };
+    char const* names[2] = { "characters", "item_instance" };
+    for (uint32 i = 0; i < 2; ++i)
+    {
+        ValuesBenchResult const& bench = *results[i];
+        if (!bench.rows)
+        {
+            sLog.outString("[Benchmark] Values %s: no rows to decode (%u broken).", names[i], bench.brokenRows);
+            continue;
+        }
+
+        uint64 decoded = uint64(bench.rows) * VALUES_BENCH_PASSES;
+        sLog.outString("[Benchmark] Values %s: %u rows (%u already blob, %u broken), query %u ms, row size text avg %u bytes, blob %u bytes",
+            names[i], bench.rows, bench.blobRows, bench.brokenRows, uint32(bench.queryTime / 1000),
+            uint32(bench.textBytes / bench.rows), uint32(bench.blobBytes / bench.rows));
+        sLog.outString("[Benchmark] Values %s decode rows/s: legacy split " UI64FMTD ", text " UI64FMTD ", blob " UI64FMTD,
+            names[i],
+            bench.legacyTime ? decoded * 1000000 / bench.legacyTime : 0,
+            bench.textTime ? decoded * 1000000 / bench.textTime : 0,
+            bench.blobTime ? decoded * 1000000 / bench.blobTime : 0);
+    }
+
+    // one login decodes the character and its items
+    if (chars.rows && items.rows)
+    {
+        uint64 legacyLogin = chars.legacyTime / chars.rows + VALUES_BENCH_LOGIN_ITEMS * items.legacyTime / items.rows;
+        uint64 textLogin = chars.textTime / chars.rows + VALUES_BENCH_LOGIN_ITEMS * items.textTime / items.rows;
+        uint64 blobLogin = chars.blobTime / chars.rows + VALUES_BENCH_LOGIN_ITEMS * items.blobTime / items.rows;
+        sLog.outString("[Benchmark] Login with %u items, values decoding per %u logins: legacy " UI64FMTD " us, text " UI64FMTD " us, blob " UI64FMTD " us",
+            VALUES_BENCH_LOGIN_ITEMS, VALUES_BENCH_PASSES, legacyLogin, textLogin, blobLogin);
+    }
+}
+
+// session receive queue under contention of many producers, drained through filter by one consumer
+void PlayerBotMicroBenchmark::BenchRecvQueues()
+{
+    uint64 total = uint64(QUEUE_BENCH_PRODUCERS) * QUEUE_BENCH_PACKETS;
+
+    ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex> lockedQueue;
+    uint64 lockedTime = BenchRecvQueue(lockedQueue, QUEUE_BENCH_PRODUCERS, QUEUE_BENCH_PACKETS);
+
+    // as configured for sessions, spills only on bursts
+    ACE_Based::MPSCRing<WorldPacket*> ring(sWorld.getConfig(CONFIG_SESSION_UPDATE_RECV_QUEUE_SIZE), sWorld.getConfig(CONFIG_SESSION_UPDATE_RECV_QUEUE_LIMIT));
+    uint64 ringTime = BenchRecvQueue(ring, QUEUE_BENCH_PRODUCERS, QUEUE_BENCH_PACKETS);
+
+    // producers outrun the consumer, nearly every packet goes through the spill queue
+    ACE_Based::MPSCRing<WorldPacket*> spillRing(QUEUE_BENCH_SPILL_RING, total);
+    uint64 spillTime = BenchRecvQueue(spillRing, QUEUE_BENCH_PRODUCERS, QUEUE_BENCH_PACKETS);
+
+    sLog.outString("[Benchmark] Receive queue, %u producer threads, " UI64FMTD " packets drained through filter by one consumer:",
+        QUEUE_BENCH_PRODUCERS, total);
+    sLog.outString("[Benchmark]   LockedQueue: " UI64FMTD " ms, " UI64FMTD " packets/s",
+        lockedTime / 1000, lockedTime ? total * 1000000 / lockedTime : 0);
+    sLog.outString("[Benchmark]   MPSCRing (%u cells, limit %u): " UI64FMTD " ms, " UI64FMTD " packets/s",
+        uint32(ring.capacity()), uint32(ring.limit()), ringTime / 1000, ringTime ? total * 1000000 / ringTime : 0);
+    sLog.outString("[Benchmark]   MPSCRing spilling (%u cells): " UI64FMTD " ms, " UI64FMTD " packets/s",
+        uint32(spillRing.capacity()), spillTime / 1000, spillTime ? total * 1000000 / spillTime : 0);
+}
+
+// timing wheel EventProcessor against the multimap one it replaced
+void PlayerBotMicroBenchmark::BenchEventProcessors()
+{
+    // mostly short timers, some long ones like respawn and aura events
+    std::vector<uint32> delays(4096);
+    for (uint32 i = 0; i < delays.size(); ++i)
+        delays[i] = urand(0, 9) ? urand(1, 2000) : urand(2000, 300000);
+
+    EventBenchResult multimap;
+    EventBenchResult wheel;
+    BenchEventProcessor<MultimapEventProcessor>(delays, multimap);
+    BenchEventProcessor<EventProcessor>(delays, wheel);
+
+    EventBenchResult* results[2] = { &multimap, &wheel };
+    char const* names[2] = { "multimap", "timing wheel" };
+
+    sLog.outString("[Benchmark] EventProcessor, %u events re-added up to %u times, %u s of %u ms updates, first event of %u new processors:",
+        EVENT_BENCH_EVENTS, EVENT_BENCH_REPEATS, EVENT_BENCH_DURATION / 1000, EVENT_BENCH_STEP, EVENT_BENCH_UNITS);
+    for (uint32 i = 0; i < 2; ++i)
+    {
+        EventBenchResult const& bench = *results[i];
+        sLog.outString("[Benchmark]   %s: add " UI64FMTD " us, update " UI64FMTD " us (" UI64FMTD " executed), cancel " UI64FMTD " us, first add " UI64FMTD " us",
+            names[i], bench.addTime, bench.updateTime, bench.executed, bench.cancelTime, bench.firstAddTime);
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef MANGOS_PLAYERBOTMICROBENCHMARK_H
+#define MANGOS_PLAYERBOTMICROBENCHMARK_H
+
+#include "Threading.h"
+
+#include <atomic>
+
+/**
+ * Micro benchmarks comparing single subsystems with the code they replaced.
+ *
+ * Started by PlayerBotBenchmark after the scenario report is written and run
+ * on own thread, so they neither stall the world nor skew its tick times.
+ * Results go to the server log as [Benchmark] lines.
+ */
+class PlayerBotMicroBenchmark : public ACE_Based::Runnable
+{
+    public:
+        PlayerBotMicroBenchmark() : m_done(false) {}
+
+        void run() override;
+
+        bool IsDone() const { return m_done; }
+
+    private:
+        void BenchValuesDecode();
+        void BenchRecvQueues();
+        void BenchEventProcessors();
+
+        std::atomic<bool> m_done;
+};
+
+#endif
@@ -24,6 +24,7 @@
 
 #include "Opcodes.h"
 #include "WorldSession.h"
+#include "World.h"
 
 /// Correspondence between opcodes and their names
 OpcodeHandler opcodeTable[NUM_MSG_TYPES] =
@@ -1089,3 +1090,79 @@ OpcodeHandler opcodeTable[NUM_MSG_TYPES] =
     /*0x422*/ { "SMSG_SPLINE_MOVE_UNSET_FLYING",    STATUS_NEVER,       PROCESS_INPLACE, &WorldSession::Handle_ServerSide               },
     /*0x423*/ { "SMSG_SUMMON_CANCEL",               STATUS_NEVER,       PROCESS_INPLACE, &WorldSession::Handle_ServerSide               },
 };
+
+OpcodeCost opcodeCostTable[NUM_MSG_TYPES];
+
+void RecordOpcodeCost(uint16 opcode, uint32 usec)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    OpcodeCost& cost = opcodeCostTable[opcode];
+
+    cost.count.fetch_add(1, std::memory_order_relaxed);
+    cost.totalTime.fetch_add(usec, std::memory_order_relaxed);
+
+    uint32 prevMax = cost.maxTime.load(std::memory_order_relaxed);
+    while (usec > prevMax && !cost.maxTime.compare_exchange_weak(prevMax, usec, std::memory_order_relaxed));
+
+    uint32 bucket = 0;
+    while (bucket < OPCODE_COST_BUCKETS - 1 && usec >= (1u << bucket))
+        ++bucket;
+
+    cost.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void ResetOpcodeCosts()
+{
+    for (uint16 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        OpcodeCost& cost = opcodeCostTable[i];
+
+        cost.count.store(0, std::memory_order_relaxed);
+        cost.totalTime.store(0, std::memory_order_relaxed);
+        cost.maxTime.store(0, std::memory_order_relaxed);
+
+        for (uint8 j = 0; j < OPCODE_COST_BUCKETS; ++j)
+            cost.histogram[j].store(0, std::memory_order_relaxed);
+    }
+}
+
+uint32 GetOpcodeCostPercentile(uint16 opcode, float pct)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return 0;
+
+    OpcodeCost const& cost = opcodeCostTable[opcode];
+
+    uint64 total = 0;
+    for (uint8 i = 0; i < OPCODE_COST_BUCKETS; ++i)
+        total += cost.histogram[i].load(std::memory_order_relaxed);
+
+    if (!total)
+        return 0;
+
+    uint64 wanted = uint64(total * pct / 100.0f);
+    uint64 seen = 0;
+    for (uint8 i = 0; i < OPCODE_COST_BUCKETS - 1; ++i)
+    {
+        seen += cost.histogram[i].load(std::memory_order_relaxed);
+        if (seen > wanted)
+            return 1u << i;
+    }
+
+    // open ended bucket, the maximum is the best we know
+    return cost.maxTime.load(std::memory_order_relaxed);
+}
+
+OpcodeCostRecorder::OpcodeCostRecorder(uint16 opcode) : m_opcode(opcode), m_startTime(0)
+{
+    if (sWorld.getConfig(CONFIG_SESSION_UPDATE_OPCODE_STATS))
+        m_startTime = WorldTimer::getUSTime();
+}
+
+OpcodeCostRecorder::~OpcodeCostRecorder()
+{
+    if (m_startTime)
+        RecordOpcodeCost(m_opcode, uint32(WorldTimer::getUSTime() - m_startTime));
+}
@@ -27,6 +27,8 @@
 
 #include "Common.h"
 
+#include <atomic>
+
 // Note: this include need for be sure have full definition of class WorldSession
 //       if this class definition not complite then VS for x64 release use different size for
 //       struct OpcodeHandler in this header and Opcode.cpp and get totally wrong data from
@@ -1129,6 +1131,36 @@ struct OpcodeHandler
 
 extern OpcodeHandler opcodeTable[NUM_MSG_TYPES];
 
+#define OPCODE_COST_BUCKETS 16                              // bucket i counts handlers that took < 2^i us, last one is open
+
+/// Aggregated handler cost of one opcode, updated by every thread processing packets
+struct OpcodeCost
+{
+    std::atomic<uint64> count;
+    std::atomic<uint64> totalTime;                          // in microseconds
+    std::atomic<uint32> maxTime;
+    std::atomic<uint32> histogram[OPCODE_COST_BUCKETS];
+};
+
+extern OpcodeCost opcodeCostTable[NUM_MSG_TYPES];
+
+void RecordOpcodeCost(uint16 opcode, uint32 usec);
+void ResetOpcodeCosts();
+/// Upper bound (in microseconds) of the histogram bucket holding the given percentile
+uint32 GetOpcodeCostPercentile(uint16 opcode, float pct);
+
+/// Records time spent in its scope as cost of the opcode, if SessionUpdate.OpcodeStats is enabled
+class OpcodeCostRecorder
+{
+    public:
+        explicit OpcodeCostRecorder(uint16 opcode);
+        ~OpcodeCostRecorder();
+
+    private:
+        uint16 m_opcode;
+        uint64 m_startTime;                                 // 0 if stats are disabled
+};
+
 /// Lookup opcode name for human understandable logging
 inline const char* LookupOpcodeName(uint16 id)
 {
@@ -71,6 +71,29 @@ struct ClientPktHeader
 #pragma pack(pop)
 #endif
 
+int ReusePortSockAcceptor::open(const ACE_Addr& local_sap, int reuse_addr, int protocol_family, int backlog, int protocol)
+{
+    if (local_sap != ACE_Addr::sap_any)
+        protocol_family = local_sap.get_type();
+    else if (protocol_family == PF_UNSPEC)
+        protocol_family = PF_INET;
+
+    if (ACE_SOCK::open(SOCK_STREAM, protocol_family, protocol, reuse_addr) == -1)
+        return -1;
+
+#if defined(SO_REUSEPORT)
+    // must be set before bind, every listener on the address needs it
+    int one = 1;
+    if (set_option(SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) == -1)
+    {
+        close();
+        return -1;
+    }
+#endif
+
+    return shared_open(local_sap, protocol_family, backlog);
+}
+
 WorldSocket::WorldSocket(void) :
 WorldHandler(),
 m_LastPingTime(ACE_Time_Value::zero),
@@ -82,6 +105,7 @@ m_Header(sizeof(ClientPktHeader)),
 m_OutBuffer(0),
 m_OutBufferSize(65536),
 m_OutActive(false),
+m_OwnerWrites(false),
 m_Seed(static_cast<uint32>(rand32()))
 {
     reference_counting_policy().value(ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
@@ -102,6 +126,9 @@ WorldSocket::~WorldSocket(void)
     WorldPacket* pct;
     while (m_PacketQueue.dequeue_head(pct) == 0)
         delete pct;
+
+    while (m_OutQueue.next(pct))
+        delete pct;
 }
 
 bool WorldSocket::IsClosed(void) const
@@ -135,6 +162,20 @@ const std::string& WorldSocket::GetRemoteAddress(void) const
 
 int WorldSocket::SendPacket(const WorldPacket& pct)
 {
+    if (m_OwnerWrites)
+    {
+        if (closing_)
+            return -1;
+
+        // the owning reactor thread picks it up on its next Update()
+        WorldPacket* npct;
+
+        ACE_NEW_RETURN(npct, WorldPacket(pct), -1);
+
+        m_OutQueue.add(npct);
+        return 0;
+    }
+
     ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
 
     if (closing_)
@@ -268,7 +309,13 @@ int WorldSocket::handle_input(ACE_HANDLE)
 
 int WorldSocket::handle_output(ACE_HANDLE)
 {
-    ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
+    // owner-written sockets are only ever flushed from their own reactor thread
+    GuardType Guard(m_OutBufferLock, true, 0);
+
+    if (m_OwnerWrites)
+        iDrainOutQueue();
+    else if (Guard.acquire() == -1)
+        return -1;
 
     if (closing_)
         return -1;
@@ -343,6 +390,9 @@ int WorldSocket::Update(void)
     if (closing_)
         return -1;
 
+    if (m_OwnerWrites)
+        iDrainOutQueue();
+
     if (m_OutActive || m_OutBuffer->length() == 0)
         return 0;
 
@@ -586,11 +636,14 @@ int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
                         if (sWorld.getConfig(CONFIG_WARDEN_KICK))
                             m_Session->KickPlayer();
                     }
-                    // OK ,give the packet to WorldSession
-                    aptr.release();
                     // WARNINIG here we call it with locks held.
                     // Its possible to cause deadlock if QueuePacket calls back
-                    m_Session->QueuePacket(new_pct);
+                    // queue is full, flooding client gets disconnected
+                    if (!m_Session->QueuePacket(new_pct))
+                        return -1;
+
+                    // OK ,packet belongs to WorldSession now
+                    aptr.release();
                     return 0;
                 }
                 else
@@ -1046,6 +1099,27 @@ bool WorldSocket::iFlushPacketQueue()
     return haveone;
 }
 
+void WorldSocket::iDrainOutQueue()
+{
+    WorldPacket* pct;
+
+    while (m_OutQueue.next(pct))
+    {
+        // keep the order, once something waits in m_PacketQueue everything goes behind it
+        if (m_PacketQueue.is_empty() && iSendPacket(*pct) == 0)
+        {
+            delete pct;
+            continue;
+        }
+
+        if (m_PacketQueue.enqueue_tail(pct) == -1)
+        {
+            delete pct;
+            sLog.outLog(LOG_DEFAULT, "ERROR: WorldSocket::iDrainOutQueue m_PacketQueue->enqueue_tail");
+        }
+    }
+}
+
 bool WorldSocket::IsChatOpcode(uint16 opcode)
 {
     switch(opcode)
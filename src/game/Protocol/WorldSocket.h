@@ -43,6 +43,7 @@
 #endif /* ACE_LACKS_PRAGMA_ONCE */
 
 #include "Common.h"
+#include "MPSCQueue.h"
 #include "Auth/AuthCrypt.h"
 
 class ACE_Message_Block;
@@ -52,6 +53,18 @@ class WorldSession;
 /// Handler that can communicate over stream sockets.
 typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
 
+/// Passive socket which sets SO_REUSEPORT before binding, so every
+/// network thread can run its own acceptor on the same address.
+class ReusePortSockAcceptor : public ACE_SOCK_Acceptor
+{
+    public:
+        int open (const ACE_Addr& local_sap,
+                  int reuse_addr = 0,
+                  int protocol_family = PF_UNSPEC,
+                  int backlog = ACE_DEFAULT_BACKLOG,
+                  int protocol = 0);
+};
+
 /**
  * WorldSocket.
  *
@@ -76,6 +89,12 @@ typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
  * The calls to Update () method are managed by WorldSocketMgr
  * and ReactorRunnable.
  *
+ * When Network.ReusePort is enabled the socket is accepted by
+ * and stays on one reactor thread for its whole life. SendPacket()
+ * then only pushes a copy of the packet to a lock-free queue and
+ * the owning thread alone encrypts it into the output buffer,
+ * so producers never contend on m_OutBufferLock.
+ *
  * For input ,the class uses one 1024 bytes buffer on stack
  * to which it does recv() calls. And then received data is
  * distributed where its needed. 1024 matches pretty well the
@@ -93,12 +112,16 @@ class WorldSocket : protected WorldHandler
     public:
         /// Declare some friends
         friend class ACE_Acceptor< WorldSocket, ACE_SOCK_ACCEPTOR >;
+        friend class ACE_Acceptor< WorldSocket, ReusePortSockAcceptor >;
         friend class WorldSocketMgr;
         friend class ReactorRunnable;
 
         /// Declare the acceptor for this class
         typedef ACE_Acceptor< WorldSocket, ACE_SOCK_ACCEPTOR > Acceptor;
 
+        /// Acceptor used when every network thread listens on its own (Network.ReusePort)
+        typedef ACE_Acceptor< WorldSocket, ReusePortSockAcceptor > ReusePortAcceptor;
+
         /// Mutex type used for various synchronizations.
         typedef ACE_Thread_Mutex LockType;
         typedef ACE_Guard<LockType> GuardType;
@@ -106,6 +129,9 @@ class WorldSocket : protected WorldHandler
         /// Queue for storing packets for which there is no space.
         typedef ACE_Unbounded_Queue< WorldPacket* > PacketQueueT;
 
+        /// Queue for packets sent from other threads to an owner-written socket.
+        typedef ACE_Based::MPSCQueue< WorldPacket* > OutPacketQueueT;
+
         /// Check if socket is closed.
         bool IsClosed (void) const;
 
@@ -181,6 +207,10 @@ class WorldSocket : protected WorldHandler
         /// to mark the socket for output).
         bool iFlushPacketQueue ();
 
+        /// Move packets queued by other threads to m_OutBuffer/m_PacketQueue
+        /// Only called by the owning reactor thread when m_OwnerWrites is set
+        void iDrainOutQueue ();
+
         // Use to check if custom chat only client can use such opcode
         static bool IsChatOpcode(uint16 opcode);
 
@@ -231,6 +261,13 @@ class WorldSocket : protected WorldHandler
         /// True if the socket is registered with the reactor for output
         bool m_OutActive;
 
+        /// True if only the owning reactor thread touches the output buffer,
+        /// SendPacket() then goes through m_OutQueue without locking.
+        bool m_OwnerWrites;
+
+        /// Packets sent to an owner-written socket, waiting for its reactor thread.
+        OutPacketQueueT m_OutQueue;
+
         uint32 m_Seed;
 
         uint8 operatingSystem; // stores client's operating system
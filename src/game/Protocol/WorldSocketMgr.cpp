@@ -212,7 +212,7 @@ WorldSocketMgr::WorldSocketMgr():
     m_SockOutKBuff(-1),
     m_SockOutUBuff(65536),
     m_UseNoDelay(true),
-    m_Acceptor(0)
+    m_ReusePort(false)
 {
 }
 
@@ -221,8 +221,8 @@ WorldSocketMgr::~WorldSocketMgr()
     if (m_NetThreads)
         delete [] m_NetThreads;
 
-    if(m_Acceptor)
-        delete m_Acceptor;
+    for (AcceptorList::iterator itr = m_Acceptors.begin(); itr != m_Acceptors.end(); ++itr)
+        delete *itr;
 }
 
 int WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
@@ -237,7 +237,18 @@ int WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
         return -1;
     }
 
-    m_NetThreadsCount = static_cast<size_t> (num_threads + 1);
+    m_ReusePort = sConfig.GetBoolDefault ("Network.ReusePort", false);
+
+#if !defined (SO_REUSEPORT)
+    if (m_ReusePort)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: Network.ReusePort is not supported on this platform, using single acceptor");
+        m_ReusePort = false;
+    }
+#endif
+
+    // with SO_REUSEPORT every network thread accepts on its own, no dedicated acceptor thread
+    m_NetThreadsCount = static_cast<size_t> (m_ReusePort ? num_threads : num_threads + 1);
 
     m_NetThreads = new ReactorRunnable[m_NetThreadsCount];
 
@@ -254,15 +265,34 @@ int WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
         return -1;
     }
 
-    WorldSocket::Acceptor* acc = new WorldSocket::Acceptor;
-    m_Acceptor = acc;
-
     ACE_INET_Addr listen_addr(port, address);
 
-    if (acc->open (listen_addr, m_NetThreads[0].GetReactor(), ACE_NONBLOCK) == -1)
+    if (m_ReusePort)
     {
-        sLog.outLog(LOG_DEFAULT, "ERROR: Failed to open acceptor, check if the port is free");
-        return -1;
+        for (size_t i = 0; i < m_NetThreadsCount; ++i)
+        {
+            WorldSocket::ReusePortAcceptor* acc = new WorldSocket::ReusePortAcceptor;
+            m_Acceptors.push_back(acc);
+
+            if (acc->open (listen_addr, m_NetThreads[i].GetReactor(), ACE_NONBLOCK) == -1)
+            {
+                sLog.outLog(LOG_DEFAULT, "ERROR: Failed to open acceptor %u, check if the port is free", uint32(i));
+                return -1;
+            }
+        }
+
+        sLog.outBasic ("Network.ReusePort: %u network threads accepting on their own", uint32(m_NetThreadsCount));
+    }
+    else
+    {
+        WorldSocket::Acceptor* acc = new WorldSocket::Acceptor;
+        m_Acceptors.push_back(acc);
+
+        if (acc->open (listen_addr, m_NetThreads[0].GetReactor(), ACE_NONBLOCK) == -1)
+        {
+            sLog.outLog(LOG_DEFAULT, "ERROR: Failed to open acceptor, check if the port is free");
+            return -1;
+        }
     }
 
     for (size_t i = 0; i < m_NetThreadsCount; ++i)
@@ -284,11 +314,11 @@ int WorldSocketMgr::StartNetwork(ACE_UINT16 port, std::string& address)
 
 void WorldSocketMgr::StopNetwork()
 {
-    if (m_Acceptor)
+    for (AcceptorList::iterator itr = m_Acceptors.begin(); itr != m_Acceptors.end(); ++itr)
     {
-        WorldSocket::Acceptor* acc = dynamic_cast<WorldSocket::Acceptor*>(m_Acceptor);
-
-        if (acc)
+        if (WorldSocket::Acceptor* acc = dynamic_cast<WorldSocket::Acceptor*>(*itr))
+            acc->close();
+        else if (WorldSocket::ReusePortAcceptor* acc = dynamic_cast<WorldSocket::ReusePortAcceptor*>(*itr))
             acc->close();
     }
 
@@ -338,6 +368,19 @@ int WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
 
     sock->m_OutBufferSize = static_cast<size_t> (m_SockOutUBuff);
 
+    if (m_ReusePort)
+    {
+        // stay on the reactor that accepted us, its thread is the only writer of the socket
+        sock->m_OwnerWrites = true;
+
+        for (size_t i = 0; i < m_NetThreadsCount; ++i)
+            if (m_NetThreads[i].GetReactor() == sock->reactor())
+                return m_NetThreads[i].AddSocket (sock);
+
+        sLog.outLog(LOG_DEFAULT, "ERROR: WorldSocketMgr::OnSocketOpen: socket accepted by unknown reactor");
+        return -1;
+    }
+
     // we skip the Acceptor Thread
     size_t min = 1;
 
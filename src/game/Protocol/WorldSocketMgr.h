@@ -32,6 +32,7 @@
 #include <ace/Thread_Mutex.h>
 
 #include <string>
+#include <vector>
 
 class WorldSocket;
 class ReactorRunnable;
@@ -70,10 +71,14 @@ class WorldSocketMgr
         int m_SockOutUBuff;
         bool m_UseNoDelay;
 
+        /// One SO_REUSEPORT acceptor per network thread, sockets never leave the thread that accepted them
+        bool m_ReusePort;
+
         std::string m_addr;
         ACE_UINT16 m_port;
 
-        ACE_Event_Handler* m_Acceptor;
+        typedef std::vector<ACE_Event_Handler*> AcceptorList;
+        AcceptorList m_Acceptors;
 };
 
 #define sWorldSocketMgr WorldSocketMgr::Instance()
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "AuraTimerWheel.h"
+#include "Unit.h"
+#include "SpellMgr.h"
+#include "SpellAuras.h"
+#include "MapManager.h"
+
+#define AURA_TIMER_WHEEL_MASK       (AURA_TIMER_WHEEL_SLOTS - 1)
+#define AURA_TIMER_WHEEL_MAX_DELTA  ((1u << (AURA_TIMER_WHEEL_LEVELS * AURA_TIMER_WHEEL_SLOT_BITS)) - 1)
+
+std::atomic<uint32> AuraTimerWheel::s_statsGeneration(0);
+
+AuraTimerWheel::AuraTimerWheel() : m_time(0), m_tick(0), m_statsGeneration(s_statsGeneration.load(std::memory_order_relaxed))
+{
+}
+
+void AuraTimerWheel::Schedule(AuraTimerNode* node, uint32 delay)
+{
+    // round up, aura is never due before its deadline
+    uint64 deadline = m_time + delay + (1 << AURA_TIMER_WHEEL_RESOLUTION_BITS) - 1;
+    node->expires = uint32(deadline >> AURA_TIMER_WHEEL_RESOLUTION_BITS);
+    Insert(node);
+}
+
+void AuraTimerWheel::Insert(AuraTimerNode* node)
+{
+    // already passed, goes with the next processed tick
+    if (int32(node->expires - m_tick) < 0)
+        node->expires = m_tick;
+
+    uint32 delta = node->expires - m_tick;
+    if (delta > AURA_TIMER_WHEEL_MAX_DELTA)
+    {
+        // days ahead, unit will find it early and schedule the rest again
+        delta = AURA_TIMER_WHEEL_MAX_DELTA;
+        node->expires = m_tick + delta;
+    }
+
+    uint32 level = 0;
+    while (level + 1 < AURA_TIMER_WHEEL_LEVELS && delta >= (1u << ((level + 1) * AURA_TIMER_WHEEL_SLOT_BITS)))
+        ++level;
+
+    uint32 slot = (node->expires >> (level * AURA_TIMER_WHEEL_SLOT_BITS)) & AURA_TIMER_WHEEL_MASK;
+    m_slots[level][slot].push_back(node, AURA_TIMER_WHEEL);
+}
+
+uint32 AuraTimerWheel::Cascade(uint32 level)
+{
+    uint32 slot = (m_tick >> (level * AURA_TIMER_WHEEL_SLOT_BITS)) & AURA_TIMER_WHEEL_MASK;
+
+    // everything in this slot is now closer than one slot of the level, spread it below
+    AuraTimerList pending;
+    while (!m_slots[level][slot].empty())
+        pending.push_back(m_slots[level][slot].front(), AURA_TIMER_WHEEL);
+
+    while (!pending.empty())
+        Insert(pending.front());
+
+    return slot;
+}
+
+void AuraTimerWheel::Fire(AuraTimerList& slot)
+{
+    while (!slot.empty())
+    {
+        AuraTimerNode* node = slot.front();
+        node->aura->GetTarget()->GetDueAuras().push_back(node, AURA_TIMER_DUE);
+    }
+}
+
+void AuraTimerWheel::Advance(uint32 diff)
+{
+    uint32 generation = s_statsGeneration.load(std::memory_order_relaxed);
+    if (m_statsGeneration != generation)
+    {
+        m_stats = AuraUpdateStats();
+        m_statsGeneration = generation;
+    }
+
+    m_time += diff;
+
+    uint32 now = uint32(m_time >> AURA_TIMER_WHEEL_RESOLUTION_BITS);
+    while (int32(now - m_tick) >= 0)
+    {
+        uint32 slot = m_tick & AURA_TIMER_WHEEL_MASK;
+        if (!slot)
+        {
+            for (uint32 level = 1; level < AURA_TIMER_WHEEL_LEVELS; ++level)
+                if (Cascade(level))
+                    break;
+        }
+
+        Fire(m_slots[0][slot]);
+        ++m_tick;
+    }
+}
+
+AuraUpdateStats AuraTimerWheel::GetTotalStats()
+{
+    AuraUpdateStats total;
+    for (MapManager::MapMapType::const_iterator itr = sMapMgr.Maps().begin(); itr != sMapMgr.Maps().end(); ++itr)
+    {
+        AuraUpdateStats const& stats = itr->second->GetAuraTimerWheel().GetStats();
+        total.updates += stats.updates;
+        total.present += stats.present;
+        total.touched += stats.touched;
+    }
+
+    return total;
+}
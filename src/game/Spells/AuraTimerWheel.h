@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _AURA_TIMER_WHEEL_H
+#define _AURA_TIMER_WHEEL_H
+
+#include "Common.h"
+
+#include <atomic>
+
+class Aura;
+
+enum AuraTimerState
+{
+    AURA_TIMER_NONE         = 0,                            // not linked, timed aura of unit out of world
+    AURA_TIMER_TICKING      = 1,                            // in Unit::m_tickingAuras, updated every unit update
+    AURA_TIMER_WHEEL        = 2,                            // waits in map's AuraTimerWheel
+    AURA_TIMER_DUE          = 3,                            // in Unit::m_dueAuras, deadline passed
+    AURA_TIMER_PROCESSING   = 4                             // being updated by Unit::_UpdateSpells
+};
+
+// intrusive link of Aura, one list at a time
+struct AuraTimerNode
+{
+    AuraTimerNode() : prev(this), next(this), aura(NULL), expires(0), state(AURA_TIMER_NONE) {}
+    ~AuraTimerNode() { Unlink(); }
+
+    void Unlink()
+    {
+        prev->next = next;
+        next->prev = prev;
+        prev = next = this;
+        state = AURA_TIMER_NONE;
+    }
+
+    AuraTimerNode* prev;
+    AuraTimerNode* next;
+    Aura* aura;
+    uint32 expires;                                         // wheel tick, AURA_TIMER_WHEEL only
+    uint8 state;
+};
+
+// circular list around a sentinel node, removal needs no access to the list
+class AuraTimerList
+{
+    public:
+        AuraTimerList() {}
+        ~AuraTimerList() { Clear(); }
+
+        bool empty() const { return m_head.next == &m_head; }
+        AuraTimerNode* front() const { return m_head.next; }
+        AuraTimerNode const* end() const { return &m_head; }
+
+        void push_back(AuraTimerNode* node, AuraTimerState state)
+        {
+            node->Unlink();
+            node->prev = m_head.prev;
+            node->next = &m_head;
+            m_head.prev->next = node;
+            m_head.prev = node;
+            node->state = state;
+        }
+
+        // unlinks all nodes, they stay valid
+        void Clear()
+        {
+            while (!empty())
+                front()->Unlink();
+        }
+
+    private:
+        AuraTimerList(const AuraTimerList&);
+        AuraTimerList& operator=(const AuraTimerList&);
+
+        AuraTimerNode m_head;
+};
+
+#define AURA_TIMER_WHEEL_RESOLUTION_BITS    5               // 32 ms per tick
+#define AURA_TIMER_WHEEL_SLOT_BITS          6
+#define AURA_TIMER_WHEEL_SLOTS              (1 << AURA_TIMER_WHEEL_SLOT_BITS)
+#define AURA_TIMER_WHEEL_LEVELS             4
+
+struct AuraUpdateStats
+{
+    AuraUpdateStats() : updates(0), present(0), touched(0) {}
+
+    uint64 updates;                                         // Unit::_UpdateSpells calls
+    uint64 present;                                         // auras held by updated units
+    uint64 touched;                                         // auras actually updated
+};
+
+/**
+ * Hierarchical timing wheel of aura deadlines, one per map.
+ *
+ * Aura whose next periodic tick or expiry is known ahead is parked here
+ * instead of being updated by its unit every tick. Level 0 holds the next 64
+ * ticks, each higher level 64 times more and cascades into the lower one when
+ * time reaches it. Deadline passed by Advance() moves the aura to its unit's
+ * due list, the unit updates it at its own next update and schedules it again.
+ * Map thread only.
+ */
+class AuraTimerWheel
+{
+    public:
+        AuraTimerWheel();
+
+        // schedule aura to be due after delay milliseconds of map time
+        void Schedule(AuraTimerNode* node, uint32 delay);
+
+        void Advance(uint32 diff);
+
+        // Unit::_UpdateSpells counters of this map
+        void RecordUpdate(uint32 present, uint32 touched)
+        {
+            ++m_stats.updates;
+            m_stats.present += present;
+            m_stats.touched += touched;
+        }
+
+        AuraUpdateStats const& GetStats() const { return m_stats; }
+
+        // summed over all maps, world thread
+        static AuraUpdateStats GetTotalStats();
+
+        // counters of every map are cleared at its next Advance()
+        static void ResetStats() { s_statsGeneration.fetch_add(1, std::memory_order_relaxed); }
+
+    private:
+        AuraTimerWheel(const AuraTimerWheel&);
+        AuraTimerWheel& operator=(const AuraTimerWheel&);
+
+        void Insert(AuraTimerNode* node);
+        uint32 Cascade(uint32 level);
+        void Fire(AuraTimerList& slot);
+
+        AuraTimerList m_slots[AURA_TIMER_WHEEL_LEVELS][AURA_TIMER_WHEEL_SLOTS];
+        uint64 m_time;                                      // map time in milliseconds
+        uint32 m_tick;                                      // next tick to process
+
+        AuraUpdateStats m_stats;
+        uint32 m_statsGeneration;
+
+        static std::atomic<uint32> s_statsGeneration;       // bumped by ResetStats()
+};
+
+#endif
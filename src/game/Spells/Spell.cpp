@@ -26,6 +26,7 @@
 #include "GridNotifiersImpl.h"
 #include "Opcodes.h"
 #include "Log.h"
+#include "Profiler.h"
 #include "UpdateMask.h"
 #include "World.h"
 #include "ObjectMgr.h"
@@ -1461,6 +1462,77 @@ void Spell::SearchChainTarget(std::list<Unit*> &TagUnitMap, float max_range, uin
     }
 }
 
+void MaNGOS::SpellNotifierCreatureAndPlayer::Check(Unit* target)
+{
+    if (!target->IsAlive() || (target->GetTypeId() == TYPEID_PLAYER && ((Player*)target)->IsTaxiFlying()))
+        return;
+
+    if (target->m_invisibilityMask && target->m_invisibilityMask & (1 << 10) && !i_caster->canDetectInvisibilityOf(target))
+        return;
+
+    switch (i_TargetType)
+    {
+        case SPELL_TARGETS_ALLY:
+            if (!target->isTargetableForAttack() || !i_caster->IsFriendlyTo(target))
+                return;
+            break;
+        case SPELL_TARGETS_ENEMY:
+        {
+            if (target->GetTypeId()==TYPEID_UNIT && (((Creature*)target)->isTotem() || target->GetCreatureType() == CREATURE_TYPE_CRITTER))
+                return;
+            if (!target->isTargetableForAttack())
+                return;
+
+            Unit* check = i_caster->GetCharmerOrOwnerOrSelf();
+
+            if (check->GetTypeId()==TYPEID_PLAYER)
+            {
+                if (check->IsFriendlyTo(target))
+                    return;
+            }
+            else
+            {
+                if (!check->IsHostileTo(target))
+                    return;
+            }
+        }break;
+        case SPELL_TARGETS_ENTRY:
+        {
+            if (target->GetEntry()!= i_entry)
+                return;
+        }break;
+        default: return;
+    }
+
+    switch (i_push_type)
+    {
+        case PUSH_IN_FRONT:
+            if (i_caster->isInFront(target, i_radius, M_PI/3))
+                i_data->push_back(target);
+            break;
+        case PUSH_IN_BACK:
+            if (i_caster->isInBack(target, i_radius, M_PI/3))
+                i_data->push_back(target);
+            break;
+        case PUSH_IN_LINE:
+            if (i_caster->isInLine(target, i_radius))
+                i_data->push_back(target);
+            break;
+        default:
+            if (i_TargetType != SPELL_TARGETS_ENTRY && i_push_type == PUSH_SRC_CENTER && i_caster) // if caster then check distance from caster to target (because of model collision)
+            {
+                if (i_caster->IsWithinDistInMap(target, i_radius))
+                    i_data->push_back(target);
+            }
+            else
+            {
+                if ((target->GetDistanceSq(i_x, i_y, i_z) < i_radiusSq))
+                    i_data->push_back(target);
+            }
+            break;
+    }
+}
+
 void Spell::SearchAreaTarget(std::list<Unit*> &TagUnitMap, float radius, const uint32 type, SpellTargets TargetType, uint32 entry, SpellScriptTargetType spellScriptTargetType)
 {
     float x, y, z;
@@ -1500,21 +1572,38 @@ void Spell::SearchAreaTarget(std::list<Unit*> &TagUnitMap, float radius, const u
 
     switch (spellScriptTargetType)
     {
-        case SPELL_TARGET_TYPE_NONE:
-        {
-            MaNGOS::SpellNotifierCreatureAndPlayer notifier(*this, TagUnitMap, radius, type, TargetType, entry, x, y, z);
-            Cell::VisitAllObjects(x, y, m_caster->GetMap(), notifier, radius);
-            if ((GetSpellEntry()->AttributesEx3 & SPELL_ATTR_EX3_PLAYERS_ONLY))
-                TagUnitMap.remove_if(MaNGOS::ObjectTypeIdCheck(TYPEID_PLAYER, false)); // above line will select also pets and totems, remove them
-            break;
-        }
         case SPELL_TARGET_TYPE_CREATURE:
-        {
             if (!entry)
                 break;
+            // no break
+        case SPELL_TARGET_TYPE_NONE:
+        {
+            if (!m_caster->GetMap())
+                break;
+
+            // candidates that would be removed below are not checked at all
+            bool playersOnly = spellScriptTargetType == SPELL_TARGET_TYPE_NONE && (GetSpellEntry()->AttributesEx3 & SPELL_ATTR_EX3_PLAYERS_ONLY);
 
             MaNGOS::SpellNotifierCreatureAndPlayer notifier(*this, TagUnitMap, radius, type, TargetType, entry, x, y, z);
-            Cell::VisitAllObjects(x, y, m_caster->GetMap(), notifier, radius);
+            if (!notifier.i_caster)
+                break;
+
+            UnitSearchIndex& index = m_caster->GetMap()->GetUnitSearchIndex();
+            UnitSearchResult candidates(index);
+            index.Query(*m_caster->GetMap(), x, y, radius, candidates.Units());
+
+            std::vector<Unit*> const& units = candidates.Units();
+            for (uint32 i = 0; i < units.size(); ++i)
+            {
+                Unit* unit = units[i];
+                if (unit->GetTypeId() != TYPEID_PLAYER && (playersOnly || ((Creature*)unit)->isTotem()))
+                    continue;
+
+                notifier.Check(unit);
+            }
+
+            if (playersOnly)
+                TagUnitMap.remove_if(MaNGOS::ObjectTypeIdCheck(TYPEID_PLAYER, false)); // above line will select also pets and totems, remove them
             break;
         }
         case SPELL_TARGET_TYPE_DEAD:
@@ -3065,6 +3154,8 @@ void Spell::SendSpellCooldown()
 
 void Spell::update(uint32 difftime)
 {
+    ProfileSumZone zone("Spell::update");
+
     // update pointers based at it's GUIDs
     UpdatePointers();
 
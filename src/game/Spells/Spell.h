@@ -762,77 +762,12 @@ namespace MaNGOS
                 return;
 
             for (typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
-            {
-                if (!itr->getSource()->IsAlive() || (itr->getSource()->GetTypeId() == TYPEID_PLAYER && ((Player*)itr->getSource())->IsTaxiFlying()))
-                    continue;
-
-                if (itr->getSource()->m_invisibilityMask && itr->getSource()->m_invisibilityMask & (1 << 10) && !i_caster->canDetectInvisibilityOf(itr->getSource()))
-                    continue;
-
-                switch (i_TargetType)
-                {
-                    case SPELL_TARGETS_ALLY:
-                        if (!itr->getSource()->isTargetableForAttack() || !i_caster->IsFriendlyTo(itr->getSource()))
-                            continue;
-                        break;
-                    case SPELL_TARGETS_ENEMY:
-                    {
-                        if (itr->getSource()->GetTypeId()==TYPEID_UNIT && (((Creature*)itr->getSource())->isTotem() || itr->getSource()->GetCreatureType() == CREATURE_TYPE_CRITTER))
-                            continue;
-                        if (!itr->getSource()->isTargetableForAttack())
-                            continue;
-
-                        Unit* check = i_caster->GetCharmerOrOwnerOrSelf();
-
-                        if (check->GetTypeId()==TYPEID_PLAYER)
-                        {
-                            if (check->IsFriendlyTo(itr->getSource()))
-                                continue;
-                        }
-                        else
-                        {
-                            if (!check->IsHostileTo(itr->getSource()))
-                                continue;
-                        }
-                    }break;
-                    case SPELL_TARGETS_ENTRY:
-                    {
-                        if (itr->getSource()->GetEntry()!= i_entry)
-                            continue;
-                    }break;
-                    default: continue;
-                }
-
-                switch (i_push_type)
-                {
-                    case PUSH_IN_FRONT:
-                        if (i_caster->isInFront((Unit*)(itr->getSource()), i_radius, M_PI/3))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_IN_BACK:
-                        if (i_caster->isInBack((Unit*)(itr->getSource()), i_radius, M_PI/3))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_IN_LINE:
-                        if (i_caster->isInLine((Unit*)(itr->getSource()), i_radius))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    default:
-                        if (i_TargetType != SPELL_TARGETS_ENTRY && i_push_type == PUSH_SRC_CENTER && i_caster) // if caster then check distance from caster to target (because of model collision)
-                        {
-                            if (i_caster->IsWithinDistInMap(itr->getSource(), i_radius))
-                                i_data->push_back(itr->getSource());
-                        }
-                        else
-                        {
-                            if ((itr->getSource()->GetDistanceSq(i_x, i_y, i_z) < i_radiusSq))
-                                i_data->push_back(itr->getSource());
-                        }
-                        break;
-                }
-            }
+                Check(itr->getSource());
         }
 
+        // pushes target if it passes all checks
+        void Check(Unit* target);
+
         #ifdef WIN32
         template<> inline void Visit(CorpseMapType &) {}
         template<> inline void Visit(GameObjectMapType &) {}
@@ -325,10 +325,12 @@ m_timeCla(1000), m_castItemGuid(castItem?castItem->GetGUID():0), m_auraSlot(MAX_
 m_positive(false), m_permanent(false), m_isPeriodic(false), m_isAreaAura(false),
 m_isPersistent(false), m_removeMode(AURA_REMOVE_BY_DEFAULT), m_isRemovedOnShapeLost(true), m_in_use(false),
 m_periodicTimer(0), m_amplitude(0), m_PeriodicEventId(0), m_AuraDRGroup(DIMINISHING_NONE), m_heartbeatTimer(0)
-,m_tickNumber(0)
+,m_tickNumber(0), m_syncClock(0), m_timed(false)
 {
     ASSERT(target);
 
+    m_timerNode.aura = this;
+
     ASSERT(spellproto && spellproto == sSpellStore.LookupEntry(spellproto->Id) && "`info` must be pointer to sSpellStore element");
 
     m_spellProto = spellproto;
@@ -547,6 +549,176 @@ void Aura::SetModifier(AuraType t, int32 a, uint32 pt, int32 miscValue)
     m_modifier.periodictime = pt;
 }
 
+int32 Aura::GetElapsed() const
+{
+    if (!m_timed)
+        return 0;
+
+    return int32(m_target->GetAuraClock() - m_syncClock);
+}
+
+int32 Aura::GetAuraDuration() const
+{
+    if (m_duration <= 0)
+        return m_duration;
+
+    int32 duration = m_duration - GetElapsed();
+    return duration > 0 ? duration : 0;
+}
+
+void Aura::SetAuraDuration(int32 duration)
+{
+    SyncTimers();
+
+    m_duration = duration;
+    if (duration<0)
+        m_permanent=true;
+    else
+        m_permanent=false;
+
+    Reschedule();
+}
+
+int32 Aura::GetPeriodicTimer() const
+{
+    // same condition as in Update()
+    if (m_isPeriodic && (GetAuraDuration() >= 0 || m_isPassive || m_permanent))
+        return m_periodicTimer - GetElapsed();
+
+    return m_periodicTimer;
+}
+
+void Aura::SetPeriodicTimer(int32 timer)
+{
+    SyncTimers();
+    m_periodicTimer = timer;
+    Reschedule();
+}
+
+void Aura::SetLoadedState(uint64 caster_guid,int32 damage,int32 maxduration,int32 duration,int32 charges)
+{
+    SyncTimers();
+
+    m_caster_guid = caster_guid;
+    m_modifier.m_amount = damage;
+    m_maxduration = maxduration;
+    m_duration = duration;
+    m_procCharges = charges;
+
+    Reschedule();
+}
+
+bool Aura::CanUseTimerWheel() const
+{
+    // own Update() implementations
+    if (m_isAreaAura || m_isPersistent)
+        return false;
+
+    // distance to caster checked every update, heartbeat resist rolled at any time
+    if (SpellMgr::IsChanneledSpell(m_spellProto) || m_heartbeatTimer)
+        return false;
+
+    // Scalding Water, removed by position
+    if (GetId() == 37284)
+        return false;
+
+    // mana per second drained every second
+    if (GetEffIndex() == 0 && (m_spellProto->manaPerSecond || m_spellProto->manaPerSecondPerLevel))
+        return false;
+
+    // regen auras reapply themselves and tick while the target is not at full health/power
+    switch (m_modifier.m_auraname)
+    {
+        case SPELL_AURA_MOD_REGEN:
+        case SPELL_AURA_MOD_POWER_REGEN:
+        case SPELL_AURA_OBS_MOD_HEALTH:
+        case SPELL_AURA_OBS_MOD_MANA:
+            return false;
+        default:
+            break;
+    }
+
+    return true;
+}
+
+void Aura::SetTimed(bool timed)
+{
+    if (m_timed == timed)
+        return;
+
+    SyncTimers();
+    m_syncClock = m_target->GetAuraClock();
+    m_timed = timed;
+
+    if (timed)
+        Reschedule();
+    else
+        m_timerNode.Unlink();
+}
+
+void Aura::SyncTimers()
+{
+    if (!m_timed)
+        return;
+
+    int32 elapsed = GetElapsed();
+    if (elapsed <= 0)
+        return;
+
+    m_syncClock = m_target->GetAuraClock();
+
+    // what Update() would have done for the skipped ticks, with no periodic tick or expiry among them
+    if (m_duration > 0)
+    {
+        m_duration -= elapsed;
+        if (m_duration < 0)
+            m_duration = 0;
+    }
+
+    if (m_isPeriodic && (m_duration >= 0 || m_isPassive || m_permanent))
+        m_periodicTimer -= elapsed;
+}
+
+int32 Aura::GetDueDelay() const
+{
+    int32 duration = GetAuraDuration();
+    int32 delay = -1;
+
+    if (duration > 0)
+        delay = duration;
+    else if (IsExpired())
+        delay = 0;
+
+    if (m_isPeriodic && (duration >= 0 || m_isPassive || m_permanent))
+    {
+        int32 timer = GetPeriodicTimer();
+        if (timer < 0)
+            timer = 0;
+
+        if (delay < 0 || timer < delay)
+            delay = timer;
+    }
+
+    return delay;
+}
+
+void Aura::Reschedule()
+{
+    // Unit::_UpdateSpells schedules it once done
+    if (!m_timed || m_timerNode.state == AURA_TIMER_PROCESSING)
+        return;
+
+    int32 delay = GetDueDelay();
+    if (delay < 0 || !m_target->IsInWorld())
+    {
+        // nothing to wait for, or Unit::AddToWorld will schedule it
+        m_timerNode.Unlink();
+        return;
+    }
+
+    m_target->GetMap()->GetAuraTimerWheel().Schedule(&m_timerNode, uint32(delay));
+}
+
 void Aura::Update(uint32 diff)
 {
     if (!m_target)
@@ -907,10 +1079,15 @@ void Aura::ApplyModifier(bool apply, bool Real)
 
     AuraType aura = m_modifier.m_auraname;
 
+    // handlers work with m_duration and m_periodicTimer directly
+    SyncTimers();
+
     m_in_use = true;
     if (aura<TOTAL_AURAS)
         (*this.*AuraHandler [aura])(apply,Real);
     m_in_use = false;
+
+    Reschedule();
 }
 
 void Aura::UpdateAuraDuration()
@@ -923,7 +1100,7 @@ void Aura::UpdateAuraDuration()
         WorldPacket data;
         data.Initialize(SMSG_UPDATE_AURA_DURATION, 1+4);
         data << (uint8)m_auraSlot;
-        data << (uint32)m_duration;
+        data << (uint32)GetAuraDuration();
         ((Player *)m_target)->SendPacketToSelf(&data);
 
         data.Initialize(SMSG_SET_EXTRA_AURA_INFO, (8+1+4+4+4));
@@ -1805,7 +1982,7 @@ void Aura::TriggerSpell()
                     // Invisibility
                     case 66:
                     {
-                        if (!m_duration)
+                        if (!GetAuraDuration())
                             m_target->CastSpell(m_target, 32612, true, NULL, this);
                         else if (m_tickNumber < 5)
                             m_target->getHostileRefManager().addThreatPercent(-(int32)(100/(6-m_tickNumber)));
@@ -6499,7 +6676,7 @@ void Aura::HandleAuraRetainComboPoints(bool apply, bool Real)
 
     // combo points was added in SPELL_EFFECT_ADD_COMBO_POINTS handler
     // remove only if aura expire by time (in case combo points amount change aura removed without combo points lost)
-    if (!apply && m_duration==0 && target->GetComboTarget())
+    if (!apply && GetAuraDuration()==0 && target->GetComboTarget())
         if (Unit* unit = m_target->GetMap()->GetUnit(target->GetComboTarget()))
             target->AddComboPoints(unit, -GetModifierValue());
 }
@@ -7493,7 +7670,7 @@ void Aura::PeriodicDummyTick()
                 m_target->CastSpell(m_target, 43310, true);
             }
 
-            if((m_maxduration - m_duration) >= 8000
+            if((m_maxduration - GetAuraDuration()) >= 8000
                 && (((Player*)m_target)->GetQuestStatus(11318) == QUEST_STATUS_INCOMPLETE || ((Player*)m_target)->GetQuestStatus(11409) == QUEST_STATUS_INCOMPLETE))
             {
                 m_target->CastSpell(m_target, 43345, true);
@@ -7517,7 +7694,7 @@ void Aura::PeriodicDummyTick()
                 m_target->CastSpell(m_target, 42992, true);
             }
 
-            if((m_maxduration - m_duration) >= 8000
+            if((m_maxduration - GetAuraDuration()) >= 8000
                 && (((Player*)m_target)->GetQuestStatus(11318) == QUEST_STATUS_INCOMPLETE || ((Player*)m_target)->GetQuestStatus(11409) == QUEST_STATUS_INCOMPLETE))
             {
                 m_target->CastSpell(m_target, 43346, true);
@@ -7548,7 +7725,7 @@ void Aura::PeriodicDummyTick()
                 m_target->CastSpell(m_target, 42993, true);
             }
 
-            if((m_maxduration - m_duration) >= 8000
+            if((m_maxduration - GetAuraDuration()) >= 8000
                 && (((Player*)m_target)->GetQuestStatus(11318) == QUEST_STATUS_INCOMPLETE || ((Player*)m_target)->GetQuestStatus(11409) == QUEST_STATUS_INCOMPLETE))
             {
                 m_target->CastSpell(m_target, 43347, true);
@@ -22,6 +22,7 @@
 #define _SPELLAURAS_H
 
 #include "SpellAuraDefines.h"
+#include "AuraTimerWheel.h"
 
 struct DamageManaShield
 {
@@ -242,15 +243,8 @@ class Aura
 
         int32 GetAuraMaxDuration() const { return m_maxduration; }
         void SetAuraMaxDuration(int32 duration) { m_maxduration = duration; }
-        int32 GetAuraDuration() const { return m_duration; }
-        void SetAuraDuration(int32 duration)
-        {
-            m_duration = duration;
-            if (duration<0)
-                m_permanent=true;
-            else
-                m_permanent=false;
-        }
+        int32 GetAuraDuration() const;
+        void SetAuraDuration(int32 duration);
         time_t GetAuraApplyTime() { return m_applyTime; }
 
         bool IsExpired() const { return !GetAuraDuration() && !(IsPermanent() || IsPassive()); }
@@ -263,14 +257,7 @@ class Aura
         Unit* GetCaster() const;
         Unit* GetTarget() const { return m_target ? m_target : NULL; }
         void SetTarget(Unit* target) { m_target = target; }
-        void SetLoadedState(uint64 caster_guid,int32 damage,int32 maxduration,int32 duration,int32 charges)
-        {
-            m_caster_guid = caster_guid;
-            m_modifier.m_amount = damage;
-            m_maxduration = maxduration;
-            m_duration = duration;
-            m_procCharges = charges;
-        }
+        void SetLoadedState(uint64 caster_guid,int32 damage,int32 maxduration,int32 duration,int32 charges);
 
         uint8 GetAuraSlot() const { return m_auraSlot; }
         void SetAuraSlot(uint8 slot) { m_auraSlot = slot; }
@@ -363,8 +350,21 @@ class Aura
 
         int32 GetStackAmount() const { return m_stackAmount; }
         void SetStackAmount(int32 amount) { m_stackAmount = amount; }
-        int32 GetPeriodicTimer() const { return m_periodicTimer; }
-        void SetPeriodicTimer(int32 timer) { m_periodicTimer = timer; }
+        int32 GetPeriodicTimer() const;
+        void SetPeriodicTimer(int32 timer);
+
+        // timed aura is not updated every tick, unit's AuraTimerWheel wakes it at next periodic tick or expiry
+        bool CanUseTimerWheel() const;
+        bool IsTimed() const { return m_timed; }
+        void SetTimed(bool timed);
+        AuraTimerNode& GetTimerNode() { return m_timerNode; }
+
+        // apply time passed on target's aura clock since last sync to duration and periodic timer
+        void SyncTimers();
+        // put timed aura back to the wheel after its timers were changed
+        void Reschedule();
+        // milliseconds to next periodic tick or expiry, -1 when there is none
+        int32 GetDueDelay() const;
 
         // Single cast aura helpers
         void UnregisterSingleCastAura();
@@ -412,7 +412,13 @@ class Aura
         CasterModifiers m_casterModifiers;
 
         int32 m_stackAmount;
+
+        AuraTimerNode m_timerNode;
+        uint32 m_syncClock;                                 // target's aura clock m_duration and m_periodicTimer are valid at
+        bool m_timed;
     private:
+        int32 GetElapsed() const;
+
         void SetAura(uint32 slot, bool remove) { m_target->SetUInt32Value(UNIT_FIELD_AURA + slot, remove ? 0 : GetId()); }
         void SetAuraFlag(uint32 slot, bool add);
         void SetAuraLevel(uint32 slot, uint32 level);
@@ -1357,7 +1357,8 @@ bool SpellMgr::IsAffectedBySpell(SpellEntry const *spellInfo, uint32 spellId, ui
     if (!spellInfo)
         return false;
 
-    SpellEntry const *affect_spell = sSpellStore.LookupEntry(spellId);
+    SpellHotInfo const* affect_info = GetSpellHotInfo(spellId);
+    SpellEntry const *affect_spell = affect_info ? affect_info->entry : sSpellStore.LookupEntry(spellId);
     // false for affect_spell == NULL
     if (!affect_spell)
         return false;
@@ -1373,7 +1374,7 @@ bool SpellMgr::IsAffectedBySpell(SpellEntry const *spellInfo, uint32 spellId, ui
     if (!familyFlags)
     {
         // Get it from spellAffect table
-        familyFlags = GetSpellAffectMask(spellId,effectId);
+        familyFlags = affect_info && effectId < 3 ? affect_info->affectMask[effectId] : GetSpellAffectMask(spellId,effectId);
         // false if familyFlags == 0
         if (!familyFlags)
             return false;
@@ -1757,6 +1758,39 @@ void SpellMgr::LoadSpellBonusData()
     sLog.outString(">> Loaded %u spell bonus data definitions", count);
 }
 
+void SpellMgr::LoadSpellHotInfo()
+{
+    mSpellHotInfo.assign(sSpellStore.GetNumRows(), SpellHotInfo());
+
+    uint32 count = 0;
+    for (uint32 id = 0; id < mSpellHotInfo.size(); ++id)
+    {
+        SpellHotInfo& info = mSpellHotInfo[id];
+        info.entry = sSpellStore.LookupEntry(id);
+        if (!info.entry)
+            continue;
+
+        SpellProcEventMap::const_iterator proc = mSpellProcEventMap.find(id);
+        info.procEvent = proc != mSpellProcEventMap.end() ? &proc->second : NULL;
+
+        SpellChainMap::const_iterator chain = mSpellChains.find(id);
+        info.chainNode = chain != mSpellChains.end() ? &chain->second : NULL;
+
+        for (uint8 effectId = 0; effectId < 3; ++effectId)
+        {
+            SpellAffectMap::const_iterator affect = mSpellAffectMap.find((id<<8) + effectId);
+            info.affectMask[effectId] = affect != mSpellAffectMap.end() ? affect->second : 0;
+        }
+
+        SpellElixirMap::const_iterator elixir = mSpellElixirs.find(id);
+        info.elixirMask = elixir != mSpellElixirs.end() ? elixir->second : 0;
+
+        ++count;
+    }
+
+    sLog.outString(">> Built hot spell info of %u spells (%u KB)", count, uint32(mSpellHotInfo.size() * sizeof(SpellHotInfo) / 1024));
+}
+
 void SpellMgr::LoadSpellEnchantProcData()
 {
     mSpellEnchantProcEventMap.clear();                             // need for reload case
@@ -5022,6 +5056,9 @@ bool SpellMgr::CanSpellCrit(const SpellEntry* spellInfo)
 
 uint64 SpellMgr::GetSpellAffectMask(uint16 spellId, uint8 effectId) const
 {
+    if (SpellHotInfo const* info = GetSpellHotInfo(spellId))
+        return effectId < 3 ? info->affectMask[effectId] : 0;
+
     SpellAffectMap::const_iterator itr = mSpellAffectMap.find((spellId<<8) + effectId);
     if (itr != mSpellAffectMap.end())
         return itr->second;
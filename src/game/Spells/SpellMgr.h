@@ -420,6 +420,17 @@ enum AttributesCu
 
 typedef std::map<int32, std::vector<int32> > SpellLinkedMap;
 
+// data of one spell id from tables looked up on every cast, aura stacking and proc check,
+// kept in one array indexed by spell id instead of separate maps
+struct SpellHotInfo
+{
+    SpellEntry const* entry;                                // NULL if spell id is not in Spell.dbc
+    SpellProcEventEntry const* procEvent;                   // spell_proc_event
+    SpellChainNode const* chainNode;                        // spell_chain
+    uint64 affectMask[3];                                   // spell_affect, per effect
+    uint8 elixirMask;                                       // spell_elixir
+};
+
 extern bool IsAreaEffectTarget[MAX_SPELL_TARGETS];
 
 class SpellMgr
@@ -442,8 +453,17 @@ class SpellMgr
 
         SpellElixirMap const& GetSpellElixirMap() const { return mSpellElixirs; }
 
+        // NULL before LoadSpellHotInfo() and for ids out of Spell.dbc range
+        SpellHotInfo const* GetSpellHotInfo(uint32 spellId) const
+        {
+            return spellId < mSpellHotInfo.size() ? &mSpellHotInfo[spellId] : NULL;
+        }
+
         uint32 GetSpellElixirMask(uint32 spellid) const
         {
+            if (SpellHotInfo const* info = GetSpellHotInfo(spellid))
+                return info->elixirMask;
+
             SpellElixirMap::const_iterator itr = mSpellElixirs.find(spellid);
             if (itr==mSpellElixirs.end())
                 return 0x0;
@@ -467,6 +487,9 @@ class SpellMgr
         // Spell proc events
         SpellProcEventEntry const* GetSpellProcEvent(uint32 spellId) const
         {
+            if (SpellHotInfo const* info = GetSpellHotInfo(spellId))
+                return info->procEvent;
+
             SpellProcEventMap::const_iterator itr = mSpellProcEventMap.find(spellId);
             if (itr != mSpellProcEventMap.end())
                 return &itr->second;
@@ -495,6 +518,9 @@ class SpellMgr
         // Spell ranks chains
         SpellChainNode const* GetSpellChainNode(uint32 spell_id) const
         {
+            if (SpellHotInfo const* info = GetSpellHotInfo(spell_id))
+                return info->chainNode;
+
             SpellChainMap::const_iterator itr = mSpellChains.find(spell_id);
             if (itr == mSpellChains.end())
                 return NULL;
@@ -567,17 +593,17 @@ class SpellMgr
 
         uint8 IsHighRankOfSpell(uint32 spell1,uint32 spell2) const
         {
-            SpellChainMap::const_iterator itr = mSpellChains.find(spell1);
+            SpellChainNode const* node = GetSpellChainNode(spell1);
 
             uint32 rank2 = GetSpellRank(spell2);
 
             // not ordered correctly by rank value
-            if (itr == mSpellChains.end() || !rank2 || itr->second.rank <= rank2)
+            if (!node || !rank2 || node->rank <= rank2)
                 return false;
 
             // check present in same rank chain
-            for (; itr != mSpellChains.end(); itr = mSpellChains.find(itr->second.prev))
-                if (itr->second.prev==spell2)
+            for (; node; node = GetSpellChainNode(node->prev))
+                if (node->prev==spell2)
                     return true;
 
             return false;
@@ -795,6 +821,8 @@ class SpellMgr
         void LoadSpellLinked();
         void LoadSpellEnchantProcData();
         void LoadSpellBonusData();
+        // must be repeated after reload of any table kept in SpellHotInfo
+        void LoadSpellHotInfo();
 
     private:
         SpellScriptTarget  mSpellScriptTarget;
@@ -812,6 +840,7 @@ class SpellMgr
         SpellLinkedMap      mSpellLinkedMap;
         SpellEnchantProcEventMap     mSpellEnchantProcEventMap;
         SpellBonusDataMap    mSpellBonusDataMap;
+        std::vector<SpellHotInfo> mSpellHotInfo;            // indexed by spell id
 };
 
 #define sSpellMgr (*ACE_Singleton<SpellMgr, ACE_Null_Mutex >::instance())
@@ -29,6 +29,8 @@
 #include "UnitEvents.h"
 #include "Spell.h"
 
+#include <algorithm>
+
 //==============================================================
 //================= ThreatCalcHelper ===========================
 //==============================================================
@@ -57,6 +59,7 @@ HostileReference::HostileReference(Unit* pUnit, ThreatManager *pThreatManager, f
 {
     iThreat = pThreat;
     iTempThreatModifyer = 0.0f;
+    iHeapIndex = uint32(-1);
     link(pUnit, pThreatManager);
     iUnitGuid = pUnit->GetGUID();
     iOnline = true;
@@ -209,12 +212,106 @@ Unit* HostileReference::getSourceUnit()
 
 void ThreatContainer::clearReferences()
 {
-    for (std::list<HostileReference*>::iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
+    // unlink may fire events back at the owner, so detach everything first
+    std::vector<HostileReference*> refs;
+    refs.swap(iThreatHeap);
+    iThreatList.clear();
+    iDirty = false;
+
+    for (std::vector<HostileReference*>::iterator i = refs.begin(); i != refs.end(); ++i)
     {
+        (*i)->iHeapIndex = uint32(-1);
         (*i)->unlink();
         delete (*i);
     }
-    iThreatList.clear();
+}
+
+//============================================================
+
+void ThreatContainer::addReference(HostileReference* pHostileReference)
+{
+    if (contains(pHostileReference))
+        return;
+
+    pHostileReference->iListPos = iThreatList.insert(iThreatList.end(), pHostileReference);
+    iThreatHeap.push_back(NULL);
+    heapSet(iThreatHeap.size() - 1, pHostileReference);
+    siftUp(iThreatHeap.size() - 1);
+    iDirty = true;
+}
+
+//============================================================
+
+void ThreatContainer::remove(HostileReference* pRef)
+{
+    if (!contains(pRef))
+        return;
+
+    uint32 index = pRef->iHeapIndex;
+    HostileReference* last = iThreatHeap.back();
+    iThreatHeap.pop_back();
+    if (last != pRef)
+    {
+        heapSet(index, last);
+        siftUp(index);
+        siftDown(last->iHeapIndex);
+    }
+
+    iThreatList.erase(pRef->iListPos);
+    pRef->iHeapIndex = uint32(-1);
+}
+
+//============================================================
+
+void ThreatContainer::threatChanged(HostileReference* pRef)
+{
+    if (!contains(pRef))
+        return;
+
+    siftUp(pRef->iHeapIndex);
+    siftDown(pRef->iHeapIndex);
+    iDirty = true;
+}
+
+//============================================================
+
+void ThreatContainer::siftUp(uint32 index)
+{
+    HostileReference* ref = iThreatHeap[index];
+    while (index > 0)
+    {
+        uint32 parent = (index - 1) / 2;
+        if (iThreatHeap[parent]->getThreat() >= ref->getThreat())
+            break;
+
+        heapSet(index, iThreatHeap[parent]);
+        index = parent;
+    }
+    heapSet(index, ref);
+}
+
+//============================================================
+
+void ThreatContainer::siftDown(uint32 index)
+{
+    HostileReference* ref = iThreatHeap[index];
+    uint32 size = iThreatHeap.size();
+    for (;;)
+    {
+        uint32 child = 2 * index + 1;
+        if (child >= size)
+            break;
+
+        if (child + 1 < size && iThreatHeap[child + 1]->getThreat() > iThreatHeap[child]->getThreat())
+            ++child;
+
+        if (ref->getThreat() >= iThreatHeap[child]->getThreat())
+            break;
+
+        heapSet(index, iThreatHeap[child]);
+        index = child;
+    }
+    heapSet(index, ref);
 }
 
 //============================================================
@@ -226,7 +323,7 @@ HostileReference* ThreatContainer::getReferenceByTarget(Unit* pVictim)
         return NULL;
 
     uint64 guid = pVictim->GetGUID();
-    for (std::list<HostileReference*>::iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
+    for (std::vector<HostileReference*>::iterator i = iThreatHeap.begin(); i != iThreatHeap.end(); ++i)
     {
         if ((*i)->getUnitGuid() == guid)
         {
@@ -274,7 +371,7 @@ bool HostileReferenceSortPredicate(const HostileReference* lhs, const HostileRef
 }
 
 //============================================================
-// Check if the list is dirty and sort if necessary
+// Check if the list is dirty and sort if necessary, the heap itself is always in order
 
 void ThreatContainer::update()
 {
@@ -350,18 +447,47 @@ bool DropAggro(Creature* pAttacker, Unit * target)
 // return the next best victim
 // could be the current victim
 
+// orders heap positions by threat of the reference stored there
+struct HeapIndexThreatLess
+{
+    explicit HeapIndexThreatLess(std::vector<HostileReference*> const& heap) : heap(heap) {}
+
+    bool operator()(uint32 lhs, uint32 rhs) const { return heap[lhs]->getThreat() < heap[rhs]->getThreat(); }
+
+    std::vector<HostileReference*> const& heap;
+};
+
 HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, HostileReference* pCurrentVictim)
 {
     HostileReference* currentRef = NULL;
     bool found = false;
     bool noPriorityTargetFound = false;
 
-    std::list<HostileReference*>::iterator lastRef = iThreatList.end();
-    lastRef--;
+    // walk references from highest threat down; children of a heap node are only
+    // queued once the node is visited, so usually just the top few are touched
+    HostileReference* const* heap = iThreatHeap.empty() ? NULL : &iThreatHeap[0];
+    uint32 size = iThreatHeap.size();
+    uint32 visited = 0;
+    HeapIndexThreatLess visitOrder(iThreatHeap);
 
-    for (std::list<HostileReference*>::iterator iter = iThreatList.begin(); iter != iThreatList.end() && !found;)
+    iVisitQueue.clear();
+    if (size)
+        iVisitQueue.push_back(0);
+
+    while (!iVisitQueue.empty())
     {
-        currentRef = (*iter);
+        std::pop_heap(iVisitQueue.begin(), iVisitQueue.end(), visitOrder);
+        uint32 index = iVisitQueue.back();
+        iVisitQueue.pop_back();
+
+        for (uint32 child = 2 * index + 1; child < size && child <= 2 * index + 2; ++child)
+        {
+            iVisitQueue.push_back(child);
+            std::push_heap(iVisitQueue.begin(), iVisitQueue.end(), visitOrder);
+        }
+        ++visited;
+
+        currentRef = heap[index];
 
         Unit* target = currentRef->getTarget();
         ASSERT(target);                                     // if the ref has status online the target must be there !
@@ -369,19 +495,20 @@ HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, Hostile
         // some units are preferred in comparison to others
         if (!noPriorityTargetFound && DropAggro(pAttacker, target))
         {
-            if (iter != lastRef)
+            if (visited < size)
             {
                 // current victim is a second choice target, so don't compare threat with it below
                 if (currentRef == pCurrentVictim)
                     pCurrentVictim = NULL;
-                ++iter;
                 continue;
             }
             else
             {
                 // if we reached to this point, everyone in the threatlist is a second choice target. In such a situation the target with the highest threat should be attacked.
                 noPriorityTargetFound = true;
-                iter = iThreatList.begin();
+                visited = 0;
+                iVisitQueue.clear();
+                iVisitQueue.push_back(0);
                 continue;
             }
         }
@@ -390,7 +517,7 @@ HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, Hostile
         {
             if (pCurrentVictim)                              // select 1.3/1.1 better target in comparison current target
             {
-                // list sorted and and we check current target, then this is best case
+                // visited in threat order and we check current target, then this is best case
                 if (pCurrentVictim == currentRef || currentRef->getThreat() <= 1.1f * pCurrentVictim->getThreat())
                 {
                     currentRef = pCurrentVictim;            // for second case
@@ -411,7 +538,6 @@ HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, Hostile
                 break;
             }
         }
-        ++iter;
     }
     if (!found)
         currentRef = NULL;
@@ -507,7 +633,6 @@ void ThreatManager::modifyThreatPercent(Unit *pVictim, int32 pPercent)
 
 Unit* ThreatManager::getHostilTarget()
 {
-    iThreatContainer.update();
     HostileReference* nextVictim = iThreatContainer.selectNextVictim((Creature*) getOwner(), getCurrentVictim());
     setCurrentVictim(nextVictim);
     return getCurrentVictim() != NULL ? getCurrentVictim()->getTarget() : NULL;
@@ -571,35 +696,30 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
     switch(threatRefStatusChangeEvent->getType())
     {
         case UEV_THREAT_REF_THREAT_CHANGE:
-            if ((getCurrentVictim() == hostileRef && threatRefStatusChangeEvent->getFValue()<0.0f) ||
-                (getCurrentVictim() != hostileRef && threatRefStatusChangeEvent->getFValue()>0.0f))
-                setDirty(true);                             // the order in the threat list might have changed
+            // the order in the threat list might have changed
+            if (hostileRef->isOnline())
+                iThreatContainer.threatChanged(hostileRef);
+            else
+                iThreatOfflineContainer.threatChanged(hostileRef);
             break;
         case UEV_THREAT_REF_ONLINE_STATUS:
+            // heap position is shared by both containers, always remove before adding
             if (!hostileRef->isOnline())
             {
                 if (hostileRef == getCurrentVictim())
-                {
                     setCurrentVictim(NULL);
-                    setDirty(true);
-                }
                 iThreatContainer.remove(hostileRef);
                 iThreatOfflineContainer.addReference(hostileRef);
             }
             else
             {
-                if (getCurrentVictim() && hostileRef->getThreat() > (1.1f * getCurrentVictim()->getThreat()))
-                    setDirty(true);
-                iThreatContainer.addReference(hostileRef);
                 iThreatOfflineContainer.remove(hostileRef);
+                iThreatContainer.addReference(hostileRef);
             }
             break;
         case UEV_THREAT_REF_REMOVE_FROM_LIST:
             if (hostileRef == getCurrentVictim())
-            {
                 setCurrentVictim(NULL);
-                setDirty(true);
-            }
             if (hostileRef ->isOnline())
                 iThreatContainer.remove(hostileRef);
             else
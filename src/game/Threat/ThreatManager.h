@@ -27,6 +27,7 @@
 #include "UnitEvents.h"
 
 #include <list>
+#include <vector>
 
 //==============================================================
 
@@ -48,6 +49,8 @@ class ThreatCalcHelper
 
 class HostileReference : public Reference<Unit, ThreatManager>
 {
+    friend class ThreatContainer;
+
     public:
         HostileReference(Unit* pUnit, ThreatManager *pThreatManager, float pThreat);
 
@@ -127,24 +130,41 @@ class HostileReference : public Reference<Unit, ThreatManager>
         uint64 iUnitGuid;
         bool iOnline;
         bool iAccessible;
+
+        // position inside owning ThreatContainer, maintained by the container
+        uint32 iHeapIndex;
+        std::list<HostileReference*>::iterator iListPos;
 };
 
 //==============================================================
 class ThreatManager;
 
+// References are kept in an indexed binary max-heap on threat, so threat
+// changes cost O(log n) and the most hated reference is always on top.
+// The threat list sorted by threat is only a view, sorted when requested.
 class ThreatContainer
 {
     private:
+        std::vector<HostileReference*> iThreatHeap;
         std::list<HostileReference*> iThreatList;
+        // heap positions waiting for visit in selectNextVictim, kept to avoid allocations
+        std::vector<uint32> iVisitQueue;
         bool iDirty;
     protected:
         friend class ThreatManager;
 
-        void remove(HostileReference* pRef) { iThreatList.remove(pRef); }
-        void addReference(HostileReference* pHostileReference) { iThreatList.push_back(pHostileReference); }
+        void remove(HostileReference* pRef);
+        void addReference(HostileReference* pHostileReference);
         void clearReferences();
+        // restore heap order after threat of the reference has changed
+        void threatChanged(HostileReference* pRef);
         // Sort the list if necessary
         void update();
+    private:
+        bool contains(HostileReference* pRef) const { return pRef->iHeapIndex < iThreatHeap.size() && iThreatHeap[pRef->iHeapIndex] == pRef; }
+        void heapSet(uint32 index, HostileReference* pRef) { iThreatHeap[index] = pRef; pRef->iHeapIndex = index; }
+        void siftUp(uint32 index);
+        void siftDown(uint32 index);
     public:
         ThreatContainer() { iDirty = false; }
         ~ThreatContainer() { clearReferences(); }
@@ -159,13 +179,14 @@ class ThreatContainer
 
         bool isDirty() { return iDirty; }
 
-        bool empty() { return(iThreatList.empty()); }
+        bool empty() { return(iThreatHeap.empty()); }
 
-        HostileReference* getMostHated() { return iThreatList.empty() ? NULL : iThreatList.front(); }
+        HostileReference* getMostHated() { return iThreatHeap.empty() ? NULL : iThreatHeap.front(); }
 
         HostileReference* getReferenceByTarget(Unit* pVictim);
 
-        std::list<HostileReference*>& getThreatList() { return iThreatList; }
+        // sorted by threat, descending; sorting keeps existing iterators valid
+        std::list<HostileReference*>& getThreatList() { update(); return iThreatList; }
 };
 
 //=================================================
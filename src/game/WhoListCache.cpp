@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "WhoListCache.h"
+#include "ObjectAccessor.h"
+#include "Player.h"
+#include "GuildMgr.h"
+#include "GridMap.h"
+#include "Util.h"
+
+uint32 WhoListSnapshot::GetTeamIndex(uint32 team)
+{
+    return team == HORDE ? 1 : 0;
+}
+
+void WhoListSnapshot::GetLevelRange(uint32 teamIndex, uint32 minLevel, uint32 maxLevel, uint32& begin, uint32& end) const
+{
+    if (minLevel > STRONG_MAX_LEVEL || minLevel > maxLevel)
+    {
+        begin = end = 0;
+        return;
+    }
+
+    if (maxLevel > STRONG_MAX_LEVEL)
+        maxLevel = STRONG_MAX_LEVEL;
+
+    begin = levelBegin[teamIndex][minLevel];
+    end = levelBegin[teamIndex][maxLevel + 1];
+}
+
+WhoListSnapshot::IndexList const* WhoListSnapshot::GetZone(uint32 zoneId, bool arenaZone) const
+{
+    ZoneIndex const& index = arenaZone ? arenaZones : zones;
+    ZoneIndex::const_iterator itr = index.find(zoneId);
+    return itr != index.end() ? &itr->second : NULL;
+}
+
+// fields read under the player lock, the rest is filled after
+struct WhoListSource
+{
+    WhoListEntry entry;
+    uint32 guildId;
+    bool inArena;
+    uint32 entryMap;
+    float entryX;
+    float entryY;
+    float entryZ;
+};
+
+static bool WhoListEntryOrder(WhoListEntry const& left, WhoListEntry const& right)
+{
+    uint32 leftTeam = WhoListSnapshot::GetTeamIndex(left.team);
+    uint32 rightTeam = WhoListSnapshot::GetTeamIndex(right.team);
+    if (leftTeam != rightTeam)
+        return leftTeam < rightTeam;
+
+    return left.level < right.level;
+}
+
+void WhoListCache::Rebuild()
+{
+    uint64 start = WorldTimer::getUSTime();
+
+    std::vector<WhoListSource> sources;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, *HashMapHolder<Player>::GetLock());
+        HashMapHolder<Player>::MapType const& players = sObjectAccessor.GetPlayers();
+        sources.resize(players.size());
+
+        uint32 count = 0;
+        for (HashMapHolder<Player>::MapType::const_iterator itr = players.begin(); itr != players.end(); ++itr)
+        {
+            Player* player = itr->second;
+            if (!player->IsInWorld())
+                continue;
+
+            WhoListSource& source = sources[count++];
+            source.entry.guid = player->GetGUID();
+            source.entry.name = player->GetName();
+            source.entry.level = std::min<uint32>(player->GetLevel(), STRONG_MAX_LEVEL);
+            source.entry.zoneId = player->GetCachedZone();
+            source.entry.team = player->GetTeam();
+            source.entry.class_ = player->GetClass();
+            source.entry.race = player->GetRace();
+            source.entry.gender = player->getGender();
+            source.entry.gmLevel = player->GetSession()->GetGMLevel();
+            source.entry.visibility = player->GetVisibility();
+            source.guildId = player->GetGuildId();
+            source.inArena = player->InArena();
+            source.entryMap = player->GetBattleGroundEntryPointMap();
+            source.entryX = player->GetBattleGroundEntryPointX();
+            source.entryY = player->GetBattleGroundEntryPointY();
+            source.entryZ = player->GetBattleGroundEntryPointZ();
+        }
+        sources.resize(count);
+    }
+
+    std::shared_ptr<WhoListSnapshot> snapshot(new WhoListSnapshot);
+    snapshot->entries.reserve(sources.size());
+    for (std::vector<WhoListSource>::iterator itr = sources.begin(); itr != sources.end(); ++itr)
+    {
+        WhoListEntry& entry = itr->entry;
+        if (!Utf8toWStr(entry.name, entry.lowerName))
+            continue;
+        wstrToLower(entry.lowerName);
+
+        entry.guildName = sGuildMgr.GetGuildNameById(itr->guildId);
+        if (!Utf8toWStr(entry.guildName, entry.lowerGuildName))
+            continue;
+        wstrToLower(entry.lowerGuildName);
+
+        entry.arenaZoneId = itr->inArena ? sTerrainMgr.GetZoneId(itr->entryMap, itr->entryX, itr->entryY, itr->entryZ) : entry.zoneId;
+
+        snapshot->entries.push_back(entry);
+    }
+
+    std::sort(snapshot->entries.begin(), snapshot->entries.end(), WhoListEntryOrder);
+
+    std::vector<WhoListEntry> const& entries = snapshot->entries;
+    uint32 index = 0;
+    for (uint32 team = 0; team < WHO_LIST_TEAMS; ++team)
+    {
+        for (uint32 level = 0; level <= STRONG_MAX_LEVEL + 1; ++level)
+        {
+            while (index < entries.size() && WhoListSnapshot::GetTeamIndex(entries[index].team) == team && entries[index].level < level)
+                ++index;
+
+            snapshot->levelBegin[team][level] = index;
+        }
+    }
+
+    snapshot->names.reserve(entries.size());
+    for (uint32 i = 0; i < entries.size(); ++i)
+    {
+        snapshot->zones[entries[i].zoneId].push_back(i);
+        snapshot->arenaZones[entries[i].arenaZoneId].push_back(i);
+        snapshot->names.push_back(std::make_pair(entries[i].lowerName, i));
+    }
+    std::sort(snapshot->names.begin(), snapshot->names.end());
+
+    snapshot->created = time(NULL);
+
+    std::atomic_store(&m_snapshot, WhoListSnapshotPtr(snapshot));
+    m_rebuildTime = uint32(WorldTimer::getUSTime() - start);
+}
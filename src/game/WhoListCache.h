@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _WHOLISTCACHE_H
+#define _WHOLISTCACHE_H
+
+#include "Common.h"
+#include "Database/DBCEnums.h"
+
+#include <ace/Singleton.h>
+
+#include <memory>
+
+// copy of online player's data shown in /who
+struct WhoListEntry
+{
+    uint64 guid;
+    std::string name;
+    std::string guildName;
+    std::wstring lowerName;
+    std::wstring lowerGuildName;
+    uint32 level;
+    uint32 zoneId;
+    uint32 arenaZoneId;                                     // zone of battleground entry point for arena players, zoneId otherwise
+    uint32 team;
+    uint8 class_;
+    uint8 race;
+    uint8 gender;
+    uint8 gmLevel;
+    uint8 visibility;                                       // UnitVisibility
+};
+
+#define WHO_LIST_TEAMS      2                               // alliance, horde
+
+// one rebuild of the list, never changed after it is published
+struct WhoListSnapshot
+{
+    typedef std::vector<uint32> IndexList;
+    typedef UNORDERED_MAP<uint32, IndexList> ZoneIndex;
+
+    static uint32 GetTeamIndex(uint32 team);
+
+    // entries of team with level in [minLevel, maxLevel], as range of entries
+    void GetLevelRange(uint32 teamIndex, uint32 minLevel, uint32 maxLevel, uint32& begin, uint32& end) const;
+    IndexList const* GetZone(uint32 zoneId, bool arenaZone) const;
+
+    std::vector<WhoListEntry> entries;                      // ordered by team, then level
+    uint32 levelBegin[WHO_LIST_TEAMS][STRONG_MAX_LEVEL + 2];    // first entry of team with level >= index
+    ZoneIndex zones;
+    ZoneIndex arenaZones;
+    std::vector<std::pair<std::wstring, uint32> > names;    // lowercase names, sorted for prefix lookup
+    time_t created;
+};
+
+typedef std::shared_ptr<WhoListSnapshot const> WhoListSnapshotPtr;
+
+/**
+ * Periodically rebuilt copy of online players for /who and GM lookups.
+ *
+ * Rebuild() copies player data while holding the ObjectAccessor player lock
+ * once per interval, everything else (names lowercasing, guild names, arena
+ * zones, sorting and indexes) is done after the lock is released. Readers
+ * take current snapshot without any lock and keep it alive as long as they
+ * need, a rebuild meanwhile only swaps the pointer.
+ */
+class WhoListCache
+{
+    friend class ACE_Singleton<WhoListCache, ACE_Null_Mutex>;
+    WhoListCache() : m_rebuildTime(0) {}
+
+    public:
+        void Rebuild();
+
+        // NULL before first rebuild
+        WhoListSnapshotPtr GetSnapshot() const { return std::atomic_load(&m_snapshot); }
+
+        uint32 GetRebuildTime() const { return m_rebuildTime; }    // microseconds, last rebuild
+
+    private:
+        WhoListSnapshotPtr m_snapshot;
+        uint32 m_rebuildTime;
+};
+
+#define sWhoListCache (*ACE_Singleton<WhoListCache, ACE_Null_Mutex>::instance())
+
+#endif
@@ -28,6 +28,7 @@
 #include "Config/Config.h"
 #include "SystemConfig.h"
 #include "Log.h"
+#include "Profiler.h"
 #include "Opcodes.h"
 #include "WorldPacket.h"
 #include "Weather.h"
@@ -70,6 +71,7 @@
 
 //#include "Timer.h"
 #include "GuildMgr.h"
+#include "WhoListCache.h"
 
 volatile bool World::m_stopEvent = false;
 uint8 World::m_ExitCode = SHUTDOWN_EXIT_CODE;
@@ -471,6 +473,10 @@ void World::LoadConfigSettings(bool reload)
     loadConfig(CONFIG_ADDON_CHANNEL, "AddonChannel", false);
     loadConfig(CONFIG_SAVE_RESPAWN_TIME_IMMEDIATELY, "SaveRespawnTimeImmediately", true);
     loadConfig(CONFIG_GRID_UNLOAD, "GridUnload", true);
+    loadConfig(CONFIG_GRID_PREFETCH, "GridPrefetch", false);
+    loadConfig(CONFIG_GRID_PREFETCH_LOOKAHEAD, "GridPrefetchLookAhead", 20);
+    loadConfig(CONFIG_AURA_TIMER_WHEEL, "Auras.TimerWheel", true);
+    loadConfig(CONFIG_AI_NOTIFY_BATCHED, "AINotify.Batched", true);
 
     loadConfig(CONFIG_INTERVAL_CHANGEWEATHER, "ChangeWeatherInterval", 600000);
     loadConfig(CONFIG_INTERVAL_SAVE, "PlayerSaveInterval", 900000);
@@ -484,6 +490,10 @@ void World::LoadConfigSettings(bool reload)
     loadConfig(CONFIG_MAPUPDATE_INSTANCES, "MapUpdate.Instances", 50);
     loadConfig(CONFIG_MAPUPDATE_BATTLEGROUNDS, "MapUpdate.Battlegrounds", 50);
     loadConfig(CONFIG_MAPUPDATE_ARENAS, "MapUpdate.Arena", 50);
+    loadConfig(CONFIG_MAPUPDATE_PARALLEL_DELAYED, "MapUpdate.ParallelDelayed", true);
+    loadConfig(CONFIG_MAPUPDATE_UNLOAD_GRIDS, "MapUpdate.UnloadGridsPerTick", 4);
+    loadConfig(CONFIG_MAPUPDATE_EVENT_SPAWNS, "MapUpdate.EventSpawnsPerTick", 200);
+    loadConfig(CONFIG_MAPUPDATE_DECOUPLED_INSTANCES, "MapUpdate.DecoupledInstances", false);
 
     sessionThreads = sConfig.GetIntDefault("SessionUpdate.Threads", 0);
     loadConfig(CONFIG_SESSION_UPDATE_MAX_TIME, "SessionUpdate.MaxTime", 1000);
@@ -491,6 +501,10 @@ void World::LoadConfigSettings(bool reload)
     loadConfig(CONFIG_SESSION_UPDATE_VERBOSE_LOG, "SessionUpdate.VerboseLog", 0);
     loadConfig(CONFIG_SESSION_UPDATE_IDLE_KICK, "SessionUpdate.IdleKickTimer", 15*MINUTE*IN_MILISECONDS);
     loadConfig(CONFIG_SESSION_UPDATE_MIN_LOG_DIFF, "SessionUpdate.MinLogDiff", 25);
+    loadConfig(CONFIG_SESSION_UPDATE_PACKET_BUDGET, "SessionUpdate.PacketBudget", 0);
+    loadConfig(CONFIG_SESSION_UPDATE_OPCODE_STATS, "SessionUpdate.OpcodeStats", false);
+    loadConfig(CONFIG_SESSION_UPDATE_RECV_QUEUE_SIZE, "SessionUpdate.RecvQueueSize", 256);
+    loadConfig(CONFIG_SESSION_UPDATE_RECV_QUEUE_LIMIT, "SessionUpdate.RecvQueueLimit", 4096);
     loadConfig(CONFIG_INTERVAL_LOG_UPDATE, "RecordUpdateTimeDiffInterval", 60000);
     loadConfig(CONFIG_MIN_LOG_UPDATE, "DiffRecord.Update", 300);
     loadConfig(CONFIG_MIN_LOG_CELL, "DiffRecord.Cell", 300);
@@ -558,6 +572,12 @@ void World::LoadConfigSettings(bool reload)
     loadConfig(CONFIG_RETURNOLDMAILS_INTERVAL, "Mail.OldReturnTimer", 60);
     loadConfig(CONFIG_GROUP_XP_DISTANCE, "MaxGroupXPDistance", 74);
     loadConfig(CONFIG_MAX_WHO, "MaxWhoListReturns", 49);
+    loadConfig(CONFIG_WHO_LIST_UPDATE_INTERVAL, "WhoList.UpdateInterval", 5000);
+    if (m_configs[CONFIG_WHO_LIST_UPDATE_INTERVAL] < 1000)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: WhoList.UpdateInterval (%u) must be at least 1000 ms, set to 1000.", m_configs[CONFIG_WHO_LIST_UPDATE_INTERVAL]);
+        m_configs[CONFIG_WHO_LIST_UPDATE_INTERVAL] = 1000;
+    }
     loadConfig(CONFIG_NO_RESET_TALENT_COST, "NoResetTalentsCost", false);
     loadConfig(CONFIG_FREE_RESPEC_COST, "FreeRespec.Cost", 10000000);
     loadConfig(CONFIG_FREE_RESPEC_DURATION, "FreeRespec.Duration", 6 * MONTH);
@@ -810,6 +830,7 @@ void World::LoadConfigSettings(bool reload)
 
     loadConfig(CONFIG_MMAP_ENABLED, "mmap.enabled", true);
     sLog.outString("WORLD: mmap pathfinding %sabled", getConfig(CONFIG_MMAP_ENABLED) ? "en" : "dis");
+    loadConfig(CONFIG_MMAP_ASYNC_THREADS, "mmap.asyncThreads", 0);
 
     // visibility and radiuses
     loadConfig(CONFIG_GROUP_VISIBILITY, "Visibility.GroupMode", 0);
@@ -1295,6 +1316,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading linked spells...");
     sSpellMgr.LoadSpellLinked();
 
+    sLog.outString("Building hot spell info...");           // must be after all spell tables it copies
+    sSpellMgr.LoadSpellHotInfo();
+
     sLog.outString("Loading player Create Info & Level Stats...");
     sObjectMgr.LoadPlayerInfo();
 
@@ -1437,6 +1461,7 @@ void World::SetInitialWorldSettings()
     m_timers[WUPDATE_GUILD_ANNOUNCES].SetInterval(getConfig(CONFIG_GUILD_ANN_INTERVAL));
     m_timers[WUPDATE_DELETECHARS].SetInterval(DAY*IN_MILISECONDS); // check for chars to delete every day
     m_timers[WUPDATE_OLDMAILS].SetInterval(getConfig(CONFIG_RETURNOLDMAILS_INTERVAL)*1000);
+    m_timers[WUPDATE_WHO_LIST].SetInterval(getConfig(CONFIG_WHO_LIST_UPDATE_INTERVAL));
 
     //to set mailtimer to return mails every day between 4 and 5 am
     //mailtimer is increased when updating auctions
@@ -1576,6 +1601,10 @@ void World::LoadAutobroadcasts()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    // start or finish requested profiler capture while map threads are idle
+    sProfiler.Update();
+    ProfileZone zone("World::Update");
+
     m_updateTime = uint32(diff);
 
     if (getConfig(CONFIG_COREBALANCER_ENABLED))
@@ -1678,7 +1707,8 @@ void World::Update(uint32 diff)
 
         // Update groups
         for (ObjectMgr::GroupSet::iterator itr = sObjectMgr.GetGroupSetBegin(); itr != sObjectMgr.GetGroupSetEnd(); ++itr)
-            (*itr)->Update(diff);
+            if (!(*itr)->HasMemberInDecoupledUpdate())
+                (*itr)->Update(diff);
 
         diffRecorder.RecordTimeFor("Groups", 10);
 
@@ -1781,6 +1811,15 @@ void World::Update(uint32 diff)
     sOutdoorPvPMgr.Update(diff);
     diffRecorder.RecordTimeFor("OutdoorPvP manager", 10);
 
+    ///- Copy online players for /who while map threads are idle
+    if (m_timers[WUPDATE_WHO_LIST].Passed())
+    {
+        m_timers[WUPDATE_WHO_LIST].SetInterval(getConfig(CONFIG_WHO_LIST_UPDATE_INTERVAL));
+        m_timers[WUPDATE_WHO_LIST].Reset();
+        sWhoListCache.Rebuild();
+        diffRecorder.RecordTimeFor("Who list", 10);
+    }
+
     ///- Delete all characters which have been deleted X days before
     if (m_timers[WUPDATE_DELETECHARS].Passed())
     {
@@ -1839,6 +1878,8 @@ void World::Update(uint32 diff)
 
 void World::UpdateSessions(const uint32 & diff)
 {
+    ProfileZone zone("World::UpdateSessions");
+
     ///- Add new sessions
     WorldSession* sess;
     while (addSessQueue.next(sess))
@@ -1855,6 +1896,11 @@ void World::UpdateSessions(const uint32 & diff)
 
         ///- and remove not active sessions from the list
         WorldSession * pSession = itr->second;
+
+        // handled next tick, its decoupled instance still updates
+        if (pSession->WaitsForDecoupledMap())
+            continue;
+
         WorldSessionFilter updater(pSession);
         if (!pSession->Update(diff, updater))   // As interval = 0
         {
@@ -2416,6 +2462,8 @@ void World::InitResultQueue()
 
 void World::UpdateResultQueue()
 {
+    ProfileZone zone("SQL callbacks");
+
     //process async result queues
     RealmDataDatabase.ProcessResultQueue();
     GameDataDatabase.ProcessResultQueue();
@@ -88,6 +88,7 @@ enum WorldTimers
     WUPDATE_GUILD_ANNOUNCES = 8,
     WUPDATE_DELETECHARS     = 9,
     WUPDATE_OLDMAILS        = 10,
+    WUPDATE_WHO_LIST        = 11,
 
     WUPDATE_COUNT
 };
@@ -103,6 +104,10 @@ enum WorldConfigs
     CONFIG_ADDON_CHANNEL,
     CONFIG_SAVE_RESPAWN_TIME_IMMEDIATELY,
     CONFIG_GRID_UNLOAD,
+    CONFIG_GRID_PREFETCH,
+    CONFIG_GRID_PREFETCH_LOOKAHEAD,
+    CONFIG_AURA_TIMER_WHEEL,
+    CONFIG_AI_NOTIFY_BATCHED,
     CONFIG_WORLD_SLEEP,
 
     CONFIG_SOCKET_SELECTTIME,
@@ -118,12 +123,20 @@ enum WorldConfigs
     CONFIG_MAPUPDATE_INSTANCES,
     CONFIG_MAPUPDATE_BATTLEGROUNDS,
     CONFIG_MAPUPDATE_ARENAS,
+    CONFIG_MAPUPDATE_PARALLEL_DELAYED,
+    CONFIG_MAPUPDATE_UNLOAD_GRIDS,
+    CONFIG_MAPUPDATE_EVENT_SPAWNS,
+    CONFIG_MAPUPDATE_DECOUPLED_INSTANCES,
 
     CONFIG_SESSION_UPDATE_MAX_TIME,
     CONFIG_SESSION_UPDATE_OVERTIME_METHOD,
     CONFIG_SESSION_UPDATE_VERBOSE_LOG,
     CONFIG_SESSION_UPDATE_IDLE_KICK,
     CONFIG_SESSION_UPDATE_MIN_LOG_DIFF,
+    CONFIG_SESSION_UPDATE_PACKET_BUDGET,
+    CONFIG_SESSION_UPDATE_OPCODE_STATS,
+    CONFIG_SESSION_UPDATE_RECV_QUEUE_SIZE,
+    CONFIG_SESSION_UPDATE_RECV_QUEUE_LIMIT,
     CONFIG_INTERVAL_LOG_UPDATE,
     CONFIG_MIN_LOG_UPDATE,
     CONFIG_MIN_LOG_CELL,
@@ -194,6 +207,7 @@ enum WorldConfigs
     CONFIG_RETURNOLDMAILS_INTERVAL,
     CONFIG_GROUP_XP_DISTANCE,
     CONFIG_MAX_WHO,
+    CONFIG_WHO_LIST_UPDATE_INTERVAL,
     CONFIG_MIN_PETITION_SIGNS,
     CONFIG_NO_RESET_TALENT_COST,
     CONFIG_FREE_RESPEC_COST,
@@ -357,6 +371,7 @@ enum WorldConfigs
     CONFIG_VMAP_TOTEM,
     CONFIG_VMAP_GROUND,
     CONFIG_MMAP_ENABLED,
+    CONFIG_MMAP_ASYNC_THREADS,
 
     // visibility and radiuses
     CONFIG_GROUP_VISIBILITY,
@@ -23,6 +23,7 @@
 */
 
 #include <sstream>
+#include <atomic>
 
 #include "WorldSocket.h"                                    // must be first to make ACE happy with ACE includes in it
 #include "Common.h"
@@ -97,8 +98,8 @@ LookingForGroup_auto_join(false), LookingForGroup_auto_add(false), m_muteTime(mu
 m_trollmuteTime(trollmute_time), m_trollmuteReason(trollmute_reason), _player(NULL), m_Socket(sock),
 m_gmlevel(gmlevel), _accountId(id), m_expansion(expansion), m_opcodesDisabled(opcDisabled),
 m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetIndexForLocale(locale)),
-_logoutTime(0), m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerSave(false), m_playerRecentlyLogout(false), m_latency(0), m_clientTimeDelay(0),
-m_accFlags(accFlags), m_Warden(NULL), m_bot(nullptr)
+_logoutTime(0), m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerSave(false), m_playerRecentlyLogout(false), m_mapTransferPending(false), m_latency(0), m_clientTimeDelay(0),
+m_accFlags(accFlags), m_Warden(NULL), m_bot(nullptr), _recvQueue(NULL)
 {
     _mailSendTimer.Reset(5*IN_MILISECONDS);
 
@@ -115,6 +116,10 @@ m_accFlags(accFlags), m_Warden(NULL), m_bot(nullptr)
 
         // create copy of base map :P
         _opcodesCooldown = sObjectMgr.GetOpcodesCooldown();
+
+        // bots don't receive packets from a socket, only sessions of clients get a queue
+        _recvQueue = new ACE_Based::MPSCRing<WorldPacket*>(sWorld.getConfig(CONFIG_SESSION_UPDATE_RECV_QUEUE_SIZE),
+            sWorld.getConfig(CONFIG_SESSION_UPDATE_RECV_QUEUE_LIMIT));
     }
     else
         m_Address = "<BOT>";
@@ -138,9 +143,15 @@ WorldSession::~WorldSession()
     if (m_Warden)
         delete m_Warden;
 
-    WorldPacket* packet;
-    while (_recvQueue.next(packet))
-        delete packet;
+    if (_recvQueue)
+    {
+        WorldPacket* packets[64];
+        while (size_t count = _recvQueue->next(packets, 64))
+            for (size_t i = 0; i < count; ++i)
+                delete packets[i];
+
+        delete _recvQueue;
+    }
 
     static SqlStatementID updateAccountOnline;
     static SqlStatementID updateCharactersOnline;
@@ -207,9 +218,25 @@ void WorldSession::RemoveAccountFlag(AccountFlags flag)
     SaveAccountFlags();
 }
 
+static std::atomic<uint64> sentPacketCount(0);
+static std::atomic<uint64> sentPacketBytes(0);
+
+uint64 WorldSession::GetSentPacketCount()
+{
+    return sentPacketCount.load(std::memory_order_relaxed);
+}
+
+uint64 WorldSession::GetSentPacketBytes()
+{
+    return sentPacketBytes.load(std::memory_order_relaxed);
+}
+
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const* packet)
 {
+    sentPacketCount.fetch_add(1, std::memory_order_relaxed);
+    sentPacketBytes.fetch_add(packet->size(), std::memory_order_relaxed);
+
     if (!m_Socket)
     {
         if (GetBot() && GetBot()->ai && !GetBot()->requestRemoval)
@@ -289,22 +316,31 @@ void WorldSession::SendPacket(WorldPacket const* packet)
         m_Socket->CloseSocket();
 }
 
-/// Add an incoming packet to the queue
-void WorldSession::QueuePacket(WorldPacket* new_packet)
+/// Add an incoming packet to the queue, false when the queue is full and caller still owns the packet
+bool WorldSession::QueuePacket(WorldPacket* new_packet)
 {
     if (!new_packet)
-        return;
+        return true;
 
     auto i = _opcodesCooldown.find(new_packet->GetOpcode());
     if (i != _opcodesCooldown.end())
     {
         if (!i->second.Passed())
-            return;
+        {
+            delete new_packet;
+            return true;
+        }
 
         i->second.SetCurrent(0);
     }
 
-    _recvQueue.add(new_packet);
+    if (!_recvQueue->add(new_packet))
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: WorldSession::QueuePacket: receive queue of account %u is full (%u packets), disconnecting", GetAccountId(), uint32(_recvQueue->limit()));
+        return false;
+    }
+
+    return true;
 }
 
 /// Logging helper for unexpected opcodes
@@ -334,6 +370,9 @@ void WorldSession::ProcessPacket(WorldPacket* packet)
     }
     else
     {
+        // measure cost of the handler only, invalid opcodes are not accounted
+        OpcodeCostRecorder costRecorder(packet->GetOpcode());
+
         OpcodeHandler& opHandle = opcodeTable[packet->GetOpcode()];
         switch (opHandle.status)
         {
@@ -387,6 +426,29 @@ void WorldSession::ProcessPacket(WorldPacket* packet)
 }
 
 /// Update the WorldSession (triggered by World update)
+bool WorldSession::WaitsForDecoupledMap()
+{
+    if (m_mapTransferPending.load(std::memory_order_acquire))
+        return true;
+
+    if (!_player)
+        return false;
+
+    if (_player->IsInWorld() && _player->GetMap()->IsDecoupledUpdating())
+        return true;
+
+    // group changes made by handlers here are seen by map threads of all members
+    if (Group* group = _player->GetGroup())
+        if (group->HasMemberInDecoupledUpdate())
+            return true;
+
+    if (Group* group = _player->GetGroupInvite())
+        if (group->HasMemberInDecoupledUpdate())
+            return true;
+
+    return false;
+}
+
 bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 {
     RecordSessionTimeDiff(NULL);
@@ -420,9 +482,12 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     /// not proccess packets if socket already closed
     WorldPacket* packet;
 
+    const uint32 packetBudget = sWorld.getConfig(CONFIG_SESSION_UPDATE_PACKET_BUDGET);
+    const uint64 packetsStart = packetBudget ? WorldTimer::getUSTime() : 0;
+
     try
     {
-        while (CanProcessPackets() && _recvQueue.next(packet, updater))
+        while (_recvQueue && CanProcessPackets() && _recvQueue->next(packet, updater))
         {
             if (verbose > 0)
             {
@@ -434,6 +499,10 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
                 ProcessPacket(packet);
 
             delete packet;
+
+            // budget used up, rest of the queue waits for next update
+            if (packetBudget && WorldTimer::getUSTime() - packetsStart >= packetBudget)
+                break;
         }
     }
     catch (...)
@@ -32,6 +32,7 @@
 #include "AuctionHouseMgr.h"
 #include "WardenBase.h"
 #include "Item.h"
+#include "MPSCRing.h"
 
 struct ItemPrototype;
 struct AuctionEntry;
@@ -166,6 +167,10 @@ class WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const* packet);
+
+        // totals over all sessions, including bots without socket
+        static uint64 GetSentPacketCount();
+        static uint64 GetSentPacketBytes();
         void SendNotification(const char *format,...) ATTR_PRINTF(2,3);
         void SendNotification(int32 string_id,...);
         void SendPetNameInvalid(uint32 error, const std::string& name, DeclinedName *declinedName);
@@ -231,11 +236,16 @@ class WorldSession
         void LogoutPlayer(bool Save);
         void KickPlayer();
 
-        void QueuePacket(WorldPacket* new_packet);
+        bool QueuePacket(WorldPacket* new_packet);
         bool CanProcessPackets() const;
         void ProcessPacket(WorldPacket* packet);
         bool Update(uint32 diff, PacketFilter& updater);
 
+        // world thread must not process this session now, its player or group
+        // is used by a decoupled instance that is still updating
+        bool WaitsForDecoupledMap();
+        void SetMapTransferPending(bool pending) { m_mapTransferPending.store(pending, std::memory_order_release); }
+
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position);
 
@@ -443,6 +453,8 @@ class WorldSession
 
         void HandleMoveWorldportAckOpcode(WorldPacket& recvPacket);
         void HandleMoveWorldportAckOpcode();                // for server-side calls
+        // second half of transfer, adds player to the map he was moved to
+        void FinishWorldportAck(WorldLocation const& old_loc, bool reset_notify);
 
         void HandleMovementOpcodes(WorldPacket& recvPacket);
         bool HandleMoverRelocation(MovementInfo&);
@@ -787,6 +799,7 @@ class WorldSession
         bool m_playerSave;
         bool m_playerLogout;                                // code processed in LogoutPlayer
         bool m_playerRecentlyLogout;
+        std::atomic<bool> m_mapTransferPending;             // decoupled instance adds the player in its update
 
         uint64 m_accFlags;
 
@@ -804,7 +817,7 @@ class WorldSession
         typedef UNORDERED_MAP<uint16,Timer> OpcodesCooldown;
         OpcodesCooldown _opcodesCooldown;
 
-        ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex> _recvQueue;
+        ACE_Based::MPSCRing<WorldPacket*>* _recvQueue;      // NULL for bots
 
         uint32 m_currentSessionTime;
         uint32 m_currentVerboseTime;
@@ -138,6 +138,14 @@ bool Database::Initialize(const char * infoString, int nConns /*= 1*/)
         m_pQueryConnections.push_back(pConn);
     }
 
+    // global for the server, any connection will do
+    {
+        SqlConnection::Lock guard(m_pQueryConnections[0]);
+        QueryResultAutoPtr result = guard->Query("SELECT @@max_allowed_packet");
+        if (result)
+            m_maxPacketSize = result->Fetch()[0].GetUInt32();
+    }
+
     //create and initialize connection for async requests
     m_pAsyncConn = CreateConnection();
     if(!m_pAsyncConn->Initialize(infoString))
@@ -37,6 +37,9 @@ class Database;
 
 #define MAX_QUERY_LEN   32*1024
 
+// used when max_allowed_packet can't be read, MySQL 5.5 default
+#define DEFAULT_MAX_PACKET_SIZE     (1024*1024)
+
 //
 class SqlConnection
 {
@@ -222,11 +225,20 @@ class Database
         void AllowAsyncTransactions() { m_bAllowAsyncTransactions = true; }
         void EnableLogging() { m_enableLogging = true; }
 
+        // statements sent to the server by any connection, used for benchmarking
+        void CountOperation() { ++m_nOperationCounter; }
+        long GetOperationCount() const { return m_nOperationCounter.value(); }
+
+        // server's max_allowed_packet, read at connect
+        uint32 GetMaxPacketSize() const { return m_maxPacketSize; }
+
     protected:
         Database() : m_pAsyncConn(NULL), m_pResultQueue(NULL), m_threadBody(NULL), m_delayThread(NULL),
-            m_logSQL(false), m_pingIntervalms(0), m_nQueryConnPoolSize(1), m_bAllowAsyncTransactions(false), m_iStmtIndex(-1)
+            m_logSQL(false), m_pingIntervalms(0), m_nQueryConnPoolSize(1), m_bAllowAsyncTransactions(false), m_iStmtIndex(-1),
+            m_maxPacketSize(DEFAULT_MAX_PACKET_SIZE)
         {
             m_nQueryCounter = -1;
+            m_nOperationCounter = 0;
             m_enableLogging = false;
         }
 
@@ -278,6 +290,7 @@ class Database
         //connection helper counters
         int m_nQueryConnPoolSize;                               //current size of query connection pool
         ACE_Atomic_Op<ACE_Thread_Mutex, long> m_nQueryCounter;  //counter for connection selection
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_nOperationCounter;  //counter for executed statements
 
         //lets use pool of connections for sync queries
         typedef std::vector< SqlConnection * > SqlConnectionContainer;
@@ -303,6 +316,8 @@ class Database
 
         int m_iStmtIndex;
 
+        uint32 m_maxPacketSize;
+
     private:
 
         bool m_logSQL;
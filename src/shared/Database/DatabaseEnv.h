@@ -28,6 +28,7 @@
 #include "Database/QueryResultMysql.h"
 #include "Database/Database.h"
 #include "Database/DatabaseMysql.h"
+#include "Database/SqlInsertBatch.h"
 typedef DatabaseMysql DatabaseType;
 
 #define _LIKE_           "LIKE"
@@ -188,6 +188,7 @@ bool MySQLConnection::_Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD *
         return 0;
 
     uint32 _s = WorldTimer::getMSTime();
+    m_db.CountOperation();
 
     if(mysql_query(mMysql, sql))
     {
@@ -264,6 +265,7 @@ bool MySQLConnection::Execute(const char* sql)
 
     {
         uint32 _s = WorldTimer::getMSTime();
+        m_db.CountOperation();
 
         if(mysql_query(mMysql, sql))
         {
@@ -452,7 +454,7 @@ void MySqlPreparedStatement::addParam( int nIndex, const SqlStmtFieldData& data
     pData.is_unsigned = bUnsigned;
     pData.buffer = data.buff();
     pData.length = 0;
-    pData.buffer_length = data.type() == FIELD_STRING ? data.size() : 0;
+    pData.buffer_length = (data.type() == FIELD_STRING || data.type() == FIELD_BINARY) ? data.size() : 0;
 }
 
 void MySqlPreparedStatement::RemoveBinds()
@@ -480,6 +482,7 @@ bool MySqlPreparedStatement::execute()
         return false;
 
     uint32 _s = WorldTimer::getMSTime();
+    m_pConn.DB().CountOperation();
 
     if(mysql_stmt_execute(m_stmt))
     {
@@ -520,6 +523,7 @@ enum_field_types MySqlPreparedStatement::ToMySQLType( const SqlStmtFieldData &da
     case FIELD_FLOAT:   dataType = MYSQL_TYPE_FLOAT;                    break;
     case FIELD_DOUBLE:  dataType = MYSQL_TYPE_DOUBLE;                   break;
     case FIELD_STRING:  dataType = MYSQL_TYPE_STRING;                   break;
+    case FIELD_BINARY:  dataType = MYSQL_TYPE_BLOB;                     break;
     }
 
     return dataType;
@@ -35,8 +35,8 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field() : mValue(NULL), mType(DB_TYPE_UNKNOWN) {}
-        Field(const char *value, enum DataTypes type) : mType(type) { mValue = const_cast<char * >(value); }
+        Field() : mValue(NULL), mLength(0), mType(DB_TYPE_UNKNOWN) {}
+        Field(const char *value, enum DataTypes type) : mLength(value ? strlen(value) : 0), mType(type) { mValue = const_cast<char * >(value); }
 
         ~Field() {}
 
@@ -44,6 +44,8 @@ class Field
         bool IsNULL() const { return mValue == NULL; }
 
         const char *GetString() const { return mValue; }
+        // bytes in value, blobs may contain '\0'
+        uint32 GetLength() const { return mLength; }
         std::string GetCppString() const
         {
             return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
@@ -76,13 +78,14 @@ class Field
         void SetType(enum DataTypes type) { mType = type; }
         //no need for memory allocations to store resultset field strings
         //all we need is to cache pointers returned by different DBMS APIs
-        void SetValue(const char *value) { mValue = const_cast<char * >(value); };
+        void SetValue(const char *value, uint32 length) { mValue = const_cast<char * >(value); mLength = length; };
 
     private:
         Field(Field &f);
         Field& operator=(const Field& );
 
         char *mValue;
+        uint32 mLength;
         enum DataTypes mType;
 };
 #endif
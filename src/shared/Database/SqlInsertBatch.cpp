@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "DatabaseEnv.h"
+#include "Database/SqlInsertBatch.h"
+
+SqlInsertBatch::SqlInsertBatch(Database& db, const char* head) : m_db(db), m_head(head),
+    m_rows(0), m_totalRows(0), m_statements(0), m_firstValue(true)
+{
+    // leave room for the row that crosses the limit
+    m_maxSize = std::min<size_t>(SQL_INSERT_BATCH_MAX_SIZE, m_db.GetMaxPacketSize() / 2);
+}
+
+void SqlInsertBatch::NewRow()
+{
+    if (m_rows && m_sql.size() >= m_maxSize)
+        Flush();
+
+    if (m_rows)
+        m_sql += "),(";
+    else
+    {
+        m_sql = m_head;
+        m_sql += '(';
+    }
+
+    ++m_rows;
+    ++m_totalRows;
+    m_firstValue = true;
+}
+
+void SqlInsertBatch::addBinary(const void* data, size_t size)
+{
+    std::string tmp((const char*)data, size);
+    m_db.escape_string(tmp);
+
+    std::string value;
+    value.reserve(tmp.size() + 2);
+    value += '\'';
+    value += tmp;
+    value += '\'';
+    addRaw(value);
+}
+
+void SqlInsertBatch::addRaw(const std::string& value)
+{
+    ASSERT(m_rows && "SqlInsertBatch: NewRow() must be called before adding values");
+
+    if (!m_firstValue)
+        m_sql += ',';
+
+    m_sql += value;
+    m_firstValue = false;
+}
+
+bool SqlInsertBatch::Flush()
+{
+    if (!m_rows)
+        return true;
+
+    m_sql += ')';
+
+    bool result = m_db.Execute(m_sql.c_str());
+
+    ++m_statements;
+    m_rows = 0;
+    m_sql.clear();
+    return result;
+}
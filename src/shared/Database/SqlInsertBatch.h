@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _SQLINSERTBATCH_H
+#define _SQLINSERTBATCH_H
+
+#include "Common.h"
+
+class Database;
+
+// upper bound of one batched statement, lowered to half of server's max_allowed_packet
+#define SQL_INSERT_BATCH_MAX_SIZE   (512*1024)
+
+/**
+ * Coalesces rows of one table into multi-row INSERT (or REPLACE) statements.
+ *
+ * Statements are sent through Database::Execute, so inside a transaction they
+ * are queued with it like any other request. A statement is flushed when it
+ * grows over the chunk size, on Flush() and when the batch goes out of scope.
+ *
+ *     SqlInsertBatch batch(RealmDataDatabase, "INSERT INTO character_spell (guid, spell) VALUES ");
+ *     batch.NewRow();
+ *     batch.addUInt32(guid);
+ *     batch.addUInt32(spell);
+ */
+class SqlInsertBatch
+{
+    public:
+        SqlInsertBatch(Database& db, const char* head);
+        ~SqlInsertBatch() { Flush(); }
+
+        // start a row, sends pending rows first when statement is full
+        void NewRow();
+
+        void addBool(bool var) { addValue(uint32(var)); }
+        void addUInt8(uint8 var) { addValue(uint32(var)); }
+        void addInt8(int8 var) { addValue(int32(var)); }
+        void addUInt16(uint16 var) { addValue(uint32(var)); }
+        void addInt16(int16 var) { addValue(int32(var)); }
+        void addUInt32(uint32 var) { addValue(var); }
+        void addInt32(int32 var) { addValue(var); }
+        void addUInt64(uint64 var) { addValue(var); }
+        void addInt64(int64 var) { addValue(var); }
+        void addFloat(float var) { addValue(var); }
+        void addDouble(double var) { addValue(var); }
+        void addString(const std::string& var) { addBinary(var.data(), var.size()); }
+        void addBinary(const void* data, size_t size);
+
+        // execute pending rows, returns false when the request could not be queued
+        bool Flush();
+
+        uint32 GetRows() const { return m_totalRows; }
+        uint32 GetStatements() const { return m_statements; }
+
+    private:
+        SqlInsertBatch(const SqlInsertBatch&);
+        SqlInsertBatch& operator=(const SqlInsertBatch&);
+
+        template<typename T>
+        void addValue(T var)
+        {
+            std::ostringstream ss;
+            ss << var;
+            addRaw(ss.str());
+        }
+
+        void addRaw(const std::string& value);
+
+        Database& m_db;
+        std::string m_head;
+        std::string m_sql;
+        size_t m_maxSize;
+        uint32 m_rows;                                      // rows in m_sql
+        uint32 m_totalRows;
+        uint32 m_statements;
+        bool m_firstValue;
+};
+
+#endif
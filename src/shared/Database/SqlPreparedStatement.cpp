@@ -157,5 +157,13 @@ void SqlPlainPreparedStatement::DataToString( const SqlStmtFieldData& data, std:
             fmt << "'" << tmp << "'";
         }
         break;
+        case FIELD_BINARY:
+        {
+            // escaping turns '\0' into "\\0", result is safe to embed
+            std::string tmp = data.toBinary();
+            m_pConn.DB().escape_string(tmp);
+            fmt << "'" << tmp << "'";
+        }
+        break;
     }
 }
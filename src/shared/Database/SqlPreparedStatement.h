@@ -59,6 +59,7 @@ enum SqlStmtFieldType
     FIELD_FLOAT,
     FIELD_DOUBLE,
     FIELD_STRING,
+    FIELD_BINARY,
     FIELD_NONE
 };
 
@@ -76,6 +77,8 @@ class SqlStmtFieldData
         template<typename T1>
         void set(T1 param1);
 
+        void setBinary(const void* data, size_t size) { m_type = FIELD_BINARY; m_szStringData.assign((const char*)data, size); }
+
         //getters
         bool toBool() const { ASSERT(m_type == FIELD_BOOL); return static_cast<bool>(m_binaryData.boolean); }
         uint8 toUint8() const { ASSERT(m_type == FIELD_UI8); return m_binaryData.ui8; }
@@ -89,11 +92,12 @@ class SqlStmtFieldData
         float toFloat() const { ASSERT(m_type == FIELD_FLOAT); return m_binaryData.f; }
         double toDouble() const { ASSERT(m_type == FIELD_DOUBLE); return m_binaryData.d; }
         const char * toStr() const { ASSERT(m_type == FIELD_STRING); return m_szStringData.c_str(); }
+        const std::string& toBinary() const { ASSERT(m_type == FIELD_BINARY); return m_szStringData; }
 
         //get type of data
         SqlStmtFieldType type() const { return m_type; }
         //get underlying buffer type
-        void * buff() const { return m_type == FIELD_STRING ? (void * )m_szStringData.c_str() : (void *)&m_binaryData; }
+        void * buff() const { return (m_type == FIELD_STRING || m_type == FIELD_BINARY) ? (void * )m_szStringData.data() : (void *)&m_binaryData; }
 
         //get size of data
         size_t size() const
@@ -112,7 +116,8 @@ class SqlStmtFieldData
                 case FIELD_I64:     return sizeof(int64);
                 case FIELD_FLOAT:   return sizeof(float);
                 case FIELD_DOUBLE:  return sizeof(double);
-                case FIELD_STRING:  return m_szStringData.length();
+                case FIELD_STRING:
+                case FIELD_BINARY:  return m_szStringData.length();
 
                 default:
                     throw std::runtime_error("unrecognized type of SqlStmtFieldType obtained");
@@ -259,6 +264,8 @@ class SqlStatement
         void addString(const char * var) { arg(var); }
         void addString(const std::string& var) { arg(var.c_str()); }
         void addString(std::ostringstream& ss) { arg(ss.str().c_str()); ss.str(std::string()); }
+        void addBinary(const void* data, size_t size) { SqlStmtFieldData param; param.setBinary(data, size); get()->addParam(param); }
+        void addBinary(const std::string& data) { addBinary(data.data(), data.size()); }
 
     protected:
         //don't allow anyone except Database class to create static SqlStatement objects
@@ -141,6 +141,7 @@ class Log
         bool IsIncludeTime() const { return m_includeTime; }
 
         bool IsLogEnabled(LogNames log) const { return logFile[log] != NULL; }
+        std::string const& GetLogsDir() const { return m_logsDir; }
 
     private:
         FILE* openLogFile(LogNames log);
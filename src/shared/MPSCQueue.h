@@ -0,0 +1,99 @@
+/*
+* Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+
+namespace ACE_Based
+{
+    /**
+     * Unbounded lock-free multi producer / single consumer queue.
+     *
+     * Any thread may add(), but only one thread at a time may call next()
+     * or empty(). Producers never block each other for longer than one
+     * atomic exchange, the consumer never blocks at all.
+     */
+    template <class T>
+        class MPSCQueue
+    {
+        struct Node
+        {
+            Node() : _data(), _next(nullptr) {}
+            explicit Node(const T& data) : _data(data), _next(nullptr) {}
+
+            T _data;
+            std::atomic<Node*> _next;
+        };
+
+        //! Last added node, shared by all producers
+        std::atomic<Node*> _head;
+
+        //! Stub node preceding the next result, owned by the consumer
+        Node* _tail;
+
+        MPSCQueue(const MPSCQueue&);
+        MPSCQueue& operator=(const MPSCQueue&);
+
+        public:
+
+            //! Create a MPSCQueue
+            MPSCQueue() : _head(new Node()), _tail(_head.load(std::memory_order_relaxed))
+            {
+            }
+
+            //! Destroy a MPSCQueue, remaining items are dropped
+            ~MPSCQueue()
+            {
+                T result;
+                while (next(result));
+
+                delete _tail;
+            }
+
+            //! Adds an item to the queue, safe to call from any thread.
+            void add(const T& item)
+            {
+                Node* node = new Node(item);
+                Node* prev = _head.exchange(node, std::memory_order_acq_rel);
+                prev->_next.store(node, std::memory_order_release);
+            }
+
+            //! Gets the next result in the queue, if any. Consumer thread only.
+            bool next(T& result)
+            {
+                Node* next = _tail->_next.load(std::memory_order_acquire);
+                if (!next)
+                    return false;
+
+                result = next->_data;
+
+                delete _tail;
+                _tail = next;
+                return true;
+            }
+
+            //! Checks if we're empty or not. Consumer thread only.
+            bool empty() const
+            {
+                return _tail->_next.load(std::memory_order_acquire) == nullptr;
+            }
+    };
+}
+#endif
@@ -0,0 +1,249 @@
+/*
+* Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef MPSCRING_H
+#define MPSCRING_H
+
+#include <ace/Guard_T.h>
+#include <ace/Thread_Mutex.h>
+
+#include <atomic>
+#include <deque>
+#include <stddef.h>
+
+namespace ACE_Based
+{
+    /**
+     * Lock-free multi producer / single consumer ring with a locked spill queue.
+     *
+     * Every cell carries a sequence number telling whose turn it is: producers
+     * claim a position with one CAS and publish the cell by bumping its
+     * sequence, the consumer frees it the same way. The ring is sized for the
+     * usual load; when it is full add() spills into a mutex protected deque and
+     * keeps spilling until the consumer has drained it, so items of one producer
+     * stay in order. add() fails instead of blocking when ring and spill queue
+     * together hold limit items.
+     *
+     * Any thread may add(), but only one thread at a time may call next(),
+     * empty() or size().
+     */
+    template <class T>
+        class MPSCRing
+    {
+        struct Cell
+        {
+            std::atomic<size_t> _sequence;
+            T _data;
+        };
+
+        // producers and consumer write different ends, keep them on own cache lines
+        static const size_t CacheLine = 64;
+
+        Cell* _cells;
+        size_t _mask;
+        char _pad0[CacheLine];
+
+        //! Next position to be claimed by producers
+        std::atomic<size_t> _head;
+        char _pad1[CacheLine];
+
+        //! Next position to be read, owned by the consumer
+        size_t _tail;
+
+        //! Items that didn't fit in the ring, consumed after it is empty
+        size_t _limit;
+        std::atomic<bool> _spilled;                         // set while _spill holds items
+        ACE_Thread_Mutex _spillLock;
+        std::deque<T> _spill;                               // guarded by _spillLock
+
+        MPSCRing(const MPSCRing&);
+        MPSCRing& operator=(const MPSCRing&);
+
+        Cell* front() const
+        {
+            Cell* cell = &_cells[_tail & _mask];
+            if (cell->_sequence.load(std::memory_order_acquire) != _tail + 1)
+                return nullptr;
+
+            return cell;
+        }
+
+        void pop(Cell* cell)
+        {
+            cell->_sequence.store(_tail + _mask + 1, std::memory_order_release);
+            ++_tail;
+        }
+
+        bool addRing(const T& item)
+        {
+            size_t pos = _head.load(std::memory_order_relaxed);
+            Cell* cell;
+            for (;;)
+            {
+                cell = &_cells[pos & _mask];
+                size_t sequence = cell->_sequence.load(std::memory_order_acquire);
+                ptrdiff_t diff = ptrdiff_t(sequence) - ptrdiff_t(pos);
+
+                if (diff == 0)
+                {
+                    // cell is free, try to claim it, pos is reloaded on failure
+                    if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;                           // consumer did not free it yet
+                else
+                    pos = _head.load(std::memory_order_relaxed);
+            }
+
+            cell->_data = item;
+            cell->_sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool addSpill(const T& item)
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, _spillLock, false);
+
+            // consumer drained the spill queue meanwhile, ring is in order again
+            if (!_spilled.load(std::memory_order_relaxed) && addRing(item))
+                return true;
+
+            if (_mask + 1 + _spill.size() >= _limit)
+                return false;
+
+            _spill.push_back(item);
+            _spilled.store(true, std::memory_order_release);
+            return true;
+        }
+
+        // ring is empty here, the spill queue is next
+        template<class Checker>
+        bool nextSpill(T& result, Checker* check)
+        {
+            if (!_spilled.load(std::memory_order_acquire))
+                return false;
+
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, _spillLock, false);
+            if (_spill.empty())
+                return false;
+
+            if (check && !check->Process(_spill.front()))
+                return false;
+
+            result = _spill.front();
+            _spill.pop_front();
+
+            if (_spill.empty())
+                _spilled.store(false, std::memory_order_release);
+
+            return true;
+        }
+
+        struct NoCheck
+        {
+            bool Process(const T&) { return true; }
+        };
+
+        public:
+
+            //! Create a MPSCRing with ring of at least capacity items, rounded up to power of two,
+            //! holding at most limit items together with the spill queue
+            MPSCRing(size_t capacity, size_t limit) : _head(0), _tail(0), _limit(limit), _spilled(false)
+            {
+                size_t size = 2;
+                while (size < capacity)
+                    size <<= 1;
+
+                _cells = new Cell[size];
+                _mask = size - 1;
+
+                for (size_t i = 0; i < size; ++i)
+                    _cells[i]._sequence.store(i, std::memory_order_relaxed);
+            }
+
+            //! Destroy a MPSCRing, remaining items in ring and spill queue are dropped
+            ~MPSCRing()
+            {
+                delete [] _cells;
+            }
+
+            //! Adds an item, safe to call from any thread. False when limit is reached.
+            bool add(const T& item)
+            {
+                if (!_spilled.load(std::memory_order_acquire) && addRing(item))
+                    return true;
+
+                return addSpill(item);
+            }
+
+            //! Gets the next result in the ring, if any. Consumer thread only.
+            bool next(T& result)
+            {
+                Cell* cell = front();
+                if (!cell)
+                    return nextSpill(result, (NoCheck*)nullptr);
+
+                result = cell->_data;
+                pop(cell);
+                return true;
+            }
+
+            //! Gets the next result only if check.Process() accepts it, otherwise it stays in. Consumer thread only.
+            template<class Checker>
+            bool next(T& result, Checker& check)
+            {
+                Cell* cell = front();
+                if (!cell)
+                    return nextSpill(result, &check);
+
+                if (!check.Process(cell->_data))
+                    return false;
+
+                result = cell->_data;
+                pop(cell);
+                return true;
+            }
+
+            //! Moves up to count results into results, returns how many. Consumer thread only.
+            size_t next(T* results, size_t count)
+            {
+                size_t taken = 0;
+                while (taken < count && next(results[taken]))
+                    ++taken;
+
+                return taken;
+            }
+
+            //! Checks if we're empty or not. Consumer thread only.
+            bool empty() const
+            {
+                return front() == nullptr && !_spilled.load(std::memory_order_acquire);
+            }
+
+            //! Items in the ring not taken yet, producers may be adding more meanwhile
+            size_t size() const
+            {
+                return _head.load(std::memory_order_relaxed) - _tail;
+            }
+
+            size_t capacity() const { return _mask + 1; }
+            size_t limit() const { return _limit; }
+    };
+}
+#endif
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "Profiler.h"
+#include "Log.h"
+
+#include <ace/Guard_T.h>
+#include <ace/TSS_T.h>
+
+struct ProfilerThreadSlot
+{
+    ProfilerThreadSlot() : buffer(NULL) {}
+
+    // owned by Profiler, outlives the thread so its zones can still be written
+    Profiler::ThreadBuffer* buffer;
+};
+
+typedef ACE_TSS<ProfilerThreadSlot> ProfilerThreadSlotTSS;
+
+static ProfilerThreadSlotTSS profilerSlot;
+
+std::atomic<bool> Profiler::m_running(false);
+
+Profiler::~Profiler()
+{
+    for (std::vector<ThreadBuffer*>::iterator itr = m_buffers.begin(); itr != m_buffers.end(); ++itr)
+        delete *itr;
+}
+
+bool Profiler::Start(uint32 seconds)
+{
+    uint32 expected = 0;
+    return seconds && m_requested.compare_exchange_strong(expected, seconds);
+}
+
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer()
+{
+    if (!profilerSlot->buffer)
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, NULL);
+        profilerSlot->buffer = new ThreadBuffer(m_buffers.size() + 1);
+        m_buffers.push_back(profilerSlot->buffer);
+    }
+
+    return profilerSlot->buffer;
+}
+
+void Profiler::Write(ThreadBuffer* buffer, const char* name, uint64 start, uint32 duration, uint32 count)
+{
+    uint64 written = buffer->written.load(std::memory_order_relaxed);
+
+    Event& event = buffer->events[written % PROFILER_EVENTS_PER_THREAD];
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    event.count = count;
+
+    buffer->written.store(written + 1, std::memory_order_release);
+}
+
+void Profiler::FlushSums(ThreadBuffer* buffer, uint64 start)
+{
+    for (uint32 i = 0; i < buffer->sumCount; ++i)
+    {
+        Sum const& sum = buffer->sums[i];
+        Write(buffer, sum.name, start, uint32(sum.duration), sum.count);
+    }
+
+    buffer->sumCount = 0;
+}
+
+void Profiler::Record(const char* name, uint64 start, uint32 duration)
+{
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (!buffer)
+        return;
+
+    // this zone encloses all summed ones, they are shown inside it
+    if (buffer->sumCount && start <= buffer->sumsStart)
+        FlushSums(buffer, start);
+
+    Write(buffer, name, start, duration, 0);
+}
+
+void Profiler::RecordSum(const char* name, uint64 start, uint32 duration)
+{
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (!buffer)
+        return;
+
+    if (!buffer->sumCount)
+        buffer->sumsStart = start;
+
+    for (uint32 i = 0; i < buffer->sumCount; ++i)
+    {
+        Sum& sum = buffer->sums[i];
+        if (sum.name == name)
+        {
+            sum.duration += duration;
+            ++sum.count;
+            return;
+        }
+    }
+
+    // too many names, write it as a single zone
+    if (buffer->sumCount == PROFILER_SUMS_PER_THREAD)
+    {
+        Write(buffer, name, start, duration, 0);
+        return;
+    }
+
+    Sum& sum = buffer->sums[buffer->sumCount++];
+    sum.name = name;
+    sum.duration = duration;
+    sum.count = 1;
+}
+
+void Profiler::Update()
+{
+    uint64 now = WorldTimer::getUSTime();
+
+    if (IsRunning())
+    {
+        if (now < m_endTime)
+            return;
+
+        m_running.store(false, std::memory_order_relaxed);
+        WriteTrace();
+        m_requested.store(0);
+        return;
+    }
+
+    uint32 seconds = m_requested.load();
+    if (!seconds)
+        return;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        for (std::vector<ThreadBuffer*>::iterator itr = m_buffers.begin(); itr != m_buffers.end(); ++itr)
+        {
+            (*itr)->written.store(0, std::memory_order_relaxed);
+            (*itr)->sumCount = 0;
+        }
+    }
+
+    m_startTime = now;
+    m_endTime = now + uint64(seconds) * 1000000;
+    m_running.store(true, std::memory_order_relaxed);
+
+    sLog.outString("Profiler: capturing %u seconds.", seconds);
+}
+
+void Profiler::WriteTrace()
+{
+    std::string fileName = sLog.GetLogsDir() + "profile_" + Log::GetTimestampStr() + ".json";
+
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: Profiler: can't open %s for writing.", fileName.c_str());
+        return;
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    uint64 count = 0;
+    uint64 dropped = 0;
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"mangosd\"}}", file);
+
+    for (std::vector<ThreadBuffer*>::const_iterator itr = m_buffers.begin(); itr != m_buffers.end(); ++itr)
+    {
+        ThreadBuffer const* buffer = *itr;
+        uint64 written = buffer->written.load(std::memory_order_acquire);
+        if (!written)
+            continue;
+
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}", buffer->id, buffer->id);
+
+        uint64 first = written > PROFILER_EVENTS_PER_THREAD ? written - PROFILER_EVENTS_PER_THREAD : 0;
+        if (first)
+        {
+            // ring wrapped, zones from capture start until the oldest kept one are gone
+            uint64 keptFrom = buffer->events[first % PROFILER_EVENTS_PER_THREAD].start;
+            uint64 lost = keptFrom > m_startTime ? keptFrom - m_startTime : 0;
+            fprintf(file, ",\n{\"name\":\"Profiler: " UI64FMTD " zones dropped\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":" UI64FMTD ",\"args\":{\"dropped\":" UI64FMTD ",\"lostUs\":" UI64FMTD "}}",
+                first, buffer->id, m_startTime, first, lost);
+            sLog.outLog(LOG_DEFAULT, "ERROR: Profiler: thread %u dropped " UI64FMTD " zones, its trace misses first " UI64FMTD " ms of the capture.",
+                buffer->id, first, lost / 1000);
+            dropped += first;
+        }
+
+        for (uint64 i = first; i < written; ++i)
+        {
+            Event const& event = buffer->events[i % PROFILER_EVENTS_PER_THREAD];
+            if (event.count)
+                fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":" UI64FMTD ",\"dur\":%u,\"args\":{\"count\":%u}}",
+                    event.name, buffer->id, event.start, event.duration, event.count);
+            else
+                fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":" UI64FMTD ",\"dur\":%u}",
+                    event.name, buffer->id, event.start, event.duration);
+        }
+
+        count += written - first;
+    }
+
+    fprintf(file, "\n],\"otherData\":{\"droppedZones\":\"" UI64FMTD "\"}}\n", dropped);
+    fclose(file);
+
+    m_lastTraceFile = fileName;
+    sLog.outString("Profiler: " UI64FMTD " zones written to %s", count, fileName.c_str());
+}
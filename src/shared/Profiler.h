@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2017 Hellfire <https://hellfire-core.github.io/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+#include "Common.h"
+#include "Timer.h"
+
+#include <ace/Singleton.h>
+#include <ace/Thread_Mutex.h>
+#include <atomic>
+#include <vector>
+
+// events kept per thread, older ones are overwritten when the ring wraps
+#define PROFILER_EVENTS_PER_THREAD  (1 << 18)
+// distinct ProfileSumZone names summed per thread before the enclosing zone ends
+#define PROFILER_SUMS_PER_THREAD    16
+
+/**
+ * Scoped zone profiler.
+ *
+ * Zones are recorded into per-thread ring buffers only while a capture is
+ * running, otherwise a zone costs a single relaxed atomic load. A capture is
+ * requested with Start() from any thread and begins/ends on the next
+ * Update() call from the world thread, which also writes the collected zones
+ * as Chrome trace / Perfetto JSON into the logs directory.
+ *
+ * Zones run once per object and tick (unit, creature AI, spell) use
+ * ProfileSumZone: they are summed per name and thread and written as one
+ * event per name when the enclosing ProfileZone ends, with the number of
+ * summed zones in args, so a busy map thread doesn't wrap its ring within a
+ * fraction of a second. If a ring wraps anyway, the trace says how many zones
+ * of that thread were dropped and how much of the capture they covered.
+ */
+class Profiler
+{
+    friend class ACE_Singleton<Profiler, ACE_Thread_Mutex>;
+
+    public:
+        struct Event
+        {
+            const char* name;
+            uint64 start;
+            uint32 duration;
+            uint32 count;                                   // summed zones, 0 for single zone
+        };
+
+        struct Sum
+        {
+            const char* name;
+            uint64 duration;
+            uint32 count;
+        };
+
+        struct ThreadBuffer
+        {
+            ThreadBuffer(uint32 id) : id(id), written(0), events(PROFILER_EVENTS_PER_THREAD), sumCount(0), sumsStart(0) {}
+
+            uint32 id;
+            std::atomic<uint64> written;
+            std::vector<Event> events;
+
+            // owner thread only
+            Sum sums[PROFILER_SUMS_PER_THREAD];
+            uint32 sumCount;
+            uint64 sumsStart;                               // start of first zone in sums
+        };
+
+        static bool IsRunning() { return m_running.load(std::memory_order_relaxed); }
+
+        // request capture of next seconds, returns false if one is already pending or running
+        bool Start(uint32 seconds);
+
+        // world thread only, between map updates
+        void Update();
+
+        void Record(const char* name, uint64 start, uint32 duration);
+        void RecordSum(const char* name, uint64 start, uint32 duration);
+
+        std::string const& GetLastTraceFile() const { return m_lastTraceFile; }
+
+    private:
+        Profiler() : m_requested(0), m_startTime(0), m_endTime(0) {}
+        ~Profiler();
+
+        ThreadBuffer* GetThreadBuffer();
+        static void Write(ThreadBuffer* buffer, const char* name, uint64 start, uint32 duration, uint32 count);
+        // writes sums as events starting with the enclosing zone, nested ones
+        // (Unit::Update > Unit::_UpdateSpells > Spell::update) stack by duration
+        static void FlushSums(ThreadBuffer* buffer, uint64 start);
+        void WriteTrace();
+
+        static std::atomic<bool> m_running;
+
+        ACE_Thread_Mutex m_lock;
+        std::vector<ThreadBuffer*> m_buffers;
+
+        std::atomic<uint32> m_requested;
+        uint64 m_startTime;
+        uint64 m_endTime;
+        std::string m_lastTraceFile;
+};
+
+#define sProfiler (*ACE_Singleton<Profiler, ACE_Thread_Mutex>::instance())
+
+class ProfileZone
+{
+    public:
+        explicit ProfileZone(const char* name) : m_name(name), m_start(Profiler::IsRunning() ? WorldTimer::getUSTime() : 0) {}
+        ~ProfileZone() { End(); }
+
+        // close current zone and open next one in the same scope
+        void Next(const char* name)
+        {
+            End();
+            m_name = name;
+            m_start = Profiler::IsRunning() ? WorldTimer::getUSTime() : 0;
+        }
+
+    private:
+        void End()
+        {
+            if (m_start)
+                sProfiler.Record(m_name, m_start, uint32(WorldTimer::getUSTime() - m_start));
+        }
+
+        ProfileZone(const ProfileZone&);
+        ProfileZone& operator=(const ProfileZone&);
+
+        const char* m_name;
+        uint64 m_start;
+};
+
+// zone run for many objects per tick, see Profiler
+class ProfileSumZone
+{
+    public:
+        explicit ProfileSumZone(const char* name) : m_name(name), m_start(Profiler::IsRunning() ? WorldTimer::getUSTime() : 0) {}
+        ~ProfileSumZone()
+        {
+            if (m_start)
+                sProfiler.RecordSum(m_name, m_start, uint32(WorldTimer::getUSTime() - m_start));
+        }
+
+    private:
+        ProfileSumZone(const ProfileSumZone&);
+        ProfileSumZone& operator=(const ProfileSumZone&);
+
+        const char* m_name;
+        uint64 m_start;
+};
+
+#endif
@@ -31,6 +31,9 @@ class WorldTimer
         // Get current server time
         static uint32 getMSTime();
 
+        // Get current server time in microseconds, used for profiling
+        static uint64 getUSTime();
+
         // Get time difference between two timestamps
         static inline uint32 getMSTimeDiff(const uint32& oldMSTime, const uint32& newMSTime)
         {
@@ -95,6 +95,12 @@ uint32 WorldTimer::getMSTime()
     return getMSTime_internal();
 }
 
+uint64 WorldTimer::getUSTime()
+{
+    const ACE_Time_Value diff = ACE_OS::gettimeofday() - g_SystemTickTime;
+    return uint64(diff.sec()) * 1000000 + uint64(diff.usec());
+}
+
 uint32 WorldTimer::getMSTime_internal()
 {
     // Get current time
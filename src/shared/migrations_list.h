@@ -0,0 +1,26 @@
+#ifndef MIGRATIONS_LIST_H
+#define MIGRATIONS_LIST_H
+
+#include <cstddef>
+
+static const char *MIGRATIONS_CHARACTERS[] =
+{
+	NULL
+};
+
+static const char *MIGRATIONS_WORLD[] =
+{
+	NULL
+};
+
+static const char *MIGRATIONS_LOGON[] =
+{
+	NULL
+};
+
+static const char *MIGRATIONS_LOGS[] =
+{
+	NULL
+};
+
+#endif
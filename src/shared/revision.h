@@ -0,0 +1,5 @@
+#ifndef __REVISION_DATA_H__
+#define __REVISION_DATA_H__
+ #define REVISION_HASH                      "98f935ac3e00fd34af43"
+ #define REVISION_DATE                      "2026-10-19 07:22:14 +0000"
+#endif // __REVISION_DATA_H__